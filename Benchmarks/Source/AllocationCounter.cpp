@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    AllocationCounter.cpp
+    Created: 17 Oct 2026 9:38:50pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Replace the global operator new and count allocations per thread - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+    /** Allocations of this thread, a plain integer so counting can't allocate or lock. */
+    thread_local int64 threadAllocations = 0;
+
+    /** Allocate and count, the shared part of every replaced operator new. */
+    void *allocate(std::size_t size) noexcept {
+        ++threadAllocations;
+        return std::malloc(size == 0 ? 1 : size);
+    }
+}
+
+int64 AllocationCounter::getCount() {
+    return threadAllocations;
+}
+
+void *operator new(std::size_t size) {
+    if (void *memory = allocate(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    if (void *memory = allocate(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept {
+    std::free(memory);
+}
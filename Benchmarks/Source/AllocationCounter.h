@@ -0,0 +1,33 @@
+/*
+  ==============================================================================
+
+    AllocationCounter.h
+    Created: 17 Oct 2026 9:38:50pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+/**
+ * @class AllocationCounter
+ * @brief Counts the heap allocations made by the calling thread.
+ *
+ * The benchmarks replace the global operator new, and every allocation through it is counted
+ * for the thread that made it. Reading the count before and after a call gives the allocations
+ * the call made, so a render path that should never allocate can be checked on every block.
+ * Over-aligned allocations don't go through the replaced operator and aren't counted.
+ */
+class AllocationCounter {
+public:
+    /**
+     * @brief Get the number of allocations the calling thread has made.
+     * @return The count since the thread started.
+     */
+    static int64 getCount();
+};
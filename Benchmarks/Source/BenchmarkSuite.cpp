@@ -0,0 +1,889 @@
+/*
+  ==============================================================================
+
+    BenchmarkSuite.cpp
+    Created: 17 Oct 2026 9:38:50pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Synthesise a test track and write it in every format - DONE
+ * 2. Time decks at every block size and format, off speed and with key lock - DONE
+ * 3. Time the master mix, seeks, loads and the track analysers - DONE
+ * 4. Count the heap allocations of every iteration - DONE
+ * 5. Store the results as JSON and compare them with an earlier run - DONE
+ * 6. Time the master mix with the callback monitor on - DONE
+ * 7. Time the same decks through juce::MixerAudioSource, for comparison - DONE
+ * 8. Time the library search at every query length - DONE
+ * 9. Stream the WAV as well as mapping it, and time the read-ahead buffer with its thread running - DONE
+ * 10. Time key lock at small blocks across the whole tempo range - DONE
+ * 11. Measure each resampler's passband and aliasing with a stepped sine sweep - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "BenchmarkSuite.h"
+#include "AllocationCounter.h"
+#include "../../Source/BeatDetector.h"
+#include "../../Source/KeyDetector.h"
+#include "../../Source/LoudnessMeter.h"
+#include "../../Source/MasterMixer.h"
+#include "../../Source/ReadAheadAudioSource.h"
+#include "../../Source/TrackSearchIndex.h"
+#include "../../Source/WaveformPyramid.h"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+namespace {
+    /**
+     * Formats the test track is played from. "wav-stream" is the same WAV where decks can't memory-map
+     * it and stream it instead, and "cached" the WAV played from the decoded track cache.
+     */
+    const char *const formats[] = { "wav", "wav-stream", "aiff", "flac", "ogg", "cached" };
+
+    /** Formats a deck plays through the read-ahead buffer. */
+    const char *const streamedFormats[] = { "wav-stream", "flac", "ogg" };
+
+    /** Size of the read-ahead buffer, the deck's default. */
+    constexpr double readAheadSeconds = 4.0;
+
+    /** Blocks rendered before timing, so the queued commands are applied and the caches are warm. */
+    constexpr int warmUpBlocks = 16;
+
+    /** Seeks and loads timed per format. */
+    constexpr int numSeeks = 200;
+    constexpr int numLoads = 20;
+
+    /** Times each analyser runs over the track. */
+    constexpr int numAnalyses = 3;
+
+    /** Block the analysers are fed in, as in TrackAnalyser. */
+    constexpr int analysisBlockSize = 65536;
+
+    /** Titles in the library the search runs over, and different queries timed per length. */
+    constexpr int numSearchTitles = 100000;
+    constexpr int numSearches = 2000;
+
+    /** Tones of the stepped sweep the resamplers are checked with, all below the track's Nyquist. */
+    const double sweepFrequencies[] = { 100.0, 250.0, 500.0, 1000.0, 2000.0, 5000.0, 8000.0, 12000.0, 16000.0, 20000.0 };
+
+    /** Level of the sweep's tones. */
+    constexpr double toneAmplitude = 0.5;
+
+    /** Output samples each tone is measured over, after the warm-up blocks. */
+    constexpr int toneSamples = 32768;
+
+    /** Longest a block benchmark renders, so even the fastest deck doesn't run off the end of the track. */
+    constexpr double maxSeconds = 25.0;
+
+    /**
+     * @class ConstantSource
+     * @brief Fills every block with a constant, so the mixer can be timed on its own.
+     */
+    class ConstantSource : public AudioSource {
+    public:
+        void prepareToPlay(int, double) override {}
+
+        void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override {
+            for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel) {
+                FloatVectorOperations::fill(bufferToFill.buffer->getWritePointer(channel, bufferToFill.startSample),
+                                            0.25f, bufferToFill.numSamples);
+            }
+        }
+
+        void releaseResources() override {}
+    };
+
+    /**
+     * @class SineSource
+     * @brief A steady tone on both channels, to check the resamplers with.
+     */
+    class SineSource : public AudioSource {
+    public:
+        SineSource(double frequency, double sampleRate)
+                : increment(MathConstants<double>::twoPi * frequency / sampleRate) {}
+
+        void prepareToPlay(int, double) override {}
+
+        void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override {
+            for (int i = 0; i < bufferToFill.numSamples; ++i) {
+                const auto sample = (float) (toneAmplitude * std::sin(phase));
+                phase = std::fmod(phase + increment, MathConstants<double>::twoPi);
+                for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel) {
+                    bufferToFill.buffer->setSample(channel, bufferToFill.startSample + i, sample);
+                }
+            }
+        }
+
+        void releaseResources() override {}
+
+    private:
+        double increment; /**< Phase step per sample. */
+        double phase = 0.0; /**< Phase of the next sample. */
+    };
+
+    /**
+     * @brief Fit a sine of a known frequency to a signal by least squares.
+     * @return The power of the fitted sine over the power of everything else, in dB.
+     */
+    double getSignalToNoiseDb(const float *samples, int numSamples, double frequency, double sampleRate) {
+        const double step = MathConstants<double>::twoPi * frequency / sampleRate;
+        double ss = 0.0, cc = 0.0, sc = 0.0, xs = 0.0, xc = 0.0;
+        for (int i = 0; i < numSamples; ++i) {
+            const double s = std::sin(step * i), c = std::cos(step * i);
+            ss += s * s; cc += c * c; sc += s * c;
+            xs += samples[i] * s; xc += samples[i] * c;
+        }
+
+        const double determinant = ss * cc - sc * sc;
+        const double a = (xs * cc - xc * sc) / determinant;
+        const double b = (xc * ss - xs * sc) / determinant;
+
+        double signal = 0.0, noise = 0.0;
+        for (int i = 0; i < numSamples; ++i) {
+            const double fitted = a * std::sin(step * i) + b * std::cos(step * i);
+            signal += fitted * fitted;
+            noise += (samples[i] - fitted) * (samples[i] - fitted);
+        }
+        return 10.0 * std::log10(signal / jmax(noise, 1.0e-30));
+    }
+
+    /** Get the level of a signal relative to the sweep's tones, in dB. */
+    double getLevelDb(const float *samples, int numSamples) {
+        double power = 0.0;
+        for (int i = 0; i < numSamples; ++i) {
+            power += (double) samples[i] * samples[i];
+        }
+        const double toneRms = toneAmplitude / MathConstants<double>::sqrt2;
+        return 20.0 * std::log10(jmax(1.0e-15, std::sqrt(power / numSamples)) / toneRms);
+    }
+
+    /** Format a time in nanoseconds with a unit that suits it. */
+    String formatNanoseconds(double nanoseconds) {
+        if (nanoseconds >= 1.0e6) {
+            return String(nanoseconds * 1.0e-6, 2) + " ms";
+        }
+        if (nanoseconds >= 1.0e3) {
+            return String(nanoseconds * 1.0e-3, 2) + " us";
+        }
+        return String(roundToInt(nanoseconds)) + " ns";
+    }
+}
+
+BenchmarkSuite::BenchmarkSuite(const Options &_options) : options(_options) {
+    options.seconds = jlimit(0.1, maxSeconds, options.seconds);
+    formatManager.registerBasicFormats();
+    trackDirectory = File::getSpecialLocation(File::tempDirectory).getChildFile("otoDecksBenchmarks");
+}
+
+BenchmarkSuite::~BenchmarkSuite() {
+    trackDirectory.deleteRecursively();
+}
+
+bool BenchmarkSuite::prepare() {
+    if (!trackDirectory.createDirectory()) {
+        error = "can't create " + trackDirectory.getFullPathName();
+        return false;
+    }
+
+    const AudioBuffer<float> track = synthesiseTrack();
+
+    WavAudioFormat wavFormat;
+    AiffAudioFormat aiffFormat;
+    FlacAudioFormat flacFormat;
+    OggVorbisAudioFormat oggFormat;
+
+    if (!writeTrack(track, wavFormat, "wav") || !writeTrack(track, aiffFormat, "aiff")
+        || !writeTrack(track, flacFormat, "flac") || !writeTrack(track, oggFormat, "ogg")) {
+        return false;
+    }
+
+    // no format claims this extension, so decks can't map the file and probe the stream instead
+    const File streamFile = trackDirectory.getChildFile("track.stream");
+    if (!tracks["wav"].copyFileTo(streamFile)) {
+        error = "can't write " + streamFile.getFullPathName();
+        return false;
+    }
+    tracks["wav-stream"] = streamFile;
+
+    // the cached deck plays the WAV from the decoded track cache
+    if (cachedTracks.decodeAndInsert(tracks["wav"], formatManager, [] { return false; }) == nullptr) {
+        error = "can't decode the WAV track into the cache";
+        return false;
+    }
+    tracks["cached"] = tracks["wav"];
+
+    // the analysers are timed without the decoding
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(tracks["wav"]));
+    if (reader == nullptr) {
+        error = "can't read the WAV track";
+        return false;
+    }
+    decodedTrack.setSize((int) reader->numChannels, (int) reader->lengthInSamples);
+    reader->read(&decodedTrack, 0, decodedTrack.getNumSamples(), 0, true, true);
+
+    return true;
+}
+
+AudioBuffer<float> BenchmarkSuite::synthesiseTrack() const {
+    // a 124 BPM loop with a kick, a bass line, hats and a chord, so the decoders, the stretcher
+    // and the analysers work on something like music rather than a sine
+    const int numSamples = (int) (trackSeconds * trackSampleRate);
+    const double beatSamples = trackSampleRate * 60.0 / 124.0;
+    const double bassNotes[4] = { 55.0, 55.0, 65.41, 49.0 }; // A, A, C, G, a bar each
+    const double chordNotes[3] = { 220.0, 261.63, 329.63 }; // A minor
+    const double twoPi = MathConstants<double>::twoPi;
+
+    AudioBuffer<float> track(2, numSamples);
+    Random random(42);
+    double bassPhase = 0.0;
+
+    for (int i = 0; i < numSamples; ++i) {
+        const double beats = i / beatSamples;
+        const int beat = (int) beats;
+        const double sinceBeat = (beats - beat) * beatSamples / trackSampleRate;
+        const double sinceEighth = std::fmod(beats * 2.0, 1.0) * beatSamples * 0.5 / trackSampleRate;
+        const bool offBeat = std::fmod(beats * 2.0, 2.0) >= 1.0;
+
+        const double kick = std::exp(-sinceBeat * 25.0)
+                            * std::sin(twoPi * (50.0 * sinceBeat + 2.5 * (1.0 - std::exp(-sinceBeat * 40.0))));
+
+        bassPhase += twoPi * bassNotes[(beat / 4) % 4] / trackSampleRate;
+        const double bass = offBeat ? 0.25 * std::sin(bassPhase) * std::exp(-sinceEighth * 6.0) : 0.0;
+
+        const double hat = offBeat ? 0.08 * (random.nextDouble() * 2.0 - 1.0) * std::exp(-sinceEighth * 60.0) : 0.0;
+
+        double chord = 0.0;
+        for (double note : chordNotes) {
+            chord += 0.05 * std::sin(twoPi * note * i / trackSampleRate);
+        }
+
+        track.setSample(0, i, (float) (0.6 * kick + bass + hat + 1.1 * chord));
+        track.setSample(1, i, (float) (0.6 * kick + bass + hat + 0.9 * chord));
+    }
+
+    return track;
+}
+
+bool BenchmarkSuite::writeTrack(const AudioBuffer<float> &track, AudioFormat &format, const String &name) {
+    const File file = trackDirectory.getChildFile("track." + name);
+    file.deleteFile();
+
+    std::unique_ptr<OutputStream> stream(file.createOutputStream());
+    if (stream == nullptr) {
+        error = "can't write " + file.getFullPathName();
+        return false;
+    }
+
+    // lossy formats are written at their middle quality
+    const int quality = format.getQualityOptions().size() / 2;
+    std::unique_ptr<AudioFormatWriter> writer(format.createWriterFor(stream.get(), trackSampleRate,
+                                                                     (unsigned int) track.getNumChannels(), 16, {}, quality));
+    if (writer == nullptr) {
+        error = "can't write a " + name + " track";
+        return false;
+    }
+    stream.release(); // the writer owns it now
+
+    if (!writer->writeFromAudioSampleBuffer(track, 0, track.getNumSamples())) {
+        error = "can't write " + file.getFullPathName();
+        return false;
+    }
+
+    tracks[name] = file;
+    return true;
+}
+
+void BenchmarkSuite::run() {
+    results.clear();
+    qualityChecks.clear();
+
+    runDeckBenchmarks();
+    runSpeedBenchmarks();
+    runResamplerChecks();
+    runReadAheadBenchmarks();
+    runMixBenchmarks();
+    runSeekBenchmarks();
+    runLoadBenchmarks();
+    runAnalysisBenchmarks();
+    runSearchBenchmarks();
+}
+
+std::unique_ptr<DJAudioPlayer> BenchmarkSuite::makeDeck(const String &format, int blockSize) {
+    auto deck = std::make_unique<DJAudioPlayer>(formatManager, readAheadThread,
+                                                format == "cached" ? cachedTracks : uncachedTracks);
+    deck->setOfflineRendering(true);
+    deck->prepareToPlay(blockSize, sampleRate);
+    deck->loadURL(URL(tracks[format]), true);
+    return deck;
+}
+
+void BenchmarkSuite::runDeck(const String &name, const String &format, int blockSize, double speed,
+                             DeckResampler::Quality quality, bool keyLock) {
+    if (!shouldRun(name)) {
+        return;
+    }
+
+    auto deck = makeDeck(format, blockSize);
+    deck->setResamplerQuality(quality);
+    deck->setSpeed(speed);
+    deck->setKeyLock(keyLock);
+
+    AudioBuffer<float> buffer(2, blockSize);
+    const AudioSourceChannelInfo info(&buffer, 0, blockSize);
+    for (int i = 0; i < warmUpBlocks; ++i) {
+        deck->getNextAudioBlock(info);
+    }
+
+    const int numBlocks = jmax(1, roundToInt(options.seconds * sampleRate / blockSize));
+    measure(name, "block", numBlocks, blockSize / sampleRate, [&] { deck->getNextAudioBlock(info); });
+    deck->releaseResources();
+}
+
+void BenchmarkSuite::runDeckBenchmarks() {
+    for (auto *format : formats) {
+        for (int blockSize : { 64, 128, 256, 512, 1024, 2048 }) {
+            runDeck("deck/" + String(format) + "/" + String(blockSize), format, blockSize, 1.0,
+                    DeckResampler::Quality::sinc, false);
+        }
+    }
+}
+
+void BenchmarkSuite::runSpeedBenchmarks() {
+    const std::pair<const char *, DeckResampler::Quality> qualities[] = {
+            { "linear", DeckResampler::Quality::linear },
+            { "cubic",  DeckResampler::Quality::cubic },
+            { "sinc",   DeckResampler::Quality::sinc } };
+
+    for (const auto &quality : qualities) {
+        for (double speed : { 0.5, 0.94, 1.0, 1.06, 1.5, 2.0 }) {
+            runDeck("speed/" + String(quality.first) + "/" + String(speed, 2), "wav", 512, speed, quality.second, false);
+        }
+    }
+
+    // the stretcher works in whole hops, so small blocks are where its cost is least even
+    for (int blockSize : { 64, 128, 512 }) {
+        for (double speed : { 0.5, 0.8, 0.94, 1.06, 1.2, 1.5, 2.0 }) {
+            runDeck("keylock/" + String(blockSize) + "/" + String(speed, 2), "wav", blockSize, speed,
+                    DeckResampler::Quality::sinc, true);
+        }
+    }
+}
+
+AudioBuffer<float> BenchmarkSuite::renderTone(double frequency, double speed, DeckResampler::Quality quality) const {
+    constexpr int blockSize = 512;
+
+    // the resampler on its own, fed a tone at the track rate and played at a speed as on a deck
+    SineSource tone(frequency, trackSampleRate);
+    DeckResampler resampler(&tone);
+    resampler.prepareToPlay(blockSize, sampleRate);
+    resampler.setQuality(quality);
+    resampler.setRatio(speed * trackSampleRate / sampleRate);
+
+    // the filter's history fills up first, so only the steady state is measured
+    AudioBuffer<float> block(2, blockSize);
+    for (int i = 0; i < warmUpBlocks; ++i) {
+        resampler.getNextAudioBlock(AudioSourceChannelInfo(&block, 0, blockSize));
+    }
+
+    AudioBuffer<float> output(2, toneSamples);
+    for (int start = 0; start < toneSamples; start += blockSize) {
+        resampler.getNextAudioBlock(AudioSourceChannelInfo(&output, start, jmin(blockSize, toneSamples - start)));
+    }
+    resampler.releaseResources();
+    return output;
+}
+
+void BenchmarkSuite::runResamplerChecks() {
+    const std::pair<const char *, DeckResampler::Quality> qualities[] = {
+            { "linear", DeckResampler::Quality::linear },
+            { "cubic",  DeckResampler::Quality::cubic },
+            { "sinc",   DeckResampler::Quality::sinc } };
+
+    // the same qualities and speeds as the speed benchmarks, so each timing has its quality next to it
+    for (const auto &quality : qualities) {
+        for (double speed : { 0.5, 0.94, 1.0, 1.06, 1.5, 2.0 }) {
+            QualityCheck check;
+            check.name = "quality/" + String(quality.first) + "/" + String(speed, 2);
+            if (!shouldRun(check.name)) {
+                continue;
+            }
+
+            for (double frequency : sweepFrequencies) {
+                // a tone plays at frequency * speed, it has to come through cleanly well inside both
+                // bands, and vanish once it is clearly above the output Nyquist instead of folding back
+                const double outputFrequency = frequency * speed;
+                const bool inPassband = frequency <= 0.25 * trackSampleRate && outputFrequency <= 0.25 * sampleRate;
+                const bool aboveNyquist = outputFrequency >= 0.525 * sampleRate;
+                if (!inPassband && !aboveNyquist) {
+                    continue; // in the transition band
+                }
+
+                const AudioBuffer<float> output = renderTone(frequency, speed, quality.second);
+                if (inPassband) {
+                    const double snr = getSignalToNoiseDb(output.getReadPointer(0), toneSamples, outputFrequency, sampleRate);
+                    check.passbandSnrDb = check.numPassbandTones++ == 0 ? snr : jmin(check.passbandSnrDb, snr);
+                } else {
+                    const double level = getLevelDb(output.getReadPointer(0), toneSamples);
+                    check.aliasingDb = check.numAliasTones++ == 0 ? level : jmax(check.aliasingDb, level);
+                }
+            }
+            qualityChecks.push_back(check);
+
+            String line = check.name.paddedRight(' ', 24) + "passband SNR " + String(check.passbandSnrDb, 1) + " dB";
+            if (check.numAliasTones > 0) {
+                line << "   aliasing " << String(check.aliasingDb, 1) << " dB";
+            }
+            std::cout << line << std::endl;
+        }
+    }
+}
+
+void BenchmarkSuite::runReadAheadBenchmarks() {
+    bool threadStarted = false;
+
+    for (auto *format : streamedFormats) {
+        for (int blockSize : { 128, 512, 2048 }) {
+            const String name = "readahead/" + String(format) + "/" + String(blockSize);
+            if (!shouldRun(name)) {
+                continue;
+            }
+
+            if (!threadStarted) {
+                readAheadThread.startThread(Thread::Priority::high); // as in the app
+                threadStarted = true;
+            }
+
+            // opened the way a deck opens a streamed track
+            auto *reader = formatManager.createReaderFor(tracks[format].createInputStream());
+            if (reader == nullptr) {
+                std::cout << name << "   can't read the track" << std::endl;
+                continue;
+            }
+            ReadAheadAudioSource source(new AudioFormatReaderSource(reader, true), readAheadThread, true,
+                                        (int) (readAheadSeconds * trackSampleRate));
+            source.prepareToPlay(blockSize, trackSampleRate);
+            source.waitUntilReady(blockSize * 4, 1000);
+
+            AudioBuffer<float> buffer(2, blockSize);
+            const AudioSourceChannelInfo info(&buffer, 0, blockSize);
+
+            // only the audio thread's side is timed, each block first waits, untimed, for the streaming
+            // thread to have it ready, as it would have had in real time
+            const int numBlocks = jmax(1, roundToInt(options.seconds * trackSampleRate / blockSize));
+            measure(name, "block", numBlocks, blockSize / trackSampleRate, [&] { source.getNextAudioBlock(info); },
+                    [&] { source.waitUntilReady(blockSize, 1000); });
+
+            if (source.getNumUnderruns() > 0) {
+                std::cout << "  " << source.getNumUnderruns() << " underruns" << std::endl;
+            }
+            source.releaseResources();
+        }
+    }
+
+    if (threadStarted) {
+        readAheadThread.stopThread(2000);
+    }
+}
+
+void BenchmarkSuite::runMixBenchmarks() {
+    for (int blockSize : { 128, 512, 2048 }) {
+        AudioBuffer<float> buffer(2, blockSize);
+        const AudioSourceChannelInfo info(&buffer, 0, blockSize);
+        const int numBlocks = jmax(1, roundToInt(options.seconds * sampleRate / blockSize));
+
+        const String decksName = "mix/decks/" + String(blockSize);
+        if (shouldRun(decksName)) {
+            auto left = makeDeck("wav", blockSize);
+            auto right = makeDeck("wav", blockSize);
+
+            MasterMixer mixer;
+            mixer.addDeck(left.get(), MasterMixer::CrossfaderSide::left);
+            mixer.addDeck(right.get(), MasterMixer::CrossfaderSide::right);
+            mixer.prepareToPlay(blockSize, sampleRate);
+
+            for (int i = 0; i < warmUpBlocks; ++i) {
+                mixer.getNextAudioBlock(info);
+            }
+            measure(decksName, "block", numBlocks, blockSize / sampleRate, [&] { mixer.getNextAudioBlock(info); });
+            mixer.releaseResources();
+        }
+
+        // the same with every callback timed, as in the app, for the cost of the monitoring
+        const String monitoredName = "mix/monitored/" + String(blockSize);
+        if (shouldRun(monitoredName)) {
+            auto left = makeDeck("wav", blockSize);
+            auto right = makeDeck("wav", blockSize);
+
+            AudioCallbackMonitor monitor;
+            MasterMixer mixer;
+            mixer.addDeck(left.get(), MasterMixer::CrossfaderSide::left);
+            mixer.addDeck(right.get(), MasterMixer::CrossfaderSide::right);
+            mixer.setMonitor(&monitor);
+            mixer.prepareToPlay(blockSize, sampleRate);
+            monitor.prepare(sampleRate, mixer.getNumDecks());
+
+            auto renderBlock = [&] {
+                monitor.beginCallback();
+                mixer.getNextAudioBlock(info);
+                monitor.endCallback(blockSize);
+            };
+            for (int i = 0; i < warmUpBlocks; ++i) {
+                renderBlock();
+            }
+            measure(monitoredName, "block", numBlocks, blockSize / sampleRate, renderBlock);
+            mixer.releaseResources();
+        }
+
+        // the same decks summed by JUCE's own mixer, which locks every block and has no crossfader
+        const String mixerAudioSourceName = "mix/mixerAudioSource/" + String(blockSize);
+        if (shouldRun(mixerAudioSourceName)) {
+            auto left = makeDeck("wav", blockSize);
+            auto right = makeDeck("wav", blockSize);
+
+            MixerAudioSource mixer;
+            mixer.addInputSource(left.get(), false);
+            mixer.addInputSource(right.get(), false);
+            mixer.prepareToPlay(blockSize, sampleRate);
+
+            for (int i = 0; i < warmUpBlocks; ++i) {
+                mixer.getNextAudioBlock(info);
+            }
+            measure(mixerAudioSourceName, "block", numBlocks, blockSize / sampleRate, [&] { mixer.getNextAudioBlock(info); });
+            mixer.removeAllInputs();
+        }
+
+        const String mixerName = "mix/mixer/" + String(blockSize);
+        if (shouldRun(mixerName)) {
+            ConstantSource left, right;
+
+            MasterMixer mixer;
+            mixer.addDeck(&left, MasterMixer::CrossfaderSide::left);
+            mixer.addDeck(&right, MasterMixer::CrossfaderSide::right);
+            mixer.prepareToPlay(blockSize, sampleRate);
+
+            // the crossfader keeps moving, so the gain ramps are timed too
+            int block = 0;
+            measure(mixerName, "block", numBlocks, blockSize / sampleRate, [&] {
+                mixer.setCrossfader(std::sin((float) block++ * 0.01f));
+                mixer.getNextAudioBlock(info);
+            });
+            mixer.releaseResources();
+        }
+    }
+}
+
+void BenchmarkSuite::runSeekBenchmarks() {
+    constexpr int blockSize = 512;
+
+    for (auto *format : formats) {
+        const String name = "seek/" + String(format);
+        if (!shouldRun(name)) {
+            continue;
+        }
+
+        auto deck = makeDeck(format, blockSize);
+        AudioBuffer<float> buffer(2, blockSize);
+        const AudioSourceChannelInfo info(&buffer, 0, blockSize);
+        for (int i = 0; i < warmUpBlocks; ++i) {
+            deck->getNextAudioBlock(info);
+        }
+
+        // the same positions in every format and every run
+        Random random(7);
+        std::vector<double> positions((size_t) numSeeks);
+        for (auto &position : positions) {
+            position = random.nextDouble() * (trackSeconds - 5.0);
+        }
+
+        size_t next = 0;
+        measure(name, "seek", numSeeks, 0.0, [&] {
+            deck->setPosition(positions[next++]);
+            deck->getNextAudioBlock(info);
+        });
+        deck->releaseResources();
+    }
+}
+
+void BenchmarkSuite::runLoadBenchmarks() {
+    constexpr int blockSize = 512;
+
+    for (auto *format : formats) {
+        const String name = "load/" + String(format);
+        if (!shouldRun(name)) {
+            continue;
+        }
+
+        DJAudioPlayer deck(formatManager, readAheadThread, String(format) == "cached" ? cachedTracks : uncachedTracks);
+        deck.setOfflineRendering(true);
+        deck.prepareToPlay(blockSize, sampleRate);
+
+        AudioBuffer<float> buffer(2, blockSize);
+        const AudioSourceChannelInfo info(&buffer, 0, blockSize);
+        const URL url(tracks[format]);
+
+        // the first block is part of the load, it is where the new track's commands are applied
+        measure(name, "load", numLoads, 0.0, [&] {
+            deck.loadURL(url, true);
+            deck.getNextAudioBlock(info);
+        });
+        deck.releaseResources();
+    }
+}
+
+void BenchmarkSuite::runAnalysisBenchmarks() {
+    const int numSamples = decodedTrack.getNumSamples();
+    const int numChannels = decodedTrack.getNumChannels();
+
+    // feed the decoded track in blocks, as TrackAnalyser does
+    auto feed = [&](const std::function<void(const AudioBuffer<float> &, int)> &process) {
+        for (int start = 0; start < numSamples; start += analysisBlockSize) {
+            const int blockSamples = jmin(analysisBlockSize, numSamples - start);
+            const AudioBuffer<float> block(decodedTrack.getArrayOfWritePointers(), numChannels, start, blockSamples);
+            process(block, blockSamples);
+        }
+    };
+
+    TrackAnalysis analysis;
+
+    if (shouldRun("analysis/beat")) {
+        measure("analysis/beat", "track", numAnalyses, trackSeconds, [&] {
+            BeatDetector beatDetector(trackSampleRate);
+            feed([&](const AudioBuffer<float> &block, int blockSamples) { beatDetector.process(block, blockSamples); });
+            beatDetector.finish(analysis);
+        });
+    }
+
+    if (shouldRun("analysis/key")) {
+        KeyDetector keyDetector;
+        measure("analysis/key", "track", numAnalyses, trackSeconds, [&] {
+            keyDetector.reset(trackSampleRate);
+            feed([&](const AudioBuffer<float> &block, int blockSamples) { keyDetector.process(block, blockSamples); });
+            keyDetector.finish(analysis);
+        });
+    }
+
+    if (shouldRun("analysis/loudness")) {
+        LoudnessMeter loudnessMeter;
+        measure("analysis/loudness", "track", numAnalyses, trackSeconds, [&] {
+            loudnessMeter.reset(trackSampleRate);
+            feed([&](const AudioBuffer<float> &block, int blockSamples) { loudnessMeter.process(block, blockSamples); });
+            loudnessMeter.finish(analysis);
+        });
+    }
+
+    if (shouldRun("analysis/waveform")) {
+        measure("analysis/waveform", "track", numAnalyses, trackSeconds, [&] {
+            WaveformPyramid pyramid;
+            pyramid.build(decodedTrack, trackSampleRate);
+        });
+    }
+}
+
+void BenchmarkSuite::runSearchBenchmarks() {
+    const int queryLengths[] = { 1, 2, 3, 4, 6, 8, 12 };
+
+    bool anyToRun = false;
+    for (int length : queryLengths) {
+        anyToRun = anyToRun || shouldRun("search/" + String(length));
+    }
+    if (!anyToRun) {
+        return;
+    }
+
+    // "Artist - Title (Mix)" from a few words, some accented, like a real library
+    const char *const words[] = { "deep", "night", "house", "Caf\xc3\xa9", "sunrise", "bass", "Se\xc3\xb1or", "dub",
+                                  "city", "lights", "\xc3\x9c" "ber", "soul", "groove", "dance", "fever", "electric",
+                                  "dream", "No\xc3\xabl", "rhythm", "storm", "velvet", "echo", "island", "motion" };
+    const int numWords = (int) (sizeof(words) / sizeof(words[0]));
+    Random random(11);
+    auto word = [&] { return String::fromUTF8(words[random.nextInt(numWords)]); };
+
+    TrackSearchIndex index;
+    std::vector<std::string> titles;
+    titles.reserve((size_t) numSearchTitles);
+    for (int i = 0; i < numSearchTitles; ++i) {
+        const String title = word() + " " + word() + " - " + word() + " " + word() + " (" + word() + " Mix)";
+        titles.push_back(title.toStdString());
+        index.addOrUpdate((TrackId) i, titles.back());
+    }
+
+    for (int length : queryLengths) {
+        const String name = "search/" + String(length);
+        if (!shouldRun(name)) {
+            continue;
+        }
+
+        // a different piece of a title each time, so most searches start afresh instead of narrowing
+        std::vector<std::string> queries;
+        queries.reserve((size_t) numSearches);
+        while ((int) queries.size() < numSearches) {
+            const std::string folded = TrackSearchIndex::fold(titles[(size_t) random.nextInt(numSearchTitles)]);
+            if ((int) folded.size() >= length) {
+                queries.push_back(folded.substr((size_t) random.nextInt((int) folded.size() - length + 1), (size_t) length));
+            }
+        }
+
+        size_t next = 0;
+        size_t numMatches = 0;
+        measure(name, "query", numSearches, 0.0, [&] { numMatches += index.search(queries[next++]).size(); });
+        ignoreUnused(numMatches);
+    }
+}
+
+bool BenchmarkSuite::shouldRun(const String &name) const {
+    return options.filter.isEmpty() || name.contains(options.filter);
+}
+
+void BenchmarkSuite::measure(const String &name, const String &unit, int iterations, double audioSecondsPerIteration,
+                             const std::function<void()> &iteration, const std::function<void()> &beforeIteration) {
+    // sized up front, so the only allocations counted are the iteration's own
+    timings.assign((size_t) iterations, 0.0);
+    int64 allocations = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        if (beforeIteration) {
+            beforeIteration();
+        }
+
+        const int64 allocationsBefore = AllocationCounter::getCount();
+        const int64 startTicks = Time::getHighResolutionTicks();
+        iteration();
+        const int64 endTicks = Time::getHighResolutionTicks();
+
+        allocations += AllocationCounter::getCount() - allocationsBefore;
+        timings[(size_t) i] = Time::highResolutionTicksToSeconds(endTicks - startTicks) * 1.0e9;
+    }
+
+    Result result;
+    result.name = name;
+    result.unit = unit;
+    result.iterations = iterations;
+
+    const double totalNs = std::accumulate(timings.begin(), timings.end(), 0.0);
+    std::sort(timings.begin(), timings.end());
+    result.medianNs = timings[timings.size() / 2];
+    result.meanNs = totalNs / iterations;
+    result.p99Ns = timings[jmin(timings.size() - 1, (size_t) (timings.size() * 0.99))];
+    result.realtimeFactor = audioSecondsPerIteration > 0.0 && totalNs > 0.0
+                            ? audioSecondsPerIteration * iterations / (totalNs * 1.0e-9) : 0.0;
+    result.allocationsPerIteration = (double) allocations / iterations;
+    results.push_back(result);
+
+    String line = name.paddedRight(' ', 24) + formatNanoseconds(result.medianNs).paddedLeft(' ', 10) + "/" + unit
+                  + "   p99 " + formatNanoseconds(result.p99Ns).paddedLeft(' ', 10);
+    if (result.realtimeFactor > 0.0) {
+        line << "   " << String(result.realtimeFactor, 1) << "x realtime";
+    }
+    line << "   " << String(result.allocationsPerIteration, 2) << " allocs/" << unit;
+    std::cout << line << std::endl;
+}
+
+const std::vector<BenchmarkSuite::Result> &BenchmarkSuite::getResults() const {
+    return results;
+}
+
+String BenchmarkSuite::toJson() const {
+    DynamicObject::Ptr machine = new DynamicObject();
+    machine->setProperty("cpu", SystemStats::getCpuModel());
+    machine->setProperty("cores", SystemStats::getNumCpus());
+    machine->setProperty("os", SystemStats::getOperatingSystemName());
+   #if JUCE_DEBUG
+    machine->setProperty("build", "debug");
+   #else
+    machine->setProperty("build", "release");
+   #endif
+
+    Array<var> resultList;
+    for (const auto &result : results) {
+        DynamicObject::Ptr entry = new DynamicObject();
+        entry->setProperty("name", result.name);
+        entry->setProperty("unit", result.unit);
+        entry->setProperty("iterations", result.iterations);
+        entry->setProperty("medianNs", result.medianNs);
+        entry->setProperty("meanNs", result.meanNs);
+        entry->setProperty("p99Ns", result.p99Ns);
+        entry->setProperty("realtimeFactor", result.realtimeFactor);
+        entry->setProperty("allocationsPerIteration", result.allocationsPerIteration);
+        resultList.add(var(entry.get()));
+    }
+
+    DynamicObject::Ptr root = new DynamicObject();
+    root->setProperty("suite", ProjectInfo::projectName);
+    root->setProperty("version", ProjectInfo::versionString);
+    root->setProperty("date", Time::getCurrentTime().toISO8601(true));
+    root->setProperty("machine", var(machine.get()));
+    root->setProperty("sampleRate", sampleRate);
+    root->setProperty("seconds", options.seconds);
+    root->setProperty("results", resultList);
+
+    Array<var> qualityList;
+    for (const auto &check : qualityChecks) {
+        DynamicObject::Ptr entry = new DynamicObject();
+        entry->setProperty("name", check.name);
+        entry->setProperty("passbandTones", check.numPassbandTones);
+        entry->setProperty("passbandSnrDb", check.passbandSnrDb);
+        entry->setProperty("aliasTones", check.numAliasTones);
+        entry->setProperty("aliasingDb", check.aliasingDb);
+        qualityList.add(var(entry.get()));
+    }
+    root->setProperty("quality", qualityList);
+
+    return JSON::toString(var(root.get()));
+}
+
+int BenchmarkSuite::compareWith(const File &baselineFile, double tolerance) const {
+    const var baseline = JSON::parse(baselineFile);
+    const auto *baselineResults = baseline.getProperty("results", var()).getArray();
+    if (baselineResults == nullptr) {
+        return -1;
+    }
+
+    // timings only compare on the same hardware
+    const String baselineCpu = baseline.getProperty("machine", var()).getProperty("cpu", "").toString();
+    if (baselineCpu != SystemStats::getCpuModel()) {
+        std::cout << "warning: the baseline ran on " << baselineCpu << std::endl;
+    }
+
+    int regressions = 0;
+    for (const auto &result : results) {
+        const var *match = nullptr;
+        for (const auto &entry : *baselineResults) {
+            if (entry.getProperty("name", "").toString() == result.name) {
+                match = &entry;
+                break;
+            }
+        }
+
+        String line = result.name.paddedRight(' ', 24);
+        if (match == nullptr) {
+            std::cout << line << "new" << std::endl;
+            continue;
+        }
+
+        const double baselineNs = (double) match->getProperty("medianNs", 0.0);
+        const double baselineAllocations = (double) match->getProperty("allocationsPerIteration", 0.0);
+        const double change = baselineNs > 0.0 ? result.medianNs / baselineNs - 1.0 : 0.0;
+        const bool startedAllocating = result.allocationsPerIteration > 0.0 && baselineAllocations == 0.0;
+        const bool regressed = change > tolerance || startedAllocating;
+
+        line << formatNanoseconds(baselineNs).paddedLeft(' ', 10) << " -> " << formatNanoseconds(result.medianNs).paddedLeft(' ', 10)
+             << "   " << (change >= 0.0 ? "+" : "") << String(change * 100.0, 1) << "%";
+        if (startedAllocating) {
+            line << "   now allocates";
+        }
+        if (regressed) {
+            line << "   REGRESSION";
+            ++regressions;
+        }
+        std::cout << line << std::endl;
+    }
+
+    return regressions;
+}
+
+const String &BenchmarkSuite::getError() const {
+    return error;
+}
@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+    BenchmarkSuite.h
+    Created: 17 Oct 2026 9:38:50pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+#include "../../Source/DJAudioPlayer.h"
+#include "../../Source/DecodedTrackCache.h"
+
+using namespace juce;
+
+/**
+ * @class BenchmarkSuite
+ * @brief Times the audio engine without an audio device.
+ *
+ * A one minute test track is synthesised and written as WAV, AIFF, FLAC and Ogg Vorbis, and the
+ * WAV is also decoded into a DecodedTrackCache. A copy of the WAV named so that no format claims
+ * it, "wav-stream", is streamed where "wav" is always memory-mapped. The suite then times:
+ *
+ * - deck/<format>/<block size>: DJAudioPlayer::getNextAudioBlock of a playing deck.
+ * - readahead/<format>/<block size>: a ReadAheadAudioSource filled by its running thread, as a
+ *   deck plays a streamed track live. Only the audio thread's reads are timed.
+ * - quality/<quality>/<speed>: not a timing, the resampler's worst passband SNR and aliasing for
+ *   a stepped sine sweep, next to the speed cases they belong to. A tone well inside both bands
+ *   (up to a quarter of each rate) is fitted by least squares, the rest of the output is noise.
+ *   A tone played above 105% of the output Nyquist must vanish, what is left of it is aliasing.
+ * - speed/<quality>/<speed> and keylock/<block size>/<speed>: a deck off speed 1, resampled, or
+ *   time-stretched at block sizes 64, 128 and 512 from half to double speed.
+ * - mix/decks/<block size>: the MasterMixer with two playing decks, mix/monitored/<block size>
+ *   the same with the AudioCallbackMonitor on, mix/mixerAudioSource/<block size> the same decks
+ *   through juce::MixerAudioSource, and mix/mixer/<block size> with two constant sources, the
+ *   mixer on its own.
+ * - seek/<format>: a jump to a random position followed by one block.
+ * - load/<format>: loading the track into a deck and rendering its first block.
+ * - analysis/<detector>: each track analyser over the whole track.
+ * - search/<query length>: a library search over 100000 titles, a different query each time.
+ *
+ * Decks render offline as in OfflineRenderer, so streamed tracks are decoded inside the timed
+ * block instead of on the read-ahead thread, and every run is the same. The readahead cases
+ * measure the live path instead. Decks play at 48 kHz
+ * from the 44.1 kHz tracks, so the resampler always runs. Every benchmark reports the median,
+ * mean and 99th percentile time per iteration, the realtime factor where the iteration renders
+ * audio, and the heap allocations per iteration.
+ */
+class BenchmarkSuite {
+public:
+    /**
+     * @struct Options
+     * @brief What to run and for how long.
+     */
+    struct Options {
+        double seconds = 10.0; /**< Audio rendered by each block benchmark. */
+        String filter; /**< Only benchmarks whose name contains this run, all if empty. */
+    };
+
+    /**
+     * @struct Result
+     * @brief The timings of one benchmark.
+     */
+    struct Result {
+        String name; /**< Group and parameters, e.g. "deck/flac/512". */
+        String unit; /**< What one iteration is, e.g. "block" or "load". */
+        int iterations = 0; /**< Iterations timed. */
+        double medianNs = 0.0; /**< Median time per iteration. */
+        double meanNs = 0.0; /**< Mean time per iteration. */
+        double p99Ns = 0.0; /**< 99th percentile time per iteration. */
+        double realtimeFactor = 0.0; /**< Audio rendered per second of work, 0 if the iteration renders no audio. */
+        double allocationsPerIteration = 0.0; /**< Heap allocations per iteration. */
+    };
+
+    /**
+     * @struct QualityCheck
+     * @brief How cleanly a resampler plays the stepped sine sweep at one speed.
+     */
+    struct QualityCheck {
+        String name; /**< Quality and speed, e.g. "quality/sinc/1.50". */
+        int numPassbandTones = 0; /**< Tones checked inside the passband. */
+        double passbandSnrDb = 0.0; /**< Lowest signal to noise ratio of those tones. */
+        int numAliasTones = 0; /**< Tones played above the output Nyquist. */
+        double aliasingDb = 0.0; /**< Highest level left of those tones, relative to the input, 0 if there were none. */
+    };
+
+    /**
+     * @brief Constructor.
+     * @param options What to run and for how long.
+     */
+    BenchmarkSuite(const Options &options);
+
+    /** Destructor, deletes the test tracks. */
+    ~BenchmarkSuite();
+
+    /**
+     * @brief Write the test tracks.
+     * @return True if every track was written, otherwise getError() says why.
+     */
+    bool prepare();
+
+    /** Run every benchmark that matches the filter and print each result as it finishes. */
+    void run();
+
+    /**
+     * @brief Get the results of the last run.
+     * @return The results in the order they ran.
+     */
+    const std::vector<Result> &getResults() const;
+
+    /**
+     * @brief Get the results and the resampler checks with the machine they ran on, for storing and comparing later.
+     * @return The results as JSON.
+     */
+    String toJson() const;
+
+    /**
+     * @brief Compare the results with a stored run and print the changes.
+     *
+     * A benchmark regresses if its median time grew by more than the tolerance, or if it
+     * allocates where it didn't before.
+     *
+     * @param baselineFile Results stored with toJson() by an earlier run.
+     * @param tolerance The relative slowdown allowed, e.g. 0.1 for 10%.
+     * @return The number of regressions, or -1 if the baseline can't be read.
+     */
+    int compareWith(const File &baselineFile, double tolerance) const;
+
+    /**
+     * @brief Get why preparing failed.
+     * @return The error, empty if it didn't.
+     */
+    const String &getError() const;
+
+private:
+    /** Synthesise the test track. */
+    AudioBuffer<float> synthesiseTrack() const;
+
+    /** Write the test track with one format, false with the error set if it fails. */
+    bool writeTrack(const AudioBuffer<float> &track, AudioFormat &format, const String &name);
+
+    /** Make an offline deck that plays a test track. */
+    std::unique_ptr<DJAudioPlayer> makeDeck(const String &format, int blockSize);
+
+    /** Time a deck playing a test track with the given block size, speed and quality. */
+    void runDeck(const String &name, const String &format, int blockSize, double speed,
+                 DeckResampler::Quality quality, bool keyLock);
+
+    void runDeckBenchmarks(); /**< Every format at every block size. */
+    void runSpeedBenchmarks(); /**< Resampling qualities and key lock off speed 1. */
+    void runResamplerChecks(); /**< Passband and aliasing of every quality at the speed benchmarks' speeds. */
+
+    /** Resample a tone at the track rate to the deck rate, after the warm-up blocks. */
+    AudioBuffer<float> renderTone(double frequency, double speed, DeckResampler::Quality quality) const;
+    void runReadAheadBenchmarks(); /**< The read-ahead buffer of streamed formats, with its thread running. */
+    void runMixBenchmarks(); /**< The master mix, with decks and on its own. */
+    void runSeekBenchmarks(); /**< Seeks in every format. */
+    void runLoadBenchmarks(); /**< Loads of every format. */
+    void runAnalysisBenchmarks(); /**< Every track analyser. */
+    void runSearchBenchmarks(); /**< Library searches of every query length. */
+
+    /** Check whether a benchmark matches the filter. */
+    bool shouldRun(const String &name) const;
+
+    /**
+     * @brief Time a benchmark and print its result.
+     * @param name The benchmark's name.
+     * @param unit What one iteration is.
+     * @param iterations The number of iterations to time.
+     * @param audioSecondsPerIteration Audio rendered by each iteration, 0 if none.
+     * @param iteration Runs one iteration.
+     * @param beforeIteration Runs before each iteration without being timed, if set.
+     */
+    void measure(const String &name, const String &unit, int iterations, double audioSecondsPerIteration,
+                 const std::function<void()> &iteration, const std::function<void()> &beforeIteration = nullptr);
+
+    static constexpr double sampleRate = 48000.0; /**< Rate the decks play at. */
+    static constexpr double trackSampleRate = 44100.0; /**< Rate of the test tracks. */
+    static constexpr double trackSeconds = 60.0; /**< Length of the test tracks. */
+
+    Options options; /**< What to run and for how long. */
+    AudioFormatManager formatManager; /**< Formats the tracks are written and decoded with. */
+    TimeSliceThread readAheadThread{ "Benchmark read-ahead" }; /**< Only runs for the readahead cases, offline decks decode on the rendering thread. */
+    DecodedTrackCache uncachedTracks{ 0 }; /**< Cache without room for anything, so tracks are read from their files. */
+    DecodedTrackCache cachedTracks{ (int64) 256 * 1024 * 1024 }; /**< Cache holding the decoded WAV track. */
+    File trackDirectory; /**< Where the test tracks are written. */
+    std::map<String, File> tracks; /**< Test tracks by format name, "cached" for the decoded WAV. */
+    AudioBuffer<float> decodedTrack; /**< The WAV track decoded, for the analysers. */
+
+    std::vector<double> timings; /**< Time of each iteration of the running benchmark, sized before it starts. */
+    std::vector<Result> results; /**< Results of the last run. */
+    std::vector<QualityCheck> qualityChecks; /**< Resampler checks of the last run. */
+    String error; /**< Why preparing failed. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BenchmarkSuite)
+};
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "BenchmarkSuite.h"
+
+namespace {
+    /** Get the value of an option given as --option=value or as --option value. */
+    juce::String getOptionValue(const juce::ArgumentList &arguments, juce::StringRef option) {
+        const juce::String value = arguments.getValueForOption(option);
+        if (value.isNotEmpty()) {
+            return value;
+        }
+
+        const int index = arguments.indexOfOption(option);
+        if (index >= 0 && index + 1 < arguments.size() && !arguments[index + 1].isOption()) {
+            return arguments[index + 1].text;
+        }
+        return {};
+    }
+}
+
+//==============================================================================
+int main(int argc, char *argv[]) {
+    // the decks send change messages, so they need a message manager even without a window
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const juce::ArgumentList arguments(argc, argv);
+    if (arguments.containsOption("--help|-h")) {
+        std::cout << "usage: otoDecksBenchmarks [--seconds 10] [--filter deck/flac] [--json results.json]\n"
+                     "                          [--baseline old.json] [--tolerance 10]" << std::endl;
+        return 0;
+    }
+
+    BenchmarkSuite::Options options;
+    const juce::String seconds = getOptionValue(arguments, "--seconds");
+    if (seconds.isNotEmpty()) {
+        options.seconds = seconds.getDoubleValue();
+    }
+    options.filter = getOptionValue(arguments, "--filter");
+
+    BenchmarkSuite suite(options);
+    if (!suite.prepare()) {
+        std::cerr << "can't prepare the benchmarks: " << suite.getError() << std::endl;
+        return 1;
+    }
+
+    suite.run();
+
+    const juce::File workingDirectory = juce::File::getCurrentWorkingDirectory();
+    const juce::String jsonPath = getOptionValue(arguments, "--json");
+    if (jsonPath.isNotEmpty() && !workingDirectory.getChildFile(jsonPath).replaceWithText(suite.toJson())) {
+        std::cerr << "can't write " << jsonPath << std::endl;
+        return 1;
+    }
+
+    // a slower or newly allocating benchmark fails the run, so CI can catch regressions between releases
+    const juce::String baselinePath = getOptionValue(arguments, "--baseline");
+    if (baselinePath.isNotEmpty()) {
+        const juce::String tolerance = getOptionValue(arguments, "--tolerance");
+        const double tolerancePercent = tolerance.isNotEmpty() ? tolerance.getDoubleValue() : 10.0;
+
+        const int regressions = suite.compareWith(workingDirectory.getChildFile(baselinePath), tolerancePercent * 0.01);
+        if (regressions < 0) {
+            std::cerr << "can't read the baseline " << baselinePath << std::endl;
+            return 1;
+        }
+        if (regressions > 0) {
+            std::cout << regressions << " regressions" << std::endl;
+            return 3;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+    AudioCallbackMonitor.cpp
+    Created: 17 Oct 2026 10:12:20pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Lock-free duration histograms with quarter octave bins - DONE
+ * 2. Time callbacks, the mix and each deck on the audio thread - DONE
+ * 3. Detect overruns and late callbacks against the buffer period - DONE
+ * 4. Queue xruns with their deck times for the message thread - DONE
+ * 5. Smoothed and peak load for a meter - DONE
+ * 6. Reports covering the time since the previous one and the whole session - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "AudioCallbackMonitor.h"
+
+namespace {
+    /** Bins per octave of the histograms. */
+    constexpr double binsPerOctave = 4.0;
+
+    /** How much of the load meter each callback makes up, about a quarter of a second at 512 samples. */
+    constexpr float loadSmoothing = 0.05f;
+
+    /** A callback is late if it starts this many periods after the previous one. */
+    constexpr double lateFactor = 1.5;
+
+    /** Names of the sections in reports. */
+    const char *const sectionNames[] = { "callback", "mix", "interval", "deck 1", "deck 2", "deck 3", "deck 4" };
+}
+
+AudioCallbackMonitor::Histogram::Counts
+AudioCallbackMonitor::Histogram::Counts::operator-(const Counts &earlier) const {
+    Counts difference;
+    for (size_t bin = 0; bin < (size_t) numBins; ++bin) {
+        difference.bins[bin] = bins[bin] - earlier.bins[bin];
+    }
+    difference.total = total - earlier.total;
+    difference.sumMicroseconds = sumMicroseconds - earlier.sumMicroseconds;
+    return difference;
+}
+
+double AudioCallbackMonitor::Histogram::Counts::getPercentile(double fraction) const {
+    if (total == 0) {
+        return 0.0;
+    }
+
+    const auto target = (uint64) std::ceil(fraction * (double) total);
+    uint64 counted = 0;
+    for (int bin = 0; bin < numBins; ++bin) {
+        counted += bins[(size_t) bin];
+        if (counted >= target) {
+            return getBinEdge(bin);
+        }
+    }
+    return getBinEdge(numBins - 1);
+}
+
+double AudioCallbackMonitor::Histogram::Counts::getMean() const {
+    return total > 0 ? sumMicroseconds / (double) total : 0.0;
+}
+
+void AudioCallbackMonitor::Histogram::add(double microseconds) {
+    // bin 0 is everything up to 1 us, then a bin every quarter octave
+    const int bin = microseconds <= 1.0 ? 0 : jmin(numBins - 1, (int) (std::log2(microseconds) * binsPerOctave));
+
+    // only the audio thread writes, relaxed increments are enough for readers that only need the counts
+    bins[(size_t) bin].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sumMicroseconds.store(sumMicroseconds.load(std::memory_order_relaxed) + microseconds, std::memory_order_relaxed);
+}
+
+AudioCallbackMonitor::Histogram::Counts AudioCallbackMonitor::Histogram::read() const {
+    Counts counts;
+    for (size_t bin = 0; bin < (size_t) numBins; ++bin) {
+        counts.bins[bin] = bins[bin].load(std::memory_order_relaxed);
+        counts.total += counts.bins[bin]; // the bins and the total may be a callback apart, the bins rule
+    }
+    counts.sumMicroseconds = sumMicroseconds.load(std::memory_order_relaxed);
+    return counts;
+}
+
+double AudioCallbackMonitor::Histogram::getBinEdge(int bin) {
+    return std::exp2((bin + 1) / binsPerOctave);
+}
+
+AudioCallbackMonitor::AudioCallbackMonitor() : lastReportTime(Time::getCurrentTime()) {}
+
+AudioCallbackMonitor::~AudioCallbackMonitor() {}
+
+void AudioCallbackMonitor::prepare(double _sampleRate, int _numDecks) {
+    sampleRate = _sampleRate;
+    numDecks = jlimit(0, maxDecks, _numDecks);
+    previousStartTicks = 0; // the first callback after a restart isn't late
+}
+
+void AudioCallbackMonitor::beginCallback() {
+    callbackStartTicks = Time::getHighResolutionTicks();
+    deckTicks.fill(0);
+}
+
+void AudioCallbackMonitor::addDeckTime(int deck, int64 ticks) {
+    if (isPositiveAndBelow(deck, maxDecks)) {
+        deckTicks[(size_t) deck] += ticks;
+    }
+}
+
+void AudioCallbackMonitor::endCallback(int numSamples) {
+    const int64 endTicks = Time::getHighResolutionTicks();
+    const double rate = sampleRate.load();
+    if (rate <= 0.0 || numSamples <= 0) {
+        return;
+    }
+
+    const double ticksToMicroseconds = 1.0e6 / (double) Time::getHighResolutionTicksPerSecond();
+    const double periodMicroseconds = numSamples * 1.0e6 / rate;
+    const double callbackMicroseconds = (double) (endTicks - callbackStartTicks) * ticksToMicroseconds;
+
+    Xrun xrun;
+    double decksMicroseconds = 0.0;
+    for (int deck = 0; deck < numDecks.load(); ++deck) {
+        const double deckMicroseconds = (double) deckTicks[(size_t) deck] * ticksToMicroseconds;
+        histograms[(size_t) (firstDeck + deck)].add(deckMicroseconds);
+        xrun.deckMicroseconds[(size_t) deck] = (float) deckMicroseconds;
+        decksMicroseconds += deckMicroseconds;
+    }
+
+    histograms[callback].add(callbackMicroseconds);
+    histograms[mix].add(jmax(0.0, callbackMicroseconds - decksMicroseconds));
+
+    double intervalMicroseconds = 0.0;
+    if (previousStartTicks != 0) {
+        intervalMicroseconds = (double) (callbackStartTicks - previousStartTicks) * ticksToMicroseconds;
+        histograms[interval].add(intervalMicroseconds);
+    }
+    previousStartTicks = callbackStartTicks;
+
+    // the meter
+    const float callbackLoad = (float) (callbackMicroseconds / periodMicroseconds);
+    load = load.load() + loadSmoothing * (callbackLoad - load.load());
+    if (callbackLoad > peakLoad.load()) {
+        peakLoad = callbackLoad;
+    }
+
+    const bool overrun = callbackMicroseconds > periodMicroseconds;
+    const bool late = intervalMicroseconds > lateFactor * periodMicroseconds;
+    if (!overrun && !late) {
+        return;
+    }
+
+    if (overrun) {
+        ++numOverruns;
+    } else {
+        ++numLateCallbacks;
+    }
+
+    // rare, so the clock is only read here
+    xrun.timeMs = Time::currentTimeMillis();
+    xrun.overrun = overrun;
+    xrun.numSamples = numSamples;
+    xrun.periodMicroseconds = (float) periodMicroseconds;
+    xrun.callbackMicroseconds = (float) callbackMicroseconds;
+    xrun.intervalMicroseconds = (float) intervalMicroseconds;
+
+    const auto scope = xrunFifo.write(1);
+    if (scope.blockSize1 > 0) {
+        xrunQueue[(size_t) scope.startIndex1] = xrun;
+    } else {
+        ++numDroppedXruns; // nothing has collected them for a while
+    }
+}
+
+float AudioCallbackMonitor::getLoad() const {
+    return load.load();
+}
+
+float AudioCallbackMonitor::takePeakLoad() {
+    return peakLoad.exchange(0.0f);
+}
+
+int AudioCallbackMonitor::getNumXruns() const {
+    return numOverruns.load() + numLateCallbacks.load();
+}
+
+void AudioCallbackMonitor::collectXruns() {
+    const auto scope = xrunFifo.read(xrunFifo.getNumReady());
+    scope.forEach([this](int index) {
+        xrunHistory.push_back(xrunQueue[(size_t) index]);
+    });
+
+    while ((int) xrunHistory.size() > xrunHistorySize) {
+        xrunHistory.pop_front();
+    }
+}
+
+String AudioCallbackMonitor::createReport() {
+    collectXruns();
+
+    std::array<Histogram::Counts, numSections> counts;
+    std::array<Histogram::Counts, numSections> sinceLastReport;
+    for (size_t section = 0; section < (size_t) numSections; ++section) {
+        counts[section] = histograms[section].read();
+        sinceLastReport[section] = counts[section] - lastReportCounts[section];
+    }
+
+    const Time now = Time::getCurrentTime();
+    String report;
+    report << "=== audio callbacks, " << now.toString(true, true, true, true) << " ===\n";
+    report << "device: " << String(roundToInt(sampleRate.load())) << " Hz, load " << String(getLoad() * 100.0f, 1) << "%, "
+           << numOverruns.load() << " overruns, " << numLateCallbacks.load() << " late callbacks";
+    if (numDroppedXruns.load() > 0) {
+        report << ", " << numDroppedXruns.load() << " xruns not logged";
+    }
+    report << "\n";
+
+    report << "since " << lastReportTime.toString(true, true, true, true) << ":\n" << describe(sinceLastReport);
+    report << "whole session:\n" << describe(counts);
+
+    if (!xrunHistory.empty()) {
+        report << "latest xruns:\n";
+        for (const auto &xrun : xrunHistory) {
+            report << describe(xrun) << "\n";
+        }
+    }
+
+    lastReportCounts = counts;
+    lastReportTime = now;
+    return report;
+}
+
+String AudioCallbackMonitor::describe(const std::array<Histogram::Counts, numSections> &counts) const {
+    String text;
+    const int sectionsInUse = firstDeck + numDecks.load();
+
+    for (int section = 0; section < sectionsInUse; ++section) {
+        const auto &sectionCounts = counts[(size_t) section];
+        text << "  " << String(sectionNames[section]).paddedRight(' ', 10)
+             << String(sectionCounts.total).paddedLeft(' ', 10) << " x"
+             << "   mean " << String(sectionCounts.getMean(), 1).paddedLeft(' ', 8) << " us"
+             << "   p50 <" << String(roundToInt(sectionCounts.getPercentile(0.5))).paddedLeft(' ', 6) << " us"
+             << "   p99 <" << String(roundToInt(sectionCounts.getPercentile(0.99))).paddedLeft(' ', 6) << " us"
+             << "   p99.9 <" << String(roundToInt(sectionCounts.getPercentile(0.999))).paddedLeft(' ', 6) << " us"
+             << "   max <" << String(roundToInt(sectionCounts.getPercentile(1.0))).paddedLeft(' ', 6) << " us\n";
+    }
+    return text;
+}
+
+String AudioCallbackMonitor::describe(const Xrun &xrun) const {
+    String text;
+    text << "  " << Time(xrun.timeMs).toString(true, true, true, true) << "." << String(xrun.timeMs % 1000).paddedLeft('0', 3)
+         << (xrun.overrun ? "  overrun " : "  late    ")
+         << xrun.numSamples << " samples, period " << String(roundToInt(xrun.periodMicroseconds)) << " us, callback "
+         << String(roundToInt(xrun.callbackMicroseconds)) << " us, interval " << String(roundToInt(xrun.intervalMicroseconds)) << " us";
+
+    for (int deck = 0; deck < numDecks.load(); ++deck) {
+        text << ", deck " << (deck + 1) << " " << String(roundToInt(xrun.deckMicroseconds[(size_t) deck])) << " us";
+    }
+    return text;
+}
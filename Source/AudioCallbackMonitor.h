@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+    AudioCallbackMonitor.h
+    Created: 17 Oct 2026 10:12:20pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <deque>
+
+using namespace juce;
+
+/**
+ * @class AudioCallbackMonitor
+ * @brief Times every audio callback, detects xruns and keeps the numbers for a load meter and a log.
+ *
+ * The audio thread marks the start and end of every callback, and the mixer adds the time each
+ * deck took. At the end of the callback the total, the mix without the decks, each deck and the
+ * interval since the previous callback are added to lock-free histograms, a few relaxed atomic
+ * increments, so the monitor can stay on at a gig.
+ *
+ * A callback that takes longer than its buffer period is an overrun; one that starts more than
+ * half a period late is a late callback, the device or the system dropped a buffer around it.
+ * Either way the callback is recorded as an xrun, with the time of each deck, in a small queue
+ * the message thread drains, so there is a trace of what was slow when a dropout happens.
+ *
+ * The message thread reads the load for a meter and writes reports. A report covers the time
+ * since the previous one as well as the whole session, so reports dumped now and then give a
+ * rolling view.
+ */
+class AudioCallbackMonitor {
+public:
+    static constexpr int maxDecks = 4; /**< Decks timed separately. */
+
+    /**
+     * @class Histogram
+     * @brief Counts of durations in bins a quarter octave wide, from 1 us to about 65 ms.
+     *
+     * Only the audio thread adds to a histogram, any thread can read it.
+     */
+    class Histogram {
+    public:
+        static constexpr int numBins = 64; /**< Bins, the last one also counts everything longer. */
+
+        /**
+         * @struct Counts
+         * @brief A copy of the bins, which can be subtracted to get the counts of an interval.
+         */
+        struct Counts {
+            std::array<uint64, numBins> bins{}; /**< Durations in each bin. */
+            uint64 total = 0; /**< Durations counted. */
+            double sumMicroseconds = 0.0; /**< Sum of the durations. */
+
+            /** Get the counts added since an earlier copy. */
+            Counts operator-(const Counts &earlier) const;
+
+            /**
+             * @brief Get the duration below which a fraction of the durations fall.
+             * @param fraction The fraction, e.g. 0.99.
+             * @return The upper edge of the bin, in microseconds, 0 if nothing was counted.
+             */
+            double getPercentile(double fraction) const;
+
+            /** Get the mean duration in microseconds, 0 if nothing was counted. */
+            double getMean() const;
+        };
+
+        /** Count a duration, only on the audio thread. */
+        void add(double microseconds);
+
+        /** Copy the bins. */
+        Counts read() const;
+
+        /** Get the upper edge of a bin in microseconds. */
+        static double getBinEdge(int bin);
+
+    private:
+        std::array<std::atomic<uint64>, numBins> bins{}; /**< Durations in each bin. */
+        std::atomic<uint64> total{ 0 }; /**< Durations counted. */
+        std::atomic<double> sumMicroseconds{ 0.0 }; /**< Sum of the durations. */
+    };
+
+    /**
+     * @struct Xrun
+     * @brief A callback that missed its deadline.
+     */
+    struct Xrun {
+        int64 timeMs = 0; /**< When the callback ended, in milliseconds since 1970. */
+        bool overrun = false; /**< True if the callback took longer than its period, false if it started late. */
+        int numSamples = 0; /**< Samples the callback rendered. */
+        float periodMicroseconds = 0.0f; /**< The buffer period. */
+        float callbackMicroseconds = 0.0f; /**< How long the callback took. */
+        float intervalMicroseconds = 0.0f; /**< Time since the previous callback started. */
+        std::array<float, maxDecks> deckMicroseconds{}; /**< How long each deck took. */
+    };
+
+    /** Constructor. */
+    AudioCallbackMonitor();
+
+    /** Destructor. */
+    ~AudioCallbackMonitor();
+
+    /**
+     * @brief Start monitoring a device, from prepareToPlay().
+     * @param sampleRate The sample rate of the device.
+     * @param numDecks The decks the mixer renders, at most maxDecks.
+     */
+    void prepare(double sampleRate, int numDecks);
+
+    /** Mark the start of a callback, on the audio thread. */
+    void beginCallback();
+
+    /**
+     * @brief Add time a deck took during the current callback, on the audio thread.
+     * @param deck The index of the deck in the mixer.
+     * @param ticks The time in high resolution ticks.
+     */
+    void addDeckTime(int deck, int64 ticks);
+
+    /**
+     * @brief Mark the end of a callback, on the audio thread.
+     * @param numSamples The samples the callback rendered.
+     */
+    void endCallback(int numSamples);
+
+    /**
+     * @brief Get the smoothed load of the audio thread, for a meter.
+     * @return The share of the buffer period spent rendering, 1 is the deadline.
+     */
+    float getLoad() const;
+
+    /**
+     * @brief Get the highest load since the last call, for a meter.
+     * @return The highest share of a buffer period spent rendering.
+     */
+    float takePeakLoad();
+
+    /**
+     * @brief Get the number of xruns since the device started.
+     * @return Overruns and late callbacks.
+     */
+    int getNumXruns() const;
+
+    /** Move new xruns from the audio thread's queue into the history, on the message thread. */
+    void collectXruns();
+
+    /**
+     * @brief Describe the callbacks since the previous report and since the device started.
+     *
+     * On the message thread only.
+     *
+     * @return Several lines of text.
+     */
+    String createReport();
+
+private:
+    /** Sections of a callback with a histogram each. */
+    enum Section {
+        callback, /**< The whole callback. */
+        mix, /**< The callback without the decks. */
+        interval, /**< Time from the start of the previous callback. */
+        firstDeck, /**< The first deck, the others follow. */
+        numSections = firstDeck + maxDecks
+    };
+
+    /** Describe the counts of every section in a few lines. */
+    String describe(const std::array<Histogram::Counts, numSections> &counts) const;
+
+    /** Describe an xrun in one line. */
+    String describe(const Xrun &xrun) const;
+
+    static constexpr int xrunQueueSize = 32; /**< Xruns the audio thread can queue between collections. */
+    static constexpr int xrunHistorySize = 64; /**< Xruns kept for reports. */
+
+    std::array<Histogram, numSections> histograms; /**< Durations of each section. */
+    std::atomic<double> sampleRate{ 0.0 }; /**< Sample rate of the device, 0 before it starts. */
+    std::atomic<int> numDecks{ 0 }; /**< Decks timed. */
+    std::atomic<float> load{ 0.0f }; /**< Smoothed load, written by the audio thread. */
+    std::atomic<float> peakLoad{ 0.0f }; /**< Highest load since the meter last read it. */
+    std::atomic<int> numOverruns{ 0 }; /**< Callbacks longer than their period. */
+    std::atomic<int> numLateCallbacks{ 0 }; /**< Callbacks that started late. */
+    std::atomic<int> numDroppedXruns{ 0 }; /**< Xruns that didn't fit in the queue. */
+
+    int64 callbackStartTicks = 0; /**< When the current callback started, audio thread only. */
+    int64 previousStartTicks = 0; /**< When the previous callback started, 0 after prepare, audio thread only. */
+    std::array<int64, maxDecks> deckTicks{}; /**< Time of each deck in the current callback, audio thread only. */
+
+    AbstractFifo xrunFifo{ xrunQueueSize }; /**< Positions in the xrun queue. */
+    std::array<Xrun, xrunQueueSize> xrunQueue; /**< Xruns on their way to the message thread. */
+
+    std::deque<Xrun> xrunHistory; /**< The latest xruns, message thread only. */
+    std::array<Histogram::Counts, numSections> lastReportCounts; /**< Counts at the previous report, message thread only. */
+    Time lastReportTime; /**< When the previous report was made. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioCallbackMonitor)
+};
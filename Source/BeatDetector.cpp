@@ -0,0 +1,241 @@
+/*
+  ==============================================================================
+
+    BeatDetector.cpp
+    Created: 17 Oct 2026 6:41:12pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Build an onset envelope from the full band and low band energy rises - DONE
+ * 2. Estimate the tempo from the autocorrelation of the envelope - DONE
+ * 3. Refine the tempo on peaks many beats out and find the phase of the grid - DONE
+ * 4. Vectorise the energies and the autocorrelation - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "BeatDetector.h"
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#elif JUCE_ARM && defined(__ARM_NEON)
+ #include <arm_neon.h>
+#endif
+
+namespace {
+    /** Length of a hop of the onset envelope in seconds. */
+    constexpr double hopSeconds = 0.0058;
+
+    /** Cutoff of the low band that picks up the kicks. */
+    constexpr double lowBandHz = 150.0;
+
+    /** Tempo most tracks are near, the prior on the tempo is centred here. */
+    constexpr double typicalBpm = 128.0;
+
+    /** Width of the tempo prior in octaves. */
+    constexpr double priorWidthOctaves = 0.6;
+
+    /** Number of beat multiples the tempo candidates are scored on. */
+    constexpr int numCombBeats = 4;
+}
+
+BeatDetector::BeatDetector(double _sampleRate)
+        : sampleRate(_sampleRate),
+          hopSize(jmax(1, roundToInt(_sampleRate * hopSeconds))),
+          lowPassCoefficient((float) (1.0 - std::exp(-MathConstants<double>::twoPi * lowBandHz / _sampleRate))) {}
+
+BeatDetector::~BeatDetector() {}
+
+void BeatDetector::process(const AudioBuffer<float> &block, int numSamples) {
+    const int numChannels = block.getNumChannels();
+    if (numChannels == 0 || numSamples <= 0) {
+        return;
+    }
+
+    if ((int) mono.size() < numSamples) {
+        mono.resize((size_t) numSamples);
+        lowBand.resize((size_t) numSamples);
+    }
+
+    FloatVectorOperations::copyWithMultiply(mono.data(), block.getReadPointer(0), 1.0f / (float) numChannels, numSamples);
+    for (int channel = 1; channel < numChannels; ++channel) {
+        FloatVectorOperations::addWithMultiply(mono.data(), block.getReadPointer(channel), 1.0f / (float) numChannels, numSamples);
+    }
+
+    // the low band filter is recursive, so it runs sample by sample
+    for (int i = 0; i < numSamples; ++i) {
+        lowPassState += lowPassCoefficient * (mono[(size_t) i] - lowPassState);
+        lowBand[(size_t) i] = lowPassState;
+    }
+
+    // the energies are summed a hop at a time, hops carry over between blocks
+    int done = 0;
+    while (done < numSamples) {
+        const int numToAdd = jmin(numSamples - done, hopSize - hopFill);
+        hopFullSum += sumOfSquares(mono.data() + done, numToAdd);
+        hopLowSum += sumOfSquares(lowBand.data() + done, numToAdd);
+        hopFill += numToAdd;
+        done += numToAdd;
+
+        if (hopFill == hopSize) {
+            addHop();
+        }
+    }
+}
+
+void BeatDetector::addHop() {
+    // log energy rises, so quiet and loud passages count alike, the low band counts double so the
+    // kicks mark the beat rather than the hi-hats between them
+    const float fullEnergy = std::log(1.0f + 1000.0f * hopFullSum / (float) hopSize);
+    const float lowEnergy = std::log(1.0f + 1000.0f * hopLowSum / (float) hopSize);
+
+    onsets.push_back(jmax(0.0f, fullEnergy - previousFullEnergy) + 2.0f * jmax(0.0f, lowEnergy - previousLowEnergy));
+
+    previousFullEnergy = fullEnergy;
+    previousLowEnergy = lowEnergy;
+    hopFullSum = 0.0f;
+    hopLowSum = 0.0f;
+    hopFill = 0;
+}
+
+void BeatDetector::finish(TrackAnalysis &analysis) {
+    analysis.bpm = 0.0;
+    analysis.firstBeatSeconds = 0.0;
+
+    const double frameRate = sampleRate / hopSize;
+    const int numFrames = (int) onsets.size();
+    const int minLag = jmax(1, (int) std::floor(60.0 * frameRate / maxBpm));
+    const int maxLag = (int) std::ceil(60.0 * frameRate / minBpm);
+    const int numLags = numCombBeats * maxLag + 2;
+
+    if (numFrames < numLags * 4) {
+        return; // too short for a reliable tempo
+    }
+
+    // remove the mean, so the autocorrelation measures periodicity rather than loudness
+    float mean = 0.0f;
+    for (float onset: onsets) {
+        mean += onset;
+    }
+    FloatVectorOperations::add(onsets.data(), -mean / (float) numFrames, numFrames);
+
+    std::vector<float> autocorrelation((size_t) numLags, 0.0f);
+    for (int lag = 1; lag < numLags; ++lag) {
+        autocorrelation[(size_t) lag] = dot(onsets.data(), onsets.data() + lag, numFrames - lag) / (float) (numFrames - lag);
+    }
+
+    // a true beat period also lines up at two, three and four beats, half and double tempos don't,
+    // and in the 4/4 time of almost all dance music there is usually something on the half beat too
+    int bestLag = 0;
+    double bestScore = 0.0;
+    for (int lag = minLag; lag <= maxLag; ++lag) {
+        double score = 0.5 * autocorrelation[(size_t) (lag / 2)];
+        for (int beats = 1; beats <= numCombBeats; ++beats) {
+            score += autocorrelation[(size_t) (beats * lag)] / beats;
+        }
+
+        const double octaves = std::log2(60.0 * frameRate / lag / typicalBpm) / priorWidthOctaves;
+        score *= std::exp(-0.5 * octaves * octaves);
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+
+    if (bestLag == 0) {
+        return; // nothing periodic
+    }
+
+    // a peak k beats out pins the period down k times as precisely, so refine on ever further peaks
+    double period = bestLag;
+    for (int beats = numCombBeats; beats * period < numFrames / 2; beats *= 4) {
+        period = findPeriodNear(beats * period) / beats;
+    }
+
+    // the phase at which the beats collect the most onset energy
+    const int numBeats = (int) ((numFrames - 1) / period) - 1;
+    double bestPhase = 0.0;
+    float bestSum = -std::numeric_limits<float>::max();
+
+    for (double phase = 0.0; phase < period; phase += 0.25) {
+        float sum = 0.0f;
+        for (int beat = 0; beat < numBeats; ++beat) {
+            sum += onsets[(size_t) std::lround(phase + beat * period)];
+        }
+
+        if (sum > bestSum) {
+            bestSum = sum;
+            bestPhase = phase;
+        }
+    }
+
+    analysis.bpm = 60.0 * frameRate / period;
+    analysis.firstBeatSeconds = bestPhase / frameRate;
+}
+
+double BeatDetector::findPeriodNear(double lag) const {
+    const int numFrames = (int) onsets.size();
+    const int centre = roundToInt(lag);
+    const int first = jmax(1, centre - 3), last = jmin(numFrames - 2, centre + 3);
+
+    float correlations[7 + 2];
+    auto correlationAt = [&](int at) {
+        return dot(onsets.data(), onsets.data() + at, numFrames - at) / (float) (numFrames - at);
+    };
+
+    int peak = first;
+    for (int at = first; at <= last; ++at) {
+        correlations[at - first + 1] = correlationAt(at);
+        if (correlations[at - first + 1] > correlations[peak - first + 1]) {
+            peak = at;
+        }
+    }
+
+    // interpolate between the neighbours of the peak for a fractional lag
+    const double before = peak > first ? correlations[peak - first] : correlationAt(peak - 1);
+    const double at = correlations[peak - first + 1];
+    const double after = peak < last ? correlations[peak - first + 2] : correlationAt(peak + 1);
+    const double curvature = before - 2.0 * at + after;
+    return peak + (curvature < 0.0 ? jlimit(-0.5, 0.5, 0.5 * (before - after) / curvature) : 0.0);
+}
+
+float BeatDetector::sumOfSquares(const float *samples, int numSamples) {
+    return dot(samples, samples, numSamples);
+}
+
+float BeatDetector::dot(const float *a, const float *b, int numSamples) {
+    float sum = 0.0f;
+    int i = 0;
+
+#if JUCE_INTEL
+    __m128 products = _mm_setzero_ps();
+
+    for (; i + 4 <= numSamples; i += 4) {
+        products = _mm_add_ps(products, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, products);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif JUCE_ARM && defined(__ARM_NEON)
+    float32x4_t products = vdupq_n_f32(0.0f);
+
+    for (; i + 4 <= numSamples; i += 4) {
+        products = vmlaq_f32(products, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+
+    float lanes[4];
+    vst1q_f32(lanes, products);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+    // the tail, or everything without SIMD
+    for (; i < numSamples; ++i) {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+}
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    BeatDetector.h
+    Created: 17 Oct 2026 6:41:12pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "TrackAnalysis.h"
+
+using namespace juce;
+
+/**
+ * @class BeatDetector
+ * @brief Finds the tempo and beatgrid of a track from its decoded audio.
+ *
+ * The audio is fed in blocks as it is decoded. Every hop of about 6 ms adds one value to an onset
+ * envelope: the rise in log energy of the full band plus twice the rise in a low band below
+ * about 150 Hz, so kicks weigh in even under busy hi-hats. Once the whole track has been fed, the
+ * tempo is the autocorrelation lag of the envelope that best explains the peaks at its multiples
+ * and its half beat, weighted towards common dance tempos, and refined on peaks many beats out
+ * for sub-frame precision. The grid phase is the offset at which the beats collect the most onset
+ * energy.
+ *
+ * The energies and the autocorrelation use SIMD dot products.
+ */
+class BeatDetector {
+public:
+    static constexpr double minBpm = 70.0; /**< Slowest tempo reported, slower tracks are reported at double time. */
+    static constexpr double maxBpm = 180.0; /**< Fastest tempo reported, faster tracks are reported at half time. */
+
+    /**
+     * @brief Constructor.
+     * @param sampleRate The sample rate of the audio that will be fed.
+     */
+    BeatDetector(double sampleRate);
+
+    /** Destructor. */
+    ~BeatDetector();
+
+    /**
+     * @brief Feed the next block of the track.
+     * @param block The decoded audio, all channels are mixed down.
+     * @param numSamples The number of samples to use from the start of the block.
+     */
+    void process(const AudioBuffer<float> &block, int numSamples);
+
+    /**
+     * @brief Estimate the tempo and beatgrid from everything fed so far.
+     * @param analysis Receives the bpm and the first beat, bpm is 0 if there is no steady tempo.
+     */
+    void finish(TrackAnalysis &analysis);
+
+private:
+    /** Add the onset strength of a finished hop to the envelope. */
+    void addHop();
+
+    /** Find the autocorrelation peak of the onset envelope within a few frames of a lag, to a fraction of a frame. */
+    double findPeriodNear(double lag) const;
+
+    /** Get the sum of squares of a block. */
+    static float sumOfSquares(const float *samples, int numSamples);
+
+    /** Get the dot product of two blocks. */
+    static float dot(const float *a, const float *b, int numSamples);
+
+    double sampleRate; /**< Sample rate of the audio. */
+    int hopSize; /**< Samples per onset envelope value. */
+    float lowPassCoefficient; /**< One-pole coefficient of the low band filter. */
+    float lowPassState = 0.0f; /**< Low band filter state, carried across blocks. */
+
+    std::vector<float> mono; /**< Mono mix of the current block. */
+    std::vector<float> lowBand; /**< Low band of the current block. */
+    float hopFullSum = 0.0f; /**< Sum of squares of the current hop's full band so far. */
+    float hopLowSum = 0.0f; /**< Sum of squares of the current hop's low band so far. */
+    int hopFill = 0; /**< Samples in the current hop so far. */
+
+    float previousFullEnergy = 0.0f; /**< Log energy of the previous full band hop. */
+    float previousLowEnergy = 0.0f; /**< Log energy of the previous low band hop. */
+    std::vector<float> onsets; /**< Onset envelope, one value per hop. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BeatDetector)
+};
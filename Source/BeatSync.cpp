@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    BeatSync.cpp
+    Created: 17 Oct 2026 7:18:05pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Extrapolate a deck's beat position to another output frame - DONE
+ * 2. PI controller with a limited correction and anti-windup - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "BeatSync.h"
+
+double BeatClock::getBeatsAt(int64 otherFrame, double sampleRate) const {
+    if (!playing) {
+        return beats;
+    }
+    return beats + (double) (otherFrame - frame) / sampleRate * beatsPerSecond;
+}
+
+void PhaseLock::reset() {
+    integral = 0.0;
+}
+
+double PhaseLock::process(double errorSeconds, double intervalSeconds) {
+    const double newIntegral = integral + errorSeconds * intervalSeconds;
+    const double correction = proportionalGain * errorSeconds + integralGain * newIntegral;
+
+    if (std::abs(correction) > maxCorrection) {
+        // saturated: don't let the integral wind up, it would overshoot once the error is taken up
+        return jlimit(-maxCorrection, maxCorrection, correction);
+    }
+
+    integral = newIntegral;
+    return correction;
+}
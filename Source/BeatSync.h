@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    BeatSync.h
+    Created: 17 Oct 2026 7:18:05pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+/**
+ * @struct BeatClock
+ * @brief Where a deck is in its beatgrid at a given output frame, as seen by the audio thread.
+ */
+struct BeatClock {
+    bool hasBeatgrid = false; /**< Whether the loaded track has a tempo. */
+    bool playing = false; /**< Whether the deck is moving through the track. */
+    double beats = 0.0; /**< Beats since the first beat of the grid, at the frame below. */
+    double beatsPerSecond = 0.0; /**< Beats played per second of real time at the current speed. */
+    int64 frame = 0; /**< Output frame the clock was read at. */
+
+    /**
+     * @brief Get the beat the deck will be at at another output frame, assuming it keeps its speed.
+     * @param otherFrame The output frame.
+     * @param sampleRate The output sample rate.
+     * @return The beat position at that frame.
+     */
+    double getBeatsAt(int64 otherFrame, double sampleRate) const;
+};
+
+/**
+ * @class PhaseLock
+ * @brief PI controller that nudges a following deck's speed to hold its beats on another deck's.
+ *
+ * The proportional part pulls the phase error in, the integral part takes up the drift left by
+ * small differences between the two beatgrids. The correction is limited to a few percent, so it
+ * stays inaudible, and the integral stops growing while the correction is limited. Each update
+ * is a handful of operations, so the cost per audio block is constant.
+ */
+class PhaseLock {
+public:
+    static constexpr double proportionalGain = 4.0; /**< Speed correction per second of phase error. */
+    static constexpr double integralGain = 4.0; /**< Speed correction per second of error per second. */
+    static constexpr double maxCorrection = 0.04; /**< Largest speed change, relative to the matched tempo. */
+
+    /** @brief Forget the accumulated error, e.g. after a jump. */
+    void reset();
+
+    /**
+     * @brief Update the controller once per audio block.
+     * @param errorSeconds How far the follower lags behind, in seconds of real time (negative if ahead).
+     * @param intervalSeconds Time since the previous update.
+     * @return The relative speed correction to apply for the next block.
+     */
+    double process(double errorSeconds, double intervalSeconds);
+
+private:
+    double integral = 0.0; /**< Accumulated error in seconds times seconds. */
+};
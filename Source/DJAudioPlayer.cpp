@@ -1,104 +1,753 @@
-/*
-  ==============================================================================
-
-    DJAudioPlayer.cpp
-    Created: 9 Jan 2024 2:41:38pm
-    Author:  JAMIUL ISLAM
-
- * Progress:
- *
- * 1. Prepare the transportSource and resamplingSource - DONE
- * 2. Get the next audio block from the resamplingSource - DONE
- * 3. Release the resources of the transportSource and resamplingSource - DONE
- * 4. Load the audio file from the provided URL - DONE
- * 5. Set the gain for the audio player - DONE
- * 6. Set the speed/resampling ratio for the audio player - DONE
- * 7. Set the position of the playhead in seconds - DONE
- * 8. Set the relative position of the playhead - DONE
- * 9. Start playing the audio - DONE
- * 10. Stop/pause the audio - DONE
- * 11. Get the relative position of the playhead - DONE
- *
-
-  ==============================================================================
-*/
-
-#include "DJAudioPlayer.h"
-
-DJAudioPlayer::DJAudioPlayer(AudioFormatManager &_formatManager) : formatManager(_formatManager) {}
-
-DJAudioPlayer::~DJAudioPlayer() {}
-
-void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
-    // prepare the transportSource and resamplingSource
-    transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    resamplingSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
-}
-
-void DJAudioPlayer::getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) {
-    // get the next audio block from the resamplingSource
-    resamplingSource.getNextAudioBlock(bufferToFill);
-}
-
-void DJAudioPlayer::releaseResources() {
-    // release the resources of the transportSource and resamplingSource
-    transportSource.releaseResources();
-    resamplingSource.releaseResources();
-}
-
-void DJAudioPlayer::loadURL(URL audioURL) {
-    // create a reader for the audioURL that was passed in the parameter
-    auto *reader = formatManager.createReaderFor(audioURL.createInputStream(false));
-    if (reader != nullptr) // good file!
-    {
-        // create a new readerSource that will be used to load the reader
-        std::unique_ptr<AudioFormatReaderSource> newSource(new AudioFormatReaderSource(reader, true));
-        // set the song source of the transportSource to the newSource
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
-        // set the song source of the resamplingSource to the transportSource
-        readerSource.reset(newSource.release());
-    }
-}
-
-void DJAudioPlayer::setGain(double gain) {
-    if (gain < 0 || gain > 1.0) {
-        std::cout << "DJAudioPlayer::setGain gain should be between 0 and 1" << std::endl;
-    } else {
-        transportSource.setGain(gain);
-    }
-}
-
-void DJAudioPlayer::setSpeed(double ratio) {
-    if (ratio < 0 || ratio > 100.0) {
-        std::cout << "DJAudioPlayer::setSpeed ratio should be between 0 and 100" << std::endl;
-    } else {
-        resamplingSource.setResamplingRatio(ratio);
-    }
-}
-
-void DJAudioPlayer::setPosition(double posInSecs) {
-    // set the position of the transportSource
-    transportSource.setPosition(posInSecs);
-}
-
-void DJAudioPlayer::setPositionRelative(double pos) {
-    if (pos < 0 || pos > 1.0) {
-        std::cout << "DJAudioPlayer::setPositionRelative pos should be between 0 and 1" << std::endl;
-    } else {
-        double posInSecs = transportSource.getLengthInSeconds() * pos;
-        setPosition(posInSecs);
-    }
-}
-
-void DJAudioPlayer::start() {
-    transportSource.start(); // start the song
-}
-
-void DJAudioPlayer::stop() {
-    transportSource.stop(); // pause the song
-}
-
-double DJAudioPlayer::getPositionRelative() {
-    // return the relative position of the playHead so that it can be used in the slider
-    return transportSource.getCurrentPosition() / transportSource.getLengthInSeconds();
+/*
+  ==============================================================================
+
+    DJAudioPlayer.cpp
+    Created: 9 Jan 2024 2:41:38pm
+    Author:  JAMIUL ISLAM
+
+ * Progress:
+ *
+ * 1. Prepare the transportSource and resamplingSource - DONE
+ * 2. Get the next audio block from the resamplingSource - DONE
+ * 3. Release the resources of the transportSource and resamplingSource - DONE
+ * 4. Load the audio file from the provided URL - DONE
+ * 5. Set the gain for the audio player - DONE
+ * 6. Set the speed/resampling ratio for the audio player - DONE
+ * 7. Set the position of the playhead in seconds - DONE
+ * 8. Set the relative position of the playhead - DONE
+ * 9. Start playing the audio - DONE
+ * 10. Stop/pause the audio - DONE
+ * 11. Get the relative position of the playhead - DONE
+ * 12. Open and prime new tracks on a background loader thread - DONE
+ * 13. Decode ahead of the playhead on the shared streaming thread - DONE
+ * 14. Play uncompressed WAV/AIFF files straight from a memory map - DONE
+ * 15. Play cached tracks from the shared decoded track cache - DONE
+ * 16. Publish a timestamped playhead snapshot from the audio thread - DONE
+ * 17. Send controls to the audio thread through a lock-free queue, applied sample-accurately - DONE
+ * 18. Key lock: change the tempo through a time stretcher that keeps the pitch - DONE
+ * 19. Convert the track rate and the speed in one resampler with selectable quality - DONE
+ * 20. Sync: follow the partner deck's tempo and beats, corrected every block on the audio thread - DONE
+ * 21. Trim each track to a common loudness, folded into the transport gain - DONE
+ * 22. Offline rendering: load synchronously and apply commands at exact frames - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "DJAudioPlayer.h"
+#include "DecodedTrackSource.h"
+
+namespace {
+    /** Length of the fade after a start or stop, short enough to feel instant but long enough not to click. */
+    constexpr int playFadeSamples = 256;
+
+    /** Phase error in beats above which sync jumps into phase instead of pulling it in slowly. */
+    constexpr double syncSnapBeats = 0.02;
+
+    /** Order in which decks were synced, shared by all decks, only touched on the message thread. */
+    int lastSyncOrder = 0;
+
+    /** How often waiting commands are retried and old tracks freed. */
+    constexpr int housekeepingIntervalMs = 50;
+
+    /** Get the control a command sets, waiting commands for the same control replace each other. */
+    DeckCommand::Type getControl(DeckCommand::Type type) {
+        switch (type) {
+            case DeckCommand::Type::stop:
+                return DeckCommand::Type::start;
+            case DeckCommand::Type::setPositionRelative:
+                return DeckCommand::Type::setPosition;
+            default:
+                return type;
+        }
+    }
+}
+
+/**
+ * @class DJAudioPlayer::LoadJob
+ * @brief Opens a track on the loader thread and hands the primed source back to the player.
+ */
+class DJAudioPlayer::LoadJob : public ThreadPoolJob {
+public:
+    LoadJob(DJAudioPlayer &_owner, URL _audioURL, int _generation, bool _playWhenReady, TrackAnalysis _analysis)
+            : ThreadPoolJob("DJAudioPlayer loader"), owner(_owner), audioURL(std::move(_audioURL)),
+              generation(_generation), playWhenReady(_playWhenReady), analysis(_analysis) {}
+
+    JobStatus runJob() override {
+        // open the stream, probe the format and prepare the source off the message thread
+        auto newTrack = owner.createTrack(audioURL, generation, playWhenReady, analysis);
+        const bool isStreamed = newTrack != nullptr
+                                && dynamic_cast<ReadAheadAudioSource *>(newTrack->source.get()) != nullptr;
+
+        if (shouldExit() || owner.loadGeneration.load() != generation) {
+            return jobHasFinished; // a newer load has been requested, drop this one
+        }
+
+        {
+            const ScopedLock sl(owner.pendingLock);
+            owner.pendingTrack = std::move(newTrack);
+            owner.pendingGeneration = generation;
+            // a streamed local track is decoded into the cache once the deck stops, see queueCacheFill()
+            owner.pendingCacheFill = isStreamed && audioURL.isLocalFile() ? audioURL.getLocalFile() : File();
+        }
+
+        owner.triggerAsyncUpdate();
+        return jobHasFinished;
+    }
+
+private:
+
+    DJAudioPlayer &owner;
+    URL audioURL;
+    int generation;
+    bool playWhenReady;
+    TrackAnalysis analysis;
+};
+
+/**
+ * @class DJAudioPlayer::CacheFillJob
+ * @brief Decodes a streamed track into the shared cache while its deck is stopped.
+ */
+class DJAudioPlayer::CacheFillJob : public ThreadPoolJob {
+public:
+    CacheFillJob(DJAudioPlayer &_owner, File _file, int _generation)
+            : ThreadPoolJob("DJAudioPlayer cache fill"), owner(_owner), file(std::move(_file)), generation(_generation) {}
+
+    JobStatus runJob() override {
+        // gives up when another track is loaded, or when the deck starts and its read-ahead needs the disk,
+        // the next stop queues it again
+        owner.trackCache.decodeAndInsert(file, owner.formatManager, [this] {
+            return shouldExit() || owner.loadGeneration.load() != generation || owner.playhead.read().playing;
+        });
+        return jobHasFinished;
+    }
+
+private:
+    DJAudioPlayer &owner;
+    File file;
+    int generation;
+};
+
+DJAudioPlayer::DJAudioPlayer(AudioFormatManager &_formatManager, TimeSliceThread &_readAheadThread,
+                             DecodedTrackCache &_trackCache)
+        : formatManager(_formatManager), readAheadThread(_readAheadThread), trackCache(_trackCache) {}
+
+DJAudioPlayer::~DJAudioPlayer() {
+    // stop any load in flight before the members it writes to go away
+    loaderPool.removeAllJobs(true, 2000);
+    cacheFillPool.removeAllJobs(true, 2000);
+    cancelPendingUpdate();
+    stopTimer();
+}
+
+void DJAudioPlayer::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    // prepare the transport, the time stretcher and the resampler
+    transport.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    timeStretchSource.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    resampler.prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    outputSampleRate = sampleRate;
+    expectedBlockSize = samplesPerBlockExpected;
+    lastBlockStartMs = 0.0;
+    framesRendered = 0;
+}
+
+void DJAudioPlayer::getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) {
+    const double blockStartMs = Time::getMillisecondCounterHiRes();
+    DeckCommand command;
+
+    // a new track is swapped in first, so the whole block, its sync and its playhead belong to it
+    while (commands.peek(command) && command.type == DeckCommand::Type::loadTrack
+           && getCommandOffset(command, blockStartMs, bufferToFill.numSamples) == 0) {
+        applyCommand(command);
+        commands.pop();
+    }
+
+    // the speed for this block is settled before anything is rendered, so the correction is exact
+    updateSync(bufferToFill.numSamples);
+
+    // publish where this block starts, so the UI can extrapolate without touching the transport
+    PlayheadSnapshot snapshot;
+    snapshot.positionSeconds = getPlayedPosition();
+    // the transport runs at the track's own rate, so its positions are in track samples
+    snapshot.lengthSeconds = (double) transport.getLength() / getSourceSampleRate();
+    snapshot.rate = getEffectiveSpeed();
+    snapshot.playing = playing;
+    snapshot.timestampMs = blockStartMs;
+    playhead.publish(snapshot);
+
+    // split the block at every queued command and apply it exactly at its offset
+    int done = 0;
+
+    while (commands.peek(command)) {
+        const int offset = getCommandOffset(command, blockStartMs, bufferToFill.numSamples);
+        if (offset >= bufferToFill.numSamples || command.type == DeckCommand::Type::loadTrack) {
+            break; // scheduled for a later block, a track only ever at the top of one
+        }
+
+        if (offset > done) {
+            renderSegment(bufferToFill, done, offset - done);
+            done = offset;
+        }
+
+        applyCommand(command);
+        commands.pop();
+    }
+
+    if (done < bufferToFill.numSamples) {
+        renderSegment(bufferToFill, done, bufferToFill.numSamples - done);
+    }
+
+    // the transport stops at the end of the track, like a start without a track it takes a move back to play again
+    if (playing && transport.hasFinished()) {
+        playing = false;
+    }
+
+    lastBlockStartMs = blockStartMs;
+    framesRendered += bufferToFill.numSamples;
+}
+
+int DJAudioPlayer::getCommandOffset(const DeckCommand &command, double blockStartMs, int numSamples) const {
+    if (command.frame >= 0) {
+        return (int) jlimit((int64) 0, (int64) numSamples, command.frame - framesRendered);
+    }
+
+    if (command.type == DeckCommand::Type::loadTrack) {
+        return 0; // a new track starts with a block
+    }
+
+    if (lastBlockStartMs <= 0.0) {
+        return 0; // first block since the device started
+    }
+
+    // commands sent during the previous block land at the same place in this one, one block later,
+    // so they keep their spacing instead of all bunching up at the start of the block
+    const double sinceLastBlockMs = jmin(command.timestampMs, blockStartMs) - lastBlockStartMs;
+    return jlimit(0, jmax(0, numSamples - 1), roundToInt(sinceLastBlockMs * 0.001 * outputSampleRate));
+}
+
+void DJAudioPlayer::applyCommand(const DeckCommand &command) {
+    switch (command.type) {
+        case DeckCommand::Type::start:
+            playing = true;
+            break;
+        case DeckCommand::Type::stop:
+            playing = false;
+            break;
+        case DeckCommand::Type::setGain:
+            faderGain = (float) command.value;
+            transport.setGain(faderGain * trimGain * userTrimGain); // the transport ramps to the new gain
+            break;
+        case DeckCommand::Type::setSpeed:
+            // the resampler and the stretcher pick the speed up in renderSource
+            speed = command.value;
+            break;
+        case DeckCommand::Type::setPosition:
+            jumpTo(command.value);
+            phaseLocked = false; // a synced deck snaps back onto the beat from where it lands
+            break;
+        case DeckCommand::Type::setPositionRelative:
+            jumpTo((double) transport.getLength() * command.value / getSourceSampleRate());
+            phaseLocked = false;
+            break;
+        case DeckCommand::Type::setKeyLock:
+            if (keyLock != (command.value != 0.0)) {
+                keyLock = command.value != 0.0;
+                // start the new path from the transport's position instead of stale buffered audio
+                timeStretchSource.reset();
+                resampler.setInput(keyLock ? static_cast<AudioSource *>(&timeStretchSource) : &transport);
+            }
+            break;
+        case DeckCommand::Type::setResamplerQuality:
+            resampler.setQuality((DeckResampler::Quality) (int) command.value);
+            break;
+        case DeckCommand::Type::setSync:
+            syncOrder = (int) command.value;
+            phaseLocked = false;
+            break;
+        case DeckCommand::Type::setTrim:
+            userTrimGain = (float) command.value;
+            transport.setGain(faderGain * trimGain * userTrimGain);
+            break;
+        case DeckCommand::Type::loadTrack:
+            // the rate, the grid, the trim and the source all change together, before the block renders
+            currentTrack = command.track;
+            trackSampleRate = currentTrack->sampleRate;
+            transport.setSource(currentTrack->source.get());
+            // the stretcher cuts up the track's samples, before the resampler brings them to the device rate
+            timeStretchSource.setSourceSampleRate(trackSampleRate);
+            beatgrid.bpm = currentTrack->bpm;
+            beatgrid.firstBeatSeconds = currentTrack->firstBeatSeconds;
+            // a pre-fader trim, the transport applies all the gains in the one multiply it does anyway
+            trimGain = currentTrack->trimGain;
+            transport.setGain(faderGain * trimGain * userTrimGain);
+            playing = currentTrack->playWhenReady;
+            // nothing buffered from the previous track is played
+            timeStretchSource.reset();
+            resampler.reset();
+            phaseLocked = false;
+            // from here on the previous track is the message thread's to free
+            playingGeneration.store(currentTrack->generation, std::memory_order_release);
+            break;
+    }
+}
+
+void DJAudioPlayer::updateSync(int numSamples) {
+    const double beatsPerSecond = beatgrid.bpm / 60.0; // at speed 1
+    double position = getPlayedPosition();
+
+    // if both decks are synced, the one synced first follows and the other leads
+    following = syncOrder != 0 && syncPartner != nullptr && beatsPerSecond > 0.0
+                && syncPartner->beatClock.hasBeatgrid
+                && !(syncPartner->syncOrder != 0 && syncPartner->syncOrder < syncOrder);
+
+    if (!following) {
+        phaseLocked = false;
+    } else {
+        // the partner's clock is from the start of this block if it has already been rendered, or
+        // from the start of the previous one, either way it is carried forward to this block's frame
+        const BeatClock &leader = syncPartner->beatClock;
+        const double tempoSpeed = leader.beatsPerSecond / beatsPerSecond;
+        double correction = 0.0;
+
+        if (leader.playing && playing && leader.beatsPerSecond > 0.0) {
+            // lock to the nearest beat, whichever beat of the bar it is
+            double error = leader.getBeatsAt(framesRendered, outputSampleRate)
+                           - (position - beatgrid.firstBeatSeconds) * beatsPerSecond;
+            error -= std::round(error);
+
+            if (!phaseLocked) {
+                phaseLocked = true;
+                phaseLock.reset();
+
+                // far out of phase, e.g. just started or moved, jump onto the beat rather than drift there
+                if (std::abs(error) > syncSnapBeats) {
+                    position = jmax(0.0, position + error / beatsPerSecond);
+                    jumpTo(position);
+                    error = 0.0;
+                }
+            }
+
+            // the error in seconds of real time, a constant amount of work per block
+            correction = phaseLock.process(error / leader.beatsPerSecond, numSamples / outputSampleRate);
+        } else {
+            phaseLocked = false;
+        }
+
+        syncSpeed = tempoSpeed * (1.0 + correction);
+    }
+
+    // publish this deck's clock for the partner
+    beatClock.hasBeatgrid = beatsPerSecond > 0.0;
+    beatClock.playing = playing;
+    beatClock.beats = (position - beatgrid.firstBeatSeconds) * beatsPerSecond;
+    beatClock.beatsPerSecond = beatsPerSecond * getEffectiveSpeed();
+    beatClock.frame = framesRendered;
+}
+
+double DJAudioPlayer::getPlayedPosition() const {
+    // the resampler, and with key lock the stretcher, have pulled audio that hasn't been played yet
+    double bufferedInput = resampler.getBufferedInput();
+    if (keyLock) {
+        // the resampler's input is stretched, each of its samples is speed samples of the track
+        bufferedInput = timeStretchSource.getBufferedInput() + bufferedInput * getEffectiveSpeed();
+    }
+
+    return jmax(0.0, ((double) transport.getPosition() - bufferedInput) / getSourceSampleRate());
+}
+
+double DJAudioPlayer::getEffectiveSpeed() const {
+    return following ? syncSpeed : speed;
+}
+
+void DJAudioPlayer::jumpTo(double positionSeconds) {
+    transport.setPosition((int64) (positionSeconds * getSourceSampleRate()));
+    timeStretchSource.reset(); // don't play out the audio buffered before the jump
+    resampler.reset();
+}
+
+void DJAudioPlayer::renderSegment(const AudioSourceChannelInfo &bufferToFill, int offset, int numSamples) {
+    const AudioSourceChannelInfo segment(bufferToFill.buffer, bufferToFill.startSample + offset, numSamples);
+    const float target = playing ? 1.0f : 0.0f;
+
+    if (playGain == target) {
+        if (playing) {
+            renderSource(segment);
+        } else {
+            segment.clearActiveBufferRegion();
+        }
+        return;
+    }
+
+    // fading after a start or stop, possibly across several segments
+    const int fadeLeft = jmax(1, roundToInt(std::abs(target - playGain) * playFadeSamples));
+    const int fadeSamples = jmin(numSamples, fadeLeft);
+    const float endGain = fadeSamples == fadeLeft ? target
+                                                  : playGain + (target - playGain) * (float) fadeSamples / (float) fadeLeft;
+
+    // a stopping track only plays until its fade ends, so the position stops there
+    const int samplesToPlay = playing ? numSamples : fadeSamples;
+    renderSource(AudioSourceChannelInfo(segment.buffer, segment.startSample, samplesToPlay));
+    segment.buffer->applyGainRamp(segment.startSample, fadeSamples, playGain, endGain);
+
+    if (samplesToPlay < numSamples) {
+        segment.buffer->clear(segment.startSample + samplesToPlay, numSamples - samplesToPlay);
+    }
+
+    playGain = endGain;
+}
+
+void DJAudioPlayer::renderSource(const AudioSourceChannelInfo &info) {
+    // with key lock the stretcher has already applied the speed, only the sample rate is left
+    const double deckSpeed = getEffectiveSpeed();
+    timeStretchSource.setSpeed(deckSpeed);
+    const double ratio = (keyLock ? 1.0 : deckSpeed) * getSourceSampleRate() / outputSampleRate;
+    resampler.setRatio(ratio);
+    resampler.getNextAudioBlock(info);
+}
+
+double DJAudioPlayer::getSourceSampleRate() const {
+    return trackSampleRate > 0.0 ? trackSampleRate : outputSampleRate;
+}
+
+void DJAudioPlayer::postCommand(DeckCommand::Type type, double value, DeckTrack *track) {
+    DeckCommand command;
+    command.type = type;
+    command.value = value;
+    command.track = track;
+    command.timestampMs = Time::getMillisecondCounterHiRes();
+    if (offline) {
+        // the caller renders the blocks too, so the command lands exactly on the next frame rendered
+        command.frame = framesRendered;
+    }
+
+    // commands still waiting were sent earlier and have to arrive first
+    if (!sendDeferredCommands() || !commands.push(command)) {
+        deferCommand(command);
+    }
+}
+
+bool DJAudioPlayer::sendDeferredCommands() {
+    size_t numSent = 0;
+    while (numSent < deferredCommands.size() && commands.push(deferredCommands[numSent])) {
+        ++numSent;
+    }
+
+    deferredCommands.erase(deferredCommands.begin(), deferredCommands.begin() + (std::ptrdiff_t) numSent);
+    return deferredCommands.empty();
+}
+
+void DJAudioPlayer::deferCommand(const DeckCommand &command) {
+    // the queue fills up while the audio device is stopped, only the latest value of each control matters then
+    const auto control = getControl(command.type);
+    for (auto waiting = deferredCommands.begin(); waiting != deferredCommands.end(); ++waiting) {
+        if (getControl(waiting->type) == control) {
+            if (waiting->track != nullptr) {
+                tracks.removeObject(waiting->track); // never reached the audio thread
+            }
+            deferredCommands.erase(waiting);
+            break;
+        }
+    }
+    deferredCommands.push_back(command);
+
+    if (!offline) {
+        startTimer(housekeepingIntervalMs);
+    }
+}
+
+void DJAudioPlayer::releaseOldTracks() {
+    // the audio thread only moves on to newer tracks, the ones before the playing one are done with
+    const int generation = playingGeneration.load(std::memory_order_acquire);
+    for (int i = tracks.size(); --i >= 0;) {
+        if (tracks[i]->generation < generation) {
+            tracks.remove(i);
+        }
+    }
+}
+
+DeckTrack *DJAudioPlayer::getPlayingTrack() const {
+    const int generation = playingGeneration.load(std::memory_order_acquire);
+    for (auto *track : tracks) {
+        if (track->generation == generation) {
+            return track;
+        }
+    }
+    return nullptr;
+}
+
+void DJAudioPlayer::queueCacheFill() {
+    if (cacheFillFile == File() || playingGeneration.load() != cacheFillGeneration || playhead.read().playing
+        || cacheFillPool.getNumJobs() > 0) {
+        return;
+    }
+
+    if (trackCache.find(cacheFillFile) != nullptr) {
+        cacheFillFile = File(); // filled, the next load of it is instant
+        return;
+    }
+    cacheFillPool.addJob(new CacheFillJob(*this, cacheFillFile, cacheFillGeneration), true);
+}
+
+void DJAudioPlayer::timerCallback() {
+    sendDeferredCommands();
+    releaseOldTracks();
+    queueCacheFill();
+
+    // the playing track stays, anything more is waiting to be played or freed
+    if (deferredCommands.empty() && tracks.size() <= 1 && cacheFillFile == File()) {
+        stopTimer();
+    }
+}
+
+void DJAudioPlayer::releaseResources() {
+    // release the resources of the transport, the time stretcher and the resampler
+    transport.releaseResources();
+    timeStretchSource.releaseResources();
+    resampler.releaseResources();
+}
+
+std::unique_ptr<PositionableAudioSource> DJAudioPlayer::createTrackSource(const URL &audioURL, double &sampleRate) {
+    const int primeSamples = 8192;
+
+    if (audioURL.isLocalFile()) {
+        File file = audioURL.getLocalFile();
+
+        // tracks that were decoded before are shared straight from the cache
+        if (auto cachedTrack = trackCache.find(file)) {
+            sampleRate = cachedTrack->sampleRate;
+            return std::make_unique<DecodedTrackSource>(std::move(cachedTrack));
+        }
+
+        // uncompressed local files are mapped into memory, reads become page-cache lookups
+        if (auto *format = formatManager.findFormatForFileExtension(file.getFileExtension())) {
+            std::unique_ptr<MemoryMappedAudioFormatReader> mappedReader(format->createMemoryMappedReader(file));
+
+            if (mappedReader != nullptr && mappedReader->mapEntireFile()) {
+                // fault in the first few seconds of pages so playback can start without touching the disk
+                const int64 samplesToTouch = jmin(mappedReader->lengthInSamples,
+                                                  (int64) (readAheadSeconds.load() * mappedReader->sampleRate));
+                for (int64 sample = 0; sample < samplesToTouch; sample += 512) {
+                    mappedReader->touchSample(sample);
+                }
+
+                sampleRate = mappedReader->sampleRate;
+                return std::make_unique<AudioFormatReaderSource>(mappedReader.release(), true);
+            }
+        }
+    }
+
+    if (offline && audioURL.isLocalFile()) {
+        // rendering faster than realtime would outrun the streaming thread, and decoding inside the mix would
+        // allocate and read the file on the real-time path, so the track is decoded whole while it loads
+        if (auto decodedTrack = trackCache.decodeAndInsert(audioURL.getLocalFile(), formatManager, [] { return false; })) {
+            sampleRate = decodedTrack->sampleRate;
+            return std::make_unique<DecodedTrackSource>(std::move(decodedTrack));
+        }
+    }
+
+    // compressed files (or anything that can't be mapped) are streamed through the read-ahead buffer
+    auto *reader = formatManager.createReaderFor(audioURL.createInputStream(false));
+    if (reader == nullptr) {
+        return nullptr;
+    }
+
+    if (offline) {
+        // too big for the cache or not a local file, decode on the rendering thread instead
+        sampleRate = reader->sampleRate;
+        return std::make_unique<AudioFormatReaderSource>(reader, true);
+    }
+
+    // prime the decoder so the first audio callback doesn't pay for it
+    AudioBuffer<float> primer((int) jmax(1u, reader->numChannels), primeSamples);
+    reader->read(&primer, 0, primeSamples, 0, true, true);
+
+    // wrap the reader in a read-ahead buffer filled by the shared streaming thread
+    sampleRate = reader->sampleRate;
+    const int samplesToBuffer = (int) (readAheadSeconds.load() * reader->sampleRate);
+    return std::make_unique<ReadAheadAudioSource>(new AudioFormatReaderSource(reader, true),
+                                                  readAheadThread, true, samplesToBuffer);
+}
+
+std::unique_ptr<DeckTrack> DJAudioPlayer::createTrack(const URL &audioURL, int generation, bool playWhenReady,
+                                                      const TrackAnalysis &analysis) {
+    auto track = std::make_unique<DeckTrack>();
+    track->source = createTrackSource(audioURL, track->sampleRate);
+    if (track->source == nullptr) {
+        return nullptr;
+    }
+    track->generation = generation;
+    // sync works from the new track's grid, an unanalysed track has none
+    track->bpm = analysis.bpm;
+    track->firstBeatSeconds = analysis.firstBeatSeconds;
+    // an unmeasured track plays untrimmed
+    track->trimGain = LoudnessMeter::getNormalisationGain(analysis);
+    track->playWhenReady = playWhenReady;
+
+    // the audio thread never prepares a source, and a streamed track buffers its first blocks
+    // on this thread's time, without holding up the load for long
+    const int blockSize = expectedBlockSize.load();
+    track->source->prepareToPlay(blockSize, track->sampleRate);
+    if (auto *readAheadSource = dynamic_cast<ReadAheadAudioSource *>(track->source.get())) {
+        readAheadSource->waitUntilReady(blockSize * 4, 50);
+    }
+    return track;
+}
+
+void DJAudioPlayer::loadURL(URL audioURL, bool playWhenReady, const TrackAnalysis &analysis) {
+    // invalidate any load that is still running and queue the new one
+    const int generation = ++loadGeneration;
+    loaderPool.removeAllJobs(true, 0);
+    cacheFillPool.removeAllJobs(true, 0);
+    cacheFillFile = File();
+
+    if (offline) {
+        // the track is swapped in before the next block is rendered, so the session stays in step
+        releaseOldTracks();
+        auto newTrack = createTrack(audioURL, generation, playWhenReady, analysis);
+        {
+            const ScopedLock sl(pendingLock);
+            pendingTrack = std::move(newTrack);
+            pendingGeneration = generation;
+        }
+
+        handleAsyncUpdate();
+        return;
+    }
+    loaderPool.addJob(new LoadJob(*this, std::move(audioURL), generation, playWhenReady, analysis), true);
+
+    loading = true;
+    sendChangeMessage();
+}
+
+void DJAudioPlayer::setOfflineRendering(bool shouldRenderOffline) {
+    offline = shouldRenderOffline;
+}
+
+bool DJAudioPlayer::isLoading() const {
+    return loading.load();
+}
+
+void DJAudioPlayer::handleAsyncUpdate() {
+    std::unique_ptr<DeckTrack> newTrack;
+
+    {
+        const ScopedLock sl(pendingLock);
+        if (pendingGeneration != loadGeneration.load()) {
+            pendingTrack.reset(); // stale result from a cancelled load
+            return;
+        }
+        newTrack = std::move(pendingTrack);
+        cacheFillFile = pendingCacheFill;
+        cacheFillGeneration = pendingGeneration;
+        pendingGeneration = -1;
+    }
+
+    if (newTrack != nullptr) // good file!
+    {
+        // the audio thread swaps the track in at the top of a block, with its grid, trim and start,
+        // the deck keeps it until it has moved on
+        releaseOldTracks();
+        postCommand(DeckCommand::Type::loadTrack, 0.0, tracks.add(newTrack.release()));
+
+        if (!offline) {
+            // frees the previous track once the audio thread lets go of it, and fills the cache once the deck stops
+            startTimer(housekeepingIntervalMs);
+        }
+    }
+
+    loading = false;
+    sendChangeMessage();
+}
+
+void DJAudioPlayer::setGain(double gain) {
+    // the slider and the renderer keep to the range, anything else is a bug in the caller
+    if (gain < 0 || gain > 1.0) {
+        jassertfalse;
+        return;
+    }
+    postCommand(DeckCommand::Type::setGain, gain);
+}
+
+void DJAudioPlayer::setTrim(double gain) {
+    if (gain < 0) {
+        jassertfalse;
+        return;
+    }
+    postCommand(DeckCommand::Type::setTrim, gain);
+}
+
+void DJAudioPlayer::setSpeed(double ratio) {
+    if (ratio < 0 || ratio > 100.0) {
+        jassertfalse;
+        return;
+    }
+    postCommand(DeckCommand::Type::setSpeed, ratio);
+}
+
+void DJAudioPlayer::setKeyLock(bool shouldLockKey) {
+    postCommand(DeckCommand::Type::setKeyLock, shouldLockKey ? 1.0 : 0.0);
+}
+
+void DJAudioPlayer::setResamplerQuality(DeckResampler::Quality quality) {
+    postCommand(DeckCommand::Type::setResamplerQuality, (double) (int) quality);
+}
+
+void DJAudioPlayer::setSyncPartner(DJAudioPlayer *partner) {
+    syncPartner = partner;
+}
+
+void DJAudioPlayer::setSync(bool shouldSync) {
+    postCommand(DeckCommand::Type::setSync, shouldSync ? (double) ++lastSyncOrder : 0.0);
+}
+
+void DJAudioPlayer::setPosition(double posInSecs) {
+    // set the position of the transport
+    postCommand(DeckCommand::Type::setPosition, posInSecs);
+}
+
+void DJAudioPlayer::setPositionRelative(double pos) {
+    if (pos < 0 || pos > 1.0) {
+        jassertfalse;
+        return;
+    }
+    // the length is only known for sure on the audio thread, where a new track may just have been swapped in
+    postCommand(DeckCommand::Type::setPositionRelative, pos);
+}
+
+void DJAudioPlayer::start() {
+    postCommand(DeckCommand::Type::start); // start the song
+}
+
+void DJAudioPlayer::stop() {
+    postCommand(DeckCommand::Type::stop); // pause the song
+}
+
+void DJAudioPlayer::setReadAheadSeconds(double seconds) {
+    readAheadSeconds = jlimit(0.1, 60.0, seconds);
+}
+
+double DJAudioPlayer::getReadAheadFillLevel() const {
+    auto *track = getPlayingTrack();
+    if (auto *readAheadSource = dynamic_cast<ReadAheadAudioSource *>(track != nullptr ? track->source.get() : nullptr)) {
+        return readAheadSource->getFillLevel();
+    }
+    return track != nullptr ? 1.0 : 0.0; // cached and memory-mapped tracks are always fully available
+}
+
+int DJAudioPlayer::getReadAheadUnderruns() const {
+    auto *track = getPlayingTrack();
+    if (auto *readAheadSource = dynamic_cast<ReadAheadAudioSource *>(track != nullptr ? track->source.get() : nullptr)) {
+        return readAheadSource->getNumUnderruns();
+    }
+    return 0;
+}
+
+double DJAudioPlayer::getPositionRelative() {
+    // return the relative position of the playHead so that it can be used in the slider
+    return playhead.read().extrapolateRelative(Time::getMillisecondCounterHiRes());
+}
+
+PlayheadSnapshot DJAudioPlayer::getPlayhead() const {
+    return playhead.read();
 }
\ No newline at end of file
@@ -1,98 +1,356 @@
-/*
-  ==============================================================================
-
-    DJAudioPlayer.h
-    Created: 9 Jan 2024 2:41:38pm
-    Author:  JAMIUL ISLAM
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-
-using namespace juce;
-
-/**
- * @class DJAudioPlayer
- * @brief Audio player for handling audio playback.
- *
- * This class represents an audio player that utilizes JUCE's AudioSource interface.
- * It provides methods for preparing to play, getting the next audio block, releasing resources,
- * loading audio from a URL, setting gain and speed, and controlling playback.
- */
-class DJAudioPlayer : public juce::AudioSource {
-public:
-    /** Constructor.
-     *  @param _formatManager The audio format manager reference.
-     */
-    DJAudioPlayer(AudioFormatManager& _formatManager);
-
-    /** Destructor. */
-    ~DJAudioPlayer();
-
-    /**
-     * @brief Prepare to play audio.
-     * @param samplesPerBlockExpected The number of samples per block expected.
-     * @param sampleRate The sample rate of the audio.
-     */
-    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
-
-    /**
-     * @brief Get the next audio block for playback.
-     * @param bufferToFill The buffer to fill with audio data.
-     */
-    void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override;
-
-    /** Release audio resources. */
-    void releaseResources() override;
-
-    /**
-     * @brief Load audio from a URL into the transport source.
-     * @param audioURL The URL of the audio file.
-     */
-    void loadURL(URL audioURL);
-
-    /**
-     * @brief Set the gain of the transport source.
-     * @param gain The gain value (0 to 1).
-     */
-    void setGain(double gain);
-
-    /**
-     * @brief Set the speed of the transport source.
-     * @param ratio The speed ratio (0 to 100).
-     */
-    void setSpeed(double ratio);
-
-    /**
-     * @brief Set the position of the playHead.
-     * @param posInSecs The position in seconds.
-     */
-    void setPosition(double posInSecs);
-
-    /**
-     * @brief Set the position of the playHead relative to the length of the audio.
-     * @param pos The relative position (0 to 1).
-     */
-    void setPositionRelative(double pos);
-
-    /**
-     * @brief Get the relative position of the playHead.
-     * @return The relative position of the playHead.
-     */
-    double getPositionRelative();
-
-    /** Start playback. */
-    void start();
-
-    /** Stop playback. */
-    void stop();
-
-private:
-    AudioFormatManager& formatManager; /**< Reference to the formatManager. */
-    std::unique_ptr<AudioFormatReaderSource> readerSource; /**< Pointer to the readerSource. */
-    AudioTransportSource transportSource; /**< TransportSource initialization. */
-    ResamplingAudioSource resamplingSource{&transportSource, false, 2}; /**< ResamplingSource initialization. */
-};
+/*
+  ==============================================================================
+
+    DJAudioPlayer.h
+    Created: 9 Jan 2024 2:41:38pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ReadAheadAudioSource.h"
+#include "DeckTransport.h"
+#include "DecodedTrackCache.h"
+#include "PlayheadSnapshot.h"
+#include "DeckCommandQueue.h"
+#include "TimeStretchAudioSource.h"
+#include "DeckResampler.h"
+#include "BeatSync.h"
+#include "LoudnessMeter.h"
+#include "TrackAnalysis.h"
+
+using namespace juce;
+
+/**
+ * @class DJAudioPlayer
+ * @brief Audio player for handling audio playback.
+ *
+ * This class represents an audio player that utilizes JUCE's AudioSource interface.
+ * It provides methods for preparing to play, getting the next audio block, releasing resources,
+ * loading audio from a URL, setting gain and speed, and controlling playback.
+ *
+ * Tracks are opened on a background loader thread; listeners receive a change message
+ * when a load starts and when the new source has been swapped into the audio chain.
+ * During playback the track is decoded ahead of the playhead on a shared streaming thread,
+ * except for uncompressed WAV/AIFF files, which are played straight from a memory map.
+ * Streamed tracks are decoded into the shared DecodedTrackCache on a background-priority thread
+ * once their deck stops, so loading them again (on either deck) is instant.
+ *
+ * Every audio block publishes a timestamped playhead snapshot, which the UI reads without
+ * locks and extrapolates between blocks.
+ *
+ * Playback controls never touch the audio chain from the message thread. They are queued as
+ * timestamped commands that the audio thread applies at the start of the next block, each at
+ * the sample offset matching when it was sent, so timing is steady and the message thread
+ * never holds a lock the audio callback needs. A loaded track is handed over the same way and
+ * played by a DeckTransport, which keeps the position and length itself, so nothing on the audio
+ * path takes a lock. If the queue is full, e.g. while the device is stopped, commands wait on the
+ * message thread, only the latest of each control, and are sent as soon as there is room.
+ *
+ * With key lock on, speed changes go through a time stretcher instead of the resampler, so the
+ * tempo changes but the pitch stays the same.
+ *
+ * The track's sample rate and the deck speed are converted to the device rate by one
+ * DeckResampler at the end of the chain, with a selectable interpolation quality, so the audio
+ * is only interpolated once.
+ *
+ * With sync on, the deck follows its partner deck: it matches the partner's tempo through the
+ * two beatgrids and holds its beats on the partner's with a PhaseLock, corrected at the start of
+ * every block on the audio thread from the exact positions being played.
+ *
+ * Each track is trimmed to a common loudness from its stored analysis when it is loaded. The
+ * trim is folded into the gain the transport applies anyway, so it costs nothing per block.
+ *
+ * For offline rendering, the thread that renders the blocks also sends the controls: tracks are
+ * loaded and decoded on that thread, and every command lands on the next frame it renders, so a
+ * session renders the same way every time, as fast as the CPU allows.
+ */
+class DJAudioPlayer : public juce::AudioSource,
+                      public ChangeBroadcaster,
+                      private AsyncUpdater,
+                      private Timer {
+public:
+    /** Constructor.
+     *  @param _formatManager The audio format manager reference.
+     *  @param _readAheadThread The streaming thread shared by all decks.
+     *  @param _trackCache The decoded track cache shared by all decks.
+     */
+    DJAudioPlayer(AudioFormatManager& _formatManager, TimeSliceThread& _readAheadThread, DecodedTrackCache& _trackCache);
+
+    /** Destructor. */
+    ~DJAudioPlayer();
+
+    /**
+     * @brief Prepare to play audio.
+     * @param samplesPerBlockExpected The number of samples per block expected.
+     * @param sampleRate The sample rate of the audio.
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /**
+     * @brief Get the next audio block for playback.
+     * @param bufferToFill The buffer to fill with audio data.
+     */
+    void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override;
+
+    /** Release audio resources. */
+    void releaseResources() override;
+
+    /**
+     * @brief Load audio from a URL into the transport source.
+     *
+     * The reader is created and primed on the loader thread and swapped in once it is ready.
+     * Calling this again before a previous load has finished cancels the previous load.
+     *
+     * @param audioURL The URL of the audio file.
+     * @param playWhenReady Whether playback should start as soon as the track is swapped in.
+     * @param analysis The analysis of the track, if it has been analysed: sync uses the beatgrid
+     *                 and the loudness sets the trim.
+     */
+    void loadURL(URL audioURL, bool playWhenReady = false, const TrackAnalysis &analysis = {});
+
+    /**
+     * @brief Render offline instead of behind an audio device, once before anything is loaded.
+     *
+     * Loads finish before loadURL returns, compressed tracks are decoded on the rendering thread
+     * instead of ahead of it, and commands are applied at the next frame rendered instead of by
+     * their timestamps. Every call must then come from the thread that renders the blocks.
+     *
+     * @param shouldRenderOffline True to render offline.
+     */
+    void setOfflineRendering(bool shouldRenderOffline);
+
+    /**
+     * @brief Check whether a track is currently being loaded.
+     * @return True while a load is in progress.
+     */
+    bool isLoading() const;
+
+    /**
+     * @brief Set the gain of the transport source, applied by the audio thread.
+     * @param gain The gain value (0 to 1).
+     */
+    void setGain(double gain);
+
+    /**
+     * @brief Set a trim on top of the track's loudness normalisation, applied by the audio thread.
+     * @param gain The linear gain, kept across loads.
+     */
+    void setTrim(double gain);
+
+    /**
+     * @brief Set the speed of the transport source, applied by the audio thread.
+     * @param ratio The speed ratio (0 to 100).
+     */
+    void setSpeed(double ratio);
+
+    /**
+     * @brief Keep the pitch of the track when the speed changes, applied by the audio thread.
+     * @param shouldLockKey True to time-stretch, false to resample like a turntable.
+     */
+    void setKeyLock(bool shouldLockKey);
+
+    /**
+     * @brief Choose how the deck is resampled to the device rate, applied by the audio thread.
+     * @param quality The interpolation quality.
+     */
+    void setResamplerQuality(DeckResampler::Quality quality);
+
+    /**
+     * @brief Set the deck that sync follows, once before the audio device starts.
+     *
+     * Both decks must be rendered on the same audio thread, one after the other.
+     *
+     * @param partner The other deck, or nullptr.
+     */
+    void setSyncPartner(DJAudioPlayer *partner);
+
+    /**
+     * @brief Lock the tempo and beats to the partner deck's, applied by the audio thread.
+     *
+     * While synced the speed set with setSpeed is ignored, it comes back when sync is turned off.
+     * If both decks are synced, the one synced first follows and the other leads.
+     *
+     * @param shouldSync True to follow the partner deck.
+     */
+    void setSync(bool shouldSync);
+
+    /**
+     * @brief Set the position of the playHead, applied by the audio thread.
+     * @param posInSecs The position in seconds.
+     */
+    void setPosition(double posInSecs);
+
+    /**
+     * @brief Set the position of the playHead relative to the length of the audio, applied by the audio thread.
+     * @param pos The relative position (0 to 1).
+     */
+    void setPositionRelative(double pos);
+
+    /**
+     * @brief Get the relative position of the playHead, extrapolated from the last audio block.
+     *
+     * Safe to call at display rate, it never locks against the audio thread.
+     *
+     * @return The relative position of the playHead.
+     */
+    double getPositionRelative();
+
+    /**
+     * @brief Get the playhead as published by the last audio block, without locking.
+     * @return The latest playhead snapshot.
+     */
+    PlayheadSnapshot getPlayhead() const;
+
+    /**
+     * @brief Set the size of the read-ahead buffer used for tracks loaded from now on.
+     * @param seconds The amount of audio to decode ahead of the playhead.
+     */
+    void setReadAheadSeconds(double seconds);
+
+    /**
+     * @brief Get how full the read-ahead buffer of the current track is.
+     * @return The fill level (0 to 1), 1 for cached or memory-mapped tracks, or 0 if no track is loaded.
+     */
+    double getReadAheadFillLevel() const;
+
+    /**
+     * @brief Get the number of blocks the read-ahead buffer could not serve in time.
+     * @return The number of underruns for the current track.
+     */
+    int getReadAheadUnderruns() const;
+
+    /** Start playback, applied by the audio thread. */
+    void start();
+
+    /** Stop playback, applied by the audio thread with a short fade. */
+    void stop();
+
+private:
+    class LoadJob;
+    class CacheFillJob;
+
+    /** Queue a command for the audio thread, or keep it until there is room, only ever called from the message thread. */
+    void postCommand(DeckCommand::Type type, double value = 0.0, DeckTrack *track = nullptr);
+
+    /**
+     * @brief Send the commands that didn't fit in the queue, oldest first.
+     * @return True if none are left waiting.
+     */
+    bool sendDeferredCommands();
+
+    /** Keep a command that didn't fit in the queue, replacing a waiting one for the same control. */
+    void deferCommand(const DeckCommand &command);
+
+    /** Free the tracks the audio thread has moved on from, on the message thread. */
+    void releaseOldTracks();
+
+    /** Get the track the audio thread plays, on the message thread, or nullptr. */
+    DeckTrack *getPlayingTrack() const;
+
+    /** Decode the playing streamed track into the cache on the background pool, once the deck is stopped. */
+    void queueCacheFill();
+
+    /** Retry deferred commands, free old tracks and fill the cache until there is nothing left to do. */
+    void timerCallback() override;
+
+    /** Get the offset within the current block a command is applied at, numSamples if it belongs to a later block. */
+    int getCommandOffset(const DeckCommand &command, double blockStartMs, int numSamples) const;
+
+    /** Apply a command on the audio thread. */
+    void applyCommand(const DeckCommand &command);
+
+    /** Follow the partner deck's tempo and beats for the block about to be rendered, and publish this deck's beat clock. */
+    void updateSync(int numSamples);
+
+    /** Get the track position being played, in seconds, without the audio buffered ahead of it. */
+    double getPlayedPosition() const;
+
+    /** Get the speed the deck plays at, the synced speed while following. */
+    double getEffectiveSpeed() const;
+
+    /** Jump to a position in seconds on the audio thread, dropping the buffered audio. */
+    void jumpTo(double positionSeconds);
+
+    /** Render from the resampler, fed by the time stretcher with key lock on. */
+    void renderSource(const AudioSourceChannelInfo &info);
+
+    /** Render part of a block, fading in or out after a start or stop. */
+    void renderSegment(const AudioSourceChannelInfo &bufferToFill, int offset, int numSamples);
+
+    /** Get the sample rate of the current track, or the device rate if no track is loaded. */
+    double getSourceSampleRate() const;
+
+    /**
+     * @brief Open a track from the cache, memory-mapped if it is an uncompressed local file, or buffered otherwise.
+     * @param audioURL The URL of the audio file.
+     * @param sampleRate Receives the sample rate of the track.
+     * @return The primed source, or nullptr if the file could not be opened.
+     */
+    std::unique_ptr<PositionableAudioSource> createTrackSource(const URL& audioURL, double& sampleRate);
+
+    /**
+     * @brief Open a track and prepare it for the audio thread, on the loader thread or offline.
+     * @param audioURL The URL of the audio file.
+     * @param generation The load it belongs to.
+     * @param playWhenReady Whether the deck plays as soon as the track is swapped in.
+     * @param analysis The stored analysis, for the beatgrid and the trim.
+     * @return The track, or nullptr if the file could not be opened.
+     */
+    std::unique_ptr<DeckTrack> createTrack(const URL& audioURL, int generation, bool playWhenReady,
+                                           const TrackAnalysis& analysis);
+
+    /** Hand a finished load to the audio thread, on the message thread, or on the rendering thread offline. */
+    void handleAsyncUpdate() override;
+
+    AudioFormatManager& formatManager; /**< Reference to the formatManager. */
+    TimeSliceThread& readAheadThread; /**< Shared thread that decodes ahead of the playhead. */
+    DecodedTrackCache& trackCache; /**< Shared cache of fully decoded tracks. */
+    std::atomic<double> readAheadSeconds{ 4.0 }; /**< Size of the read-ahead buffer in seconds. */
+    OwnedArray<DeckTrack> tracks; /**< Tracks handed to the audio thread and not freed yet, oldest first, message thread only. */
+    std::atomic<int> playingGeneration{ -1 }; /**< Generation of the track the audio thread plays, -1 before the first. */
+    DeckTrack *currentTrack = nullptr; /**< The track being played, only touched by the audio thread. */
+    double trackSampleRate = 0.0; /**< Sample rate of the track being played, 0 before the first, only touched by the audio thread. */
+    DeckTransport transport; /**< Plays the current track. */
+    TimeStretchAudioSource timeStretchSource{ &transport }; /**< Changes the speed without the pitch with key lock on. */
+    DeckResampler resampler{ &transport }; /**< Converts the track rate and the speed to the device rate in one pass. */
+    AtomicPlayhead playhead; /**< Playhead published by the audio thread for the UI. */
+
+    DeckCommandQueue commands; /**< Controls sent from the message thread to the audio thread. */
+    std::vector<DeckCommand> deferredCommands; /**< Commands that didn't fit in the queue, oldest first, message thread only. */
+    double outputSampleRate = 44100.0; /**< Sample rate of the audio device. */
+    std::atomic<int> expectedBlockSize{ 512 }; /**< Block size of the audio device, read by the loader thread. */
+    bool playing = false; /**< Whether the deck plays, only touched by the audio thread. */
+    bool keyLock = false; /**< Whether speed changes keep the pitch, only touched by the audio thread. */
+    double speed = 1.0; /**< Deck speed, only touched by the audio thread. */
+    float faderGain = 1.0f; /**< Gain set with setGain, only touched by the audio thread. */
+    float trimGain = 1.0f; /**< Loudness normalisation of the track, only touched by the audio thread. */
+    float userTrimGain = 1.0f; /**< Trim set with setTrim, only touched by the audio thread. */
+    TrackAnalysis beatgrid; /**< Tempo and grid of the loaded track, only touched by the audio thread. */
+    DJAudioPlayer *syncPartner = nullptr; /**< Deck followed with sync on. */
+    int syncOrder = 0; /**< When sync was turned on relative to the partner, 0 while off, only touched by the audio thread. */
+    bool following = false; /**< Whether the last block followed the partner, only touched by the audio thread. */
+    bool phaseLocked = false; /**< Whether the phase has been snapped since following began or the deck jumped. */
+    double syncSpeed = 1.0; /**< Speed while following, only touched by the audio thread. */
+    PhaseLock phaseLock; /**< Holds the beats on the partner's while following. */
+    BeatClock beatClock; /**< This deck's beat position at the start of the current block, read by the partner. */
+    float playGain = 0.0f; /**< Fade applied after a start or stop, only touched by the audio thread. */
+    double lastBlockStartMs = 0.0; /**< When the previous block started, commands sent since then land in this one. */
+    int64 framesRendered = 0; /**< Output frames rendered since the device started. */
+    bool offline = false; /**< Whether the deck is rendered offline, set once before anything is loaded. */
+
+    ThreadPool loaderPool{ 1 }; /**< Worker thread that opens and primes new tracks. */
+    ThreadPool cacheFillPool{ 1, 0, Thread::Priority::background }; /**< Worker thread that decodes stopped streamed tracks into the cache. */
+    File cacheFillFile; /**< Streamed track still to be decoded into the cache, message thread only. */
+    int cacheFillGeneration = -1; /**< Load generation the cache fill belongs to, message thread only. */
+    std::atomic<int> loadGeneration{ 0 }; /**< Incremented on every load so stale loads can be discarded. */
+    std::atomic<bool> loading{ false }; /**< True while a load is in progress. */
+
+    CriticalSection pendingLock; /**< Guards the pending track handed over by the loader thread. */
+    std::unique_ptr<DeckTrack> pendingTrack; /**< Track ready to be handed to the audio thread. */
+    int pendingGeneration = -1; /**< Load generation the pending track belongs to. */
+    File pendingCacheFill; /**< Streamed local file of the pending track, to be decoded into the cache later. */
+};
@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.cpp
+    Created: 17 Oct 2026 4:18:05pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Push commands from the message thread into a fixed ring - DONE
+ * 2. Peek and pop commands on the audio thread without waiting - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "DeckCommandQueue.h"
+
+DeckCommandQueue::DeckCommandQueue() {}
+
+bool DeckCommandQueue::push(const DeckCommand &command) {
+    const auto scope = fifo.write(1);
+
+    if (scope.blockSize1 > 0) {
+        commands[(size_t) scope.startIndex1] = command;
+        return true;
+    }
+    if (scope.blockSize2 > 0) {
+        commands[(size_t) scope.startIndex2] = command;
+        return true;
+    }
+    return false;
+}
+
+bool DeckCommandQueue::peek(DeckCommand &command) const {
+    if (fifo.getNumReady() <= 0) {
+        return false;
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+    command = commands[(size_t) (size1 > 0 ? start1 : start2)];
+    return true;
+}
+
+void DeckCommandQueue::pop() {
+    fifo.finishedRead(1);
+}
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    DeckCommandQueue.h
+    Created: 17 Oct 2026 4:18:05pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+using namespace juce;
+
+struct DeckTrack;
+
+/**
+ * @struct DeckCommand
+ * @brief A change to a deck, sent from the UI to the audio thread.
+ */
+struct DeckCommand {
+    /** What the command changes. */
+    enum class Type {
+        start, /**< Start playback. */
+        stop, /**< Pause playback. */
+        setGain, /**< Set the gain, value 0 to 1. */
+        setSpeed, /**< Set the speed ratio, value 0 to 100. */
+        setPosition, /**< Jump to a position, value in seconds. */
+        setPositionRelative, /**< Jump to a position, value 0 to 1 of the track length. */
+        setKeyLock, /**< Keep the pitch when the speed changes, value 1 for on and 0 for off. */
+        setResamplerQuality, /**< Choose the resampler's interpolation, value is a DeckResampler::Quality. */
+        setSync, /**< Follow the partner deck's tempo and beats, value is the order sync was turned on in, 0 for off. */
+        setTrim, /**< Trim on top of the track's loudness normalisation, value is a linear gain. */
+        loadTrack /**< Play a new track with its beatgrid, trim and start, given by track, always at the top of a block. */
+    };
+
+    Type type = Type::stop; /**< What the command changes. */
+    double value = 0.0; /**< The new value, unused for start and stop. */
+    double timestampMs = 0.0; /**< Time::getMillisecondCounterHiRes() when the command was sent. */
+    int64 frame = -1; /**< Output frame to apply the command at, or -1 to place it by its timestamp. */
+    DeckTrack *track = nullptr; /**< The track for loadTrack, still owned by the deck. */
+};
+
+/**
+ * @class DeckCommandQueue
+ * @brief Wait-free single-producer single-consumer queue of deck commands.
+ *
+ * The message thread pushes, the audio thread pops at the start of every block. Both sides only
+ * touch their own end of a fixed ring buffer, so neither ever waits for the other and nothing is
+ * allocated once the queue exists.
+ */
+class DeckCommandQueue {
+public:
+    /** Constructor. */
+    DeckCommandQueue();
+
+    /**
+     * @brief Add a command, only ever called from the message thread.
+     * @param command The command.
+     * @return False if the queue is full and the command was dropped.
+     */
+    bool push(const DeckCommand &command);
+
+    /**
+     * @brief Look at the oldest command without removing it, only ever called from the audio thread.
+     * @param command Receives the oldest command.
+     * @return False if the queue is empty.
+     */
+    bool peek(DeckCommand &command) const;
+
+    /** @brief Remove the oldest command, only ever called from the audio thread after peek(). */
+    void pop();
+
+private:
+    static constexpr int capacity = 256; /**< More than enough for a burst of slider moves within one block. */
+
+    AbstractFifo fifo{ capacity }; /**< Read and write positions of the ring. */
+    std::array<DeckCommand, capacity> commands; /**< The ring itself. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckCommandQueue)
+};
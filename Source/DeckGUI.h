@@ -1,115 +1,138 @@
-/*
-  ==============================================================================
-
-    DeckGUI.h
-    Created: 11 Jan 2024 9:26:59pm
-    Author:  JAMIUL ISLAM
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include "DJAudioPlayer.h"
-#include "WaveformDisplay.h"
-#include "PlaylistComponent.h"
-
-using namespace juce;
-
-/**
- * @class DeckGUI
- * @brief Represents the graphical user interface for controlling an audio deck.
- *
- * This class inherits from Component and implements Button::Listener, Slider::Listener,
- * TableListBoxModel, and Timer interfaces. It provides buttons for play, stop, and load,
- * sliders for volume, speed, and position, and displays information about the playlist and waveform.
- */
-class DeckGUI : public Component,
-                public Button::Listener,
-                public Slider::Listener,
-                public TableListBoxModel,
-                public Timer {
-public:
-    /**
-     * @brief Constructor.
-     * @param player Pointer to the DJAudioPlayer associated with the deck.
-     * @param playlistComponent Pointer to the PlaylistComponent associated with the deck.
-     * @param formatManagerToUse Reference to the audio format manager.
-     * @param cacheToUse Reference to the audio thumbnail cache.
-     * @param channelToUse Channel of the deck (0 for left, 1 for right).
-     */
-    DeckGUI(DJAudioPlayer* player, PlaylistComponent* playlistComponent, AudioFormatManager& formatManagerToUse, AudioThumbnailCache& cacheToUse, int channelToUse);
-
-    /** Destructor. */
-    ~DeckGUI();
-
-    /** @internal */
-    void paint(Graphics &) override;
-    /** @internal */
-    void resized() override;
-
-    /** @internal */
-    void buttonClicked(Button *) override;
-    /** @internal */
-    void sliderValueChanged(Slider *slider) override;
-
-    /**
-     * @brief Get the number of rows in the current table.
-     * @return The number of rows in the table.
-     */
-    int getNumRows() override;
-
-    /**
-     * @brief Paint the background of each row in the table.
-     * @param g The Graphics context.
-     * @param rowNumber The row number.
-     * @param width The width of the row.
-     * @param height The height of the row.
-     * @param rowIsSelected Whether the row is selected.
-     */
-    void paintRowBackground(Graphics&, int rowNumber, int width, int height, bool rowIsSelected) override;
-
-    /**
-     * @brief Paint the cells in the table.
-     * @param g The Graphics context.
-     * @param rowNumber The row number.
-     * @param columnId The column ID.
-     * @param width The width of the cell.
-     * @param height The height of the cell.
-     * @param rowIsSelected Whether the row is selected.
-     */
-    void paintCell(Graphics&, int rowNumber, int columnId, int width, int height, bool rowIsSelected) override;
-
-    /** @internal */
-    void timerCallback() override;
-
-private:
-    // Buttons for play, stop, next
-    TextButton playButton{ "PLAY" };
-    TextButton stopButton{ "PAUSE" };
-    TextButton nextButton{ "LOAD" };
-
-    // Sliders for volume, speed, position
-    Slider volSlider;
-    Slider speedSlider;
-    Slider posSlider;
-
-    // Labels for volume and speed
-    Label volLabel;
-    Label speedLabel;
-
-    // Visual theme
-    LookAndFeel_V4 lookandfeel;
-
-    // Variables for player, playlist, waveform
-    DJAudioPlayer* player;
-    PlaylistComponent* playlistComponent;
-    WaveformDisplay waveformDisplay;
-    TableListBox upNext;
-
-    // Variable for channel (0=left, 1=right)
-    int channel;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckGUI)
-};
+/*
+  ==============================================================================
+
+    DeckGUI.h
+    Created: 11 Jan 2024 9:26:59pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include "WaveformDisplay.h"
+#include "PlaylistComponent.h"
+
+using namespace juce;
+
+/**
+ * @class DeckGUI
+ * @brief Represents the graphical user interface for controlling an audio deck.
+ *
+ * This class inherits from Component and implements Button::Listener, Slider::Listener,
+ * TableListBoxModel, Timer, and ChangeListener interfaces. It provides buttons for play, stop, and load,
+ * sliders for volume, speed, and position, and displays information about the playlist and waveform.
+ *
+ * The playhead is moved on every display refresh, from the position the player publishes per audio
+ * block. The timer only takes over on systems where no refresh callbacks arrive.
+ */
+class DeckGUI : public Component,
+                public Button::Listener,
+                public Slider::Listener,
+                public TableListBoxModel,
+                public Timer,
+                public ChangeListener {
+public:
+    /**
+     * @brief Constructor.
+     * @param player Pointer to the DJAudioPlayer associated with the deck.
+     * @param playlistComponent Pointer to the PlaylistComponent associated with the deck.
+     * @param formatManagerToUse Reference to the audio format manager.
+     * @param cacheToUse Reference to the disk-backed waveform thumbnail cache.
+     * @param trackCacheToUse Reference to the decoded track cache.
+     * @param channelToUse Channel of the deck (0 for left, 1 for right).
+     */
+    DeckGUI(DJAudioPlayer* player, PlaylistComponent* playlistComponent, AudioFormatManager& formatManagerToUse, DiskThumbnailCache& cacheToUse, DecodedTrackCache& trackCacheToUse, int channelToUse);
+
+    /** Destructor. */
+    ~DeckGUI();
+
+    /** @internal */
+    void paint(Graphics &) override;
+    /** @internal */
+    void resized() override;
+
+    /** @internal */
+    void buttonClicked(Button *) override;
+    /** @internal */
+    void sliderValueChanged(Slider *slider) override;
+
+    /**
+     * @brief Get the number of rows in the current table.
+     * @return The number of rows in the table.
+     */
+    int getNumRows() override;
+
+    /**
+     * @brief Paint the background of each row in the table.
+     * @param g The Graphics context.
+     * @param rowNumber The row number.
+     * @param width The width of the row.
+     * @param height The height of the row.
+     * @param rowIsSelected Whether the row is selected.
+     */
+    void paintRowBackground(Graphics&, int rowNumber, int width, int height, bool rowIsSelected) override;
+
+    /**
+     * @brief Paint the cells in the table.
+     * @param g The Graphics context.
+     * @param rowNumber The row number.
+     * @param columnId The column ID.
+     * @param width The width of the cell.
+     * @param height The height of the cell.
+     * @param rowIsSelected Whether the row is selected.
+     */
+    void paintCell(Graphics&, int rowNumber, int columnId, int width, int height, bool rowIsSelected) override;
+
+    /** @internal Fallback for updatePlayhead() when no display refresh callbacks arrive. */
+    void timerCallback() override;
+
+    /**
+     * @brief Called when the player starts or finishes loading a track.
+     * @param source The ChangeBroadcaster triggering the change.
+     */
+    void changeListenerCallback(ChangeBroadcaster *source) override;
+
+private:
+    /** Move the playhead to the player's extrapolated position, called once per display refresh. */
+    void updatePlayhead();
+
+    // Buttons for play, stop, next
+    TextButton playButton{ "PLAY" };
+    TextButton stopButton{ "PAUSE" };
+    TextButton nextButton{ "LOAD" };
+    ToggleButton keyLockButton{ "Key Lock" };
+    ToggleButton syncButton{ "Sync" };
+
+    // Sliders for volume, speed, position
+    Slider volSlider;
+    Slider speedSlider;
+    Slider posSlider;
+
+    // Labels for volume and speed
+    Label volLabel;
+    Label speedLabel;
+
+    // Visual theme
+    LookAndFeel_V4 lookandfeel;
+
+    // Variables for player, playlist, waveform
+    DJAudioPlayer* player;
+    PlaylistComponent* playlistComponent;
+    WaveformDisplay waveformDisplay;
+    TableListBox upNext;
+
+    // Variable for channel (0=left, 1=right)
+    int channel;
+
+    // Display refresh callbacks driving the playhead
+    double lastVBlankMs = 0.0;
+    VBlankAttachment vblankAttachment{ this, [this] {
+        lastVBlankMs = Time::getMillisecondCounterHiRes();
+        updatePlayhead();
+    } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DeckGUI)
+};
@@ -0,0 +1,293 @@
+/*
+  ==============================================================================
+
+    DeckResampler.cpp
+    Created: 17 Oct 2026 6:02:37pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Build Kaiser-windowed sinc tables for a few cutoffs, shared by all decks - DONE
+ * 2. Pull the input in fixed chunks, keeping the history the filters need - DONE
+ * 3. Interpolate with linear, cubic or polyphase sinc filters - DONE
+ * 4. Vectorise the dot products and the coefficient interpolation - DONE
+ * 5. Report how much input is buffered ahead of the read position - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "DeckResampler.h"
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#elif JUCE_ARM && defined(__ARM_NEON)
+ #include <arm_neon.h>
+#endif
+
+namespace {
+    /** Width of the sinc filter's transition band, in cycles per input sample. */
+    constexpr double transitionWidth = 0.07;
+
+    /** Kaiser window shape, about 70 dB of stopband attenuation. */
+    constexpr double kaiserBeta = 7.0;
+
+    /** Zeroth-order modified Bessel function of the first kind, for the Kaiser window. */
+    double besselI0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 50 && term > sum * 1.0e-12; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+}
+
+DeckResampler::SincTables::SincTables() {
+    const int tableSize = (numPhases + 1) * numTaps;
+    coefficients.resize((size_t) (numCutoffs * tableSize));
+
+    for (int cutoffIndex = 0; cutoffIndex < numCutoffs; ++cutoffIndex) {
+        // the passband shrinks with the ratio, the transition band stays as wide
+        const double bandFraction = std::pow(2.0, -cutoffIndex / 4.0);
+        const double cutoff = 0.5 * bandFraction - 0.5 * transitionWidth;
+
+        for (int phase = 0; phase <= numPhases; ++phase) {
+            float *row = coefficients.data() + cutoffIndex * tableSize + phase * numTaps;
+            double sum = 0.0;
+
+            for (int tap = 0; tap < numTaps; ++tap) {
+                // distance of this tap from the interpolated position
+                const double t = (double) (tap - (halfTaps - 1)) - (double) phase / numPhases;
+                const double x = 2.0 * cutoff * t;
+                const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(MathConstants<double>::pi * x) / (MathConstants<double>::pi * x);
+                const double edge = jlimit(0.0, 1.0, 1.0 - (t / halfTaps) * (t / halfTaps));
+                const double value = 2.0 * cutoff * sinc * besselI0(kaiserBeta * std::sqrt(edge)) / besselI0(kaiserBeta);
+                row[tap] = (float) value;
+                sum += value;
+            }
+
+            // every phase passes DC at exactly unity gain, so the level doesn't ripple with the position
+            for (int tap = 0; tap < numTaps; ++tap) {
+                row[tap] = (float) (row[tap] / sum);
+            }
+        }
+    }
+}
+
+const float *DeckResampler::SincTables::getTable(double ratio) const {
+    // the highest cutoff at or below the output Nyquist, relative to the input
+    const int cutoffIndex = ratio <= 1.0 ? 0 : jmin(numCutoffs - 1, (int) std::ceil(4.0 * std::log2(ratio) - 1.0e-9));
+    return coefficients.data() + cutoffIndex * (numPhases + 1) * numTaps;
+}
+
+const DeckResampler::SincTables &DeckResampler::getSincTables() {
+    static const SincTables tables;
+    return tables;
+}
+
+DeckResampler::DeckResampler(AudioSource *_input) : input(_input) {}
+
+DeckResampler::~DeckResampler() {}
+
+void DeckResampler::setInput(AudioSource *newInput) {
+    if (input != newInput) {
+        input = newInput;
+        reset();
+    }
+}
+
+void DeckResampler::setRatio(double newRatio) {
+    ratio = jlimit(1.0 / 16.0, 16.0, newRatio);
+}
+
+void DeckResampler::setQuality(Quality newQuality) {
+    quality = newQuality; // every tier reads around the same position, so no reset is needed
+}
+
+DeckResampler::Quality DeckResampler::getQuality() const {
+    return quality;
+}
+
+void DeckResampler::reset() {
+    // start with silent history, so the first input sample is played at the read position
+    inputBuffer.clear();
+    numBuffered = halfTaps - 1;
+    position = halfTaps - 1;
+}
+
+double DeckResampler::getBufferedInput() const {
+    return numBuffered - position;
+}
+
+void DeckResampler::prepareToPlay(int, double) {
+    sincTables = &getSincTables();
+
+    // history and lookahead of the widest filter around the read position, plus one pull
+    inputBuffer.setSize(numChannels, numTaps + pullSize);
+    reset();
+}
+
+void DeckResampler::releaseResources() {
+    inputBuffer.setSize(0, 0);
+    numBuffered = 0;
+}
+
+void DeckResampler::getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) {
+    if (inputBuffer.getNumSamples() == 0) {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    int done = render(bufferToFill, 0);
+    while (done < bufferToFill.numSamples) {
+        pullInput();
+        done = render(bufferToFill, done);
+    }
+
+    // any channels beyond stereo get a copy of the matching stereo channel
+    for (int channel = numChannels; channel < bufferToFill.buffer->getNumChannels(); ++channel) {
+        bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample, *bufferToFill.buffer,
+                                      channel % numChannels, bufferToFill.startSample, bufferToFill.numSamples);
+    }
+}
+
+void DeckResampler::pullInput() {
+    // keep the history the next output sample still needs, moved to the front
+    const int keepFrom = (int) position - (halfTaps - 1);
+    if (keepFrom > 0) {
+        const int numToKeep = numBuffered - keepFrom;
+        jassert(numToKeep >= 0); // a ratio of at most 16 never skips past the buffered input
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+            float *samples = inputBuffer.getWritePointer(channel);
+            std::memmove(samples, samples + keepFrom, sizeof(float) * (size_t) numToKeep);
+        }
+
+        numBuffered = numToKeep;
+        position -= keepFrom;
+    }
+
+    AudioSourceChannelInfo info(&inputBuffer, numBuffered, pullSize);
+    input->getNextAudioBlock(info);
+    numBuffered += pullSize;
+}
+
+int DeckResampler::render(const AudioSourceChannelInfo &bufferToFill, int offset) {
+    const int numOutputChannels = jmin(numChannels, bufferToFill.buffer->getNumChannels());
+    float *dest[numChannels] = {};
+    for (int channel = 0; channel < numOutputChannels; ++channel) {
+        dest[channel] = bufferToFill.buffer->getWritePointer(channel, bufferToFill.startSample);
+    }
+
+    const float *source[numChannels] = { inputBuffer.getReadPointer(0), inputBuffer.getReadPointer(1) };
+    const float *table = quality == Quality::sinc ? sincTables->getTable(ratio) : nullptr;
+    int done = offset;
+
+    for (; done < bufferToFill.numSamples; ++done) {
+        const int index = (int) position;
+        if (index + halfTaps >= numBuffered) {
+            break; // every tier waits for the sinc filter's lookahead, so switching tiers can't starve
+        }
+
+        const float fraction = (float) (position - index);
+
+        switch (quality) {
+            case Quality::linear:
+                for (int channel = 0; channel < numOutputChannels; ++channel) {
+                    const float *x = source[channel] + index;
+                    dest[channel][done] = x[0] + fraction * (x[1] - x[0]);
+                }
+                break;
+
+            case Quality::cubic: {
+                // Catmull-Rom weights for the samples before, at, after and two after the position
+                const float f2 = fraction * fraction, f3 = f2 * fraction;
+                alignas(16) const float weights[4] = { -0.5f * f3 + f2 - 0.5f * fraction,
+                                                       1.5f * f3 - 2.5f * f2 + 1.0f,
+                                                       -1.5f * f3 + 2.0f * f2 + 0.5f * fraction,
+                                                       0.5f * f3 - 0.5f * f2 };
+
+                for (int channel = 0; channel < numOutputChannels; ++channel) {
+                    dest[channel][done] = dot(source[channel] + index - 1, weights, 4);
+                }
+                break;
+            }
+
+            case Quality::sinc: {
+                const float phasePosition = fraction * (float) numPhases;
+                const int phase = jmin(numPhases - 1, (int) phasePosition);
+                const float *row = table + phase * numTaps;
+                interpolateCoefficients(row, row + numTaps, phasePosition - (float) phase, coefficientScratch);
+
+                for (int channel = 0; channel < numOutputChannels; ++channel) {
+                    dest[channel][done] = dot(source[channel] + index - (halfTaps - 1), coefficientScratch, numTaps);
+                }
+                break;
+            }
+        }
+
+        position += ratio;
+    }
+
+    return done;
+}
+
+void DeckResampler::interpolateCoefficients(const float *phase, const float *nextPhase, float fraction, float *dest) {
+    int i = 0;
+
+#if JUCE_INTEL
+    const __m128 amount = _mm_set1_ps(fraction);
+
+    for (; i + 4 <= numTaps; i += 4) {
+        const __m128 a = _mm_loadu_ps(phase + i);
+        _mm_storeu_ps(dest + i, _mm_add_ps(a, _mm_mul_ps(amount, _mm_sub_ps(_mm_loadu_ps(nextPhase + i), a))));
+    }
+#elif JUCE_ARM && defined(__ARM_NEON)
+    const float32x4_t amount = vdupq_n_f32(fraction);
+
+    for (; i + 4 <= numTaps; i += 4) {
+        const float32x4_t a = vld1q_f32(phase + i);
+        vst1q_f32(dest + i, vmlaq_f32(a, amount, vsubq_f32(vld1q_f32(nextPhase + i), a)));
+    }
+#endif
+
+    // the tail, or everything without SIMD
+    for (; i < numTaps; ++i) {
+        dest[i] = phase[i] + fraction * (nextPhase[i] - phase[i]);
+    }
+}
+
+float DeckResampler::dot(const float *a, const float *b, int numSamples) {
+    float sum = 0.0f;
+    int i = 0;
+
+#if JUCE_INTEL
+    __m128 products = _mm_setzero_ps();
+
+    for (; i + 4 <= numSamples; i += 4) {
+        products = _mm_add_ps(products, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, products);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif JUCE_ARM && defined(__ARM_NEON)
+    float32x4_t products = vdupq_n_f32(0.0f);
+
+    for (; i + 4 <= numSamples; i += 4) {
+        products = vmlaq_f32(products, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+
+    float lanes[4];
+    vst1q_f32(lanes, products);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+    // the tail, or everything without SIMD
+    for (; i < numSamples; ++i) {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+}
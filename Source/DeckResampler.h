@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    DeckResampler.h
+    Created: 17 Oct 2026 6:02:37pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+using namespace juce;
+
+/**
+ * @class DeckResampler
+ * @brief Converts a deck from the track's sample rate to the device's, including the speed, in one pass.
+ *
+ * The ratio is the number of input samples consumed per output sample, so the sample rate
+ * correction and the deck speed are folded into a single interpolation instead of two.
+ * Three quality tiers trade CPU for aliasing:
+ *   - linear: two taps, the cheapest and the most aliasing;
+ *   - cubic: four-tap Catmull-Rom, applied as one SIMD dot product per channel;
+ *   - sinc: 64-tap Kaiser-windowed sinc from a 256-phase polyphase table, with the coefficients
+ *     interpolated between neighbouring phases. When the ratio is above 1 the table with a
+ *     lower cutoff is used, so speeding up doesn't fold content above the output Nyquist back down.
+ *
+ * All tiers are centred on the interpolated position, so switching between them doesn't shift
+ * the timing. The input is pulled in fixed chunks into a buffer allocated in prepareToPlay.
+ */
+class DeckResampler : public AudioSource {
+public:
+    /** The interpolation used, from the cheapest to the cleanest. */
+    enum class Quality {
+        linear, /**< Two-point linear interpolation. */
+        cubic, /**< Four-point Catmull-Rom interpolation. */
+        sinc /**< Windowed-sinc polyphase filter. */
+    };
+
+    /**
+     * @brief Constructor.
+     * @param input The source to resample, which must outlive this object.
+     */
+    DeckResampler(AudioSource *input);
+
+    /** Destructor. */
+    ~DeckResampler() override;
+
+    /**
+     * @brief Change the source to resample, only from the audio thread. Buffered input is dropped.
+     * @param newInput The new source, which must outlive this object.
+     */
+    void setInput(AudioSource *newInput);
+
+    /**
+     * @brief Set how many input samples are consumed per output sample, only from the audio thread.
+     * @param newRatio The ratio, limited to 1/16 to 16.
+     */
+    void setRatio(double newRatio);
+
+    /**
+     * @brief Choose the interpolation, only from the audio thread.
+     * @param newQuality The quality tier.
+     */
+    void setQuality(Quality newQuality);
+
+    /** @brief Get the interpolation in use. */
+    Quality getQuality() const;
+
+    /** @brief Forget all buffered input, e.g. after a jump in the input, only from the audio thread. */
+    void reset();
+
+    /**
+     * @brief Get how far the input has been pulled ahead of what is being played, only from the audio thread.
+     * @return The number of input samples buffered past the read position.
+     */
+    double getBufferedInput() const;
+
+    /**
+     * @brief Allocate the input buffer and build the sinc tables the first time.
+     * @param samplesPerBlockExpected The number of samples per block expected.
+     * @param sampleRate The sample rate of the audio.
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /**
+     * @brief Render resampled audio.
+     * @param bufferToFill The buffer to fill with audio data.
+     */
+    void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override;
+
+    /** Release the input buffer. */
+    void releaseResources() override;
+
+    static constexpr int numTaps = 64; /**< Taps of the sinc filter. */
+    static constexpr int numPhases = 256; /**< Fractional positions the sinc table holds coefficients for. */
+
+private:
+    /**
+     * @struct SincTables
+     * @brief Polyphase coefficients for a few cutoffs, built once and shared by every deck.
+     */
+    struct SincTables {
+        static constexpr int numCutoffs = 9; /**< Cutoffs from the full band down to a quarter, a quarter octave apart. */
+
+        SincTables();
+
+        /** Get the table for the highest cutoff that doesn't alias at a ratio. */
+        const float *getTable(double ratio) const;
+
+        std::vector<float> coefficients; /**< numCutoffs tables of numPhases + 1 rows of numTaps. */
+    };
+
+    /** Get the shared sinc tables, built on first use. */
+    static const SincTables &getSincTables();
+
+    /** Drop input the interpolation no longer needs and pull the next chunk. */
+    void pullInput();
+
+    /** Interpolate output samples until the block is full or the buffered input runs out. */
+    int render(const AudioSourceChannelInfo &bufferToFill, int offset);
+
+    /** Interpolate the sinc coefficients between two neighbouring phases. */
+    static void interpolateCoefficients(const float *phase, const float *nextPhase, float fraction, float *dest);
+
+    /** Get the dot product of two blocks. */
+    static float dot(const float *a, const float *b, int numSamples);
+
+    static constexpr int numChannels = 2; /**< Decks play in stereo. */
+    static constexpr int halfTaps = numTaps / 2; /**< Taps on each side of the interpolated position. */
+    static constexpr int pullSize = 256; /**< Input samples pulled from the source at a time. */
+
+    AudioSource *input; /**< The source being resampled. */
+    double ratio = 1.0; /**< Input samples consumed per output sample. */
+    Quality quality = Quality::sinc; /**< The interpolation in use. */
+    const SincTables *sincTables = nullptr; /**< The shared sinc tables, set in prepareToPlay. */
+
+    AudioBuffer<float> inputBuffer; /**< Buffered input, with history before the read position. */
+    int numBuffered = 0; /**< Number of valid samples in the input buffer. */
+    double position = 0.0; /**< Fractional read position within the input buffer. */
+    alignas(16) float coefficientScratch[numTaps] = {}; /**< Interpolated sinc coefficients for one output sample. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckResampler)
+};
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    DeckTransport.cpp
+    Created: 17 Oct 2026 11:20:15pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Swap sources on the audio thread without a lock - DONE
+ * 2. Keep the position and the length here instead of asking the source - DONE
+ * 3. Stop at the end of the track without a change message - DONE
+ * 4. Ramp the gain across each block - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "DeckTransport.h"
+
+DeckTransport::DeckTransport() {}
+
+DeckTransport::~DeckTransport() {}
+
+void DeckTransport::setSource(PositionableAudioSource *newSource) {
+    source = newSource;
+    length = source != nullptr ? source->getTotalLength() : 0;
+    setPosition(0);
+}
+
+void DeckTransport::setPosition(int64 newPosition) {
+    position = jlimit((int64) 0, length, newPosition);
+    if (source != nullptr) {
+        source->setNextReadPosition(position);
+    }
+}
+
+int64 DeckTransport::getPosition() const {
+    return position;
+}
+
+int64 DeckTransport::getLength() const {
+    return length;
+}
+
+bool DeckTransport::hasFinished() const {
+    return position >= length;
+}
+
+void DeckTransport::setGain(float newGain) {
+    gain = newGain;
+}
+
+void DeckTransport::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    if (source != nullptr) {
+        source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+    }
+    lastGain = gain;
+}
+
+void DeckTransport::releaseResources() {
+    if (source != nullptr) {
+        source->releaseResources();
+    }
+}
+
+void DeckTransport::getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) {
+    if (hasFinished()) {
+        bufferToFill.clearActiveBufferRegion();
+        lastGain = gain;
+        return;
+    }
+
+    // every source clears what lies past its end, so the last block can be read whole
+    source->getNextAudioBlock(bufferToFill);
+    position = jmin(length, position + bufferToFill.numSamples);
+
+    if (lastGain != gain) {
+        bufferToFill.buffer->applyGainRamp(bufferToFill.startSample, bufferToFill.numSamples, lastGain, gain);
+    } else if (gain != 1.0f) {
+        bufferToFill.buffer->applyGain(bufferToFill.startSample, bufferToFill.numSamples, gain);
+    }
+    lastGain = gain;
+}
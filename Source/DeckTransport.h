@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    DeckTransport.h
+    Created: 17 Oct 2026 11:20:15pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+/**
+ * @struct DeckTrack
+ * @brief A track ready to play, handed from the deck's loader to the audio thread in one piece.
+ *
+ * The deck owns it on the message thread and only frees it once the audio thread has moved on to
+ * a newer track.
+ */
+struct DeckTrack {
+    std::unique_ptr<PositionableAudioSource> source; /**< The source, already prepared. */
+    double sampleRate = 0.0; /**< Sample rate of the source. */
+    int generation = 0; /**< The load it came from, newer loads have higher generations. */
+    double bpm = 0.0; /**< Tempo from the track's analysis, 0 if unknown. */
+    double firstBeatSeconds = 0.0; /**< Start of the beatgrid in seconds. */
+    float trimGain = 1.0f; /**< Loudness normalisation, 1 for an unmeasured track. */
+    bool playWhenReady = false; /**< Whether the deck plays as soon as the track is swapped in. */
+};
+
+/**
+ * @class DeckTransport
+ * @brief Plays the deck's current track from the audio thread, without locks.
+ *
+ * Takes the place of juce::AudioTransportSource on the deck's audio path. That class guards its
+ * source with a lock it takes on every block and every position query, and sends a change message
+ * from the audio thread when a track ends. Here everything but construction happens on the audio
+ * thread, or while it is stopped, so nothing needs a lock: the deck swaps sources in at the top of
+ * a block, the position and length are kept here instead of being asked from the source, and the
+ * end of the track is a flag the deck reads.
+ *
+ * Sources are prepared before they are handed over, and their owner frees them off the audio thread.
+ */
+class DeckTransport : public AudioSource {
+public:
+    /** Constructor. */
+    DeckTransport();
+
+    /** Destructor. */
+    ~DeckTransport() override;
+
+    /**
+     * @brief Play a new source from its start, only on the audio thread.
+     * @param newSource The prepared source, or nullptr for silence.
+     */
+    void setSource(PositionableAudioSource *newSource);
+
+    /**
+     * @brief Move the playhead, only on the audio thread.
+     * @param newPosition The position in samples of the source.
+     */
+    void setPosition(int64 newPosition);
+
+    /**
+     * @brief Get the position of the next sample to be read, only on the audio thread.
+     * @return The position in samples of the source.
+     */
+    int64 getPosition() const;
+
+    /**
+     * @brief Get the length of the source, only on the audio thread.
+     * @return The length in samples, 0 without a source.
+     */
+    int64 getLength() const;
+
+    /**
+     * @brief Check whether the playhead has reached the end of the source, only on the audio thread.
+     * @return True at the end of the track or without a source.
+     */
+    bool hasFinished() const;
+
+    /**
+     * @brief Set the gain, ramped to over the next block, only on the audio thread.
+     * @param newGain The linear gain.
+     */
+    void setGain(float newGain);
+
+    /**
+     * @brief Prepare the current source again, e.g. after the device restarted.
+     * @param samplesPerBlockExpected The number of samples per block expected.
+     * @param sampleRate The sample rate of the device.
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /** Release the resources of the current source. */
+    void releaseResources() override;
+
+    /**
+     * @brief Read the next block from the source and apply the gain.
+     * @param bufferToFill The buffer to fill with audio data.
+     */
+    void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override;
+
+private:
+    PositionableAudioSource *source = nullptr; /**< The source being played, owned by the deck. */
+    int64 position = 0; /**< Position of the next sample to read. */
+    int64 length = 0; /**< Length of the source, read once when it is set. */
+    float gain = 1.0f; /**< Gain to reach by the end of the next block. */
+    float lastGain = 1.0f; /**< Gain at the end of the previous block. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DeckTransport)
+};
@@ -0,0 +1,120 @@
+/*
+  ==============================================================================
+
+    DecodedTrackCache.cpp
+    Created: 17 Oct 2026 11:03:52am
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Key tracks by file path and modification time - DONE
+ * 2. Look up tracks and keep them in least recently used order - DONE
+ * 3. Decode whole files in the background and insert them - DONE
+ * 4. Evict least recently used tracks to stay within the budget - DONE
+ * 5. Size the default budget from the machine's memory - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "DecodedTrackCache.h"
+
+DecodedTrackCache::DecodedTrackCache(int64 maxBytes) : memoryBudget(maxBytes) {}
+
+DecodedTrackCache::~DecodedTrackCache() {}
+
+int64 DecodedTrackCache::getDefaultMemoryBudget() {
+    // an eighth of the physical memory, a 10 minute stereo track takes about 200 MB
+    const int64 megabytes = jlimit((int64) 256, (int64) 4096, (int64) SystemStats::getMemorySizeInMegabytes() / 8);
+    return megabytes * 1024 * 1024;
+}
+
+void DecodedTrackCache::setMemoryBudget(int64 maxBytes) {
+    const ScopedLock sl(lock);
+    memoryBudget = maxBytes;
+    evictToBudget();
+}
+
+int64 DecodedTrackCache::getMemoryBudget() const {
+    const ScopedLock sl(lock);
+    return memoryBudget;
+}
+
+int64 DecodedTrackCache::getMemoryUsed() const {
+    const ScopedLock sl(lock);
+    return memoryUsed;
+}
+
+std::shared_ptr<const DecodedTrack> DecodedTrackCache::find(const File &file) {
+    const String key = makeKey(file);
+    const ScopedLock sl(lock);
+
+    auto found = index.find(key);
+    if (found == index.end()) {
+        return nullptr;
+    }
+
+    // move the entry to the front, it is now the most recently used one
+    entries.splice(entries.begin(), entries, found->second);
+    return found->second->track;
+}
+
+std::shared_ptr<const DecodedTrack> DecodedTrackCache::decodeAndInsert(const File &file,
+                                                                       AudioFormatManager &formatManager,
+                                                                       const std::function<bool()> &shouldAbort) {
+    if (auto existing = find(file)) {
+        return existing; // the other deck got there first
+    }
+
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0) {
+        return nullptr;
+    }
+
+    const int numChannels = (int) jmax(1u, reader->numChannels);
+    const int64 numBytes = reader->lengthInSamples * numChannels * (int64) sizeof(float);
+
+    if (numBytes > getMemoryBudget() || reader->lengthInSamples > std::numeric_limits<int>::max()) {
+        return nullptr; // would evict everything else, keep streaming this one instead
+    }
+
+    auto track = std::make_shared<DecodedTrack>();
+    track->samples.setSize(numChannels, (int) reader->lengthInSamples);
+    track->sampleRate = reader->sampleRate;
+
+    // decode in chunks so a new load can cancel us quickly
+    const int chunkSize = 65536;
+    for (int start = 0; start < track->samples.getNumSamples(); start += chunkSize) {
+        if (shouldAbort()) {
+            return nullptr;
+        }
+
+        const int numToRead = jmin(chunkSize, track->samples.getNumSamples() - start);
+        reader->read(&track->samples, start, numToRead, start, true, true);
+    }
+
+    const String key = makeKey(file);
+    const ScopedLock sl(lock);
+
+    if (index.find(key) == index.end()) {
+        entries.push_front({ key, track, numBytes });
+        index[key] = entries.begin();
+        memoryUsed += numBytes;
+        evictToBudget();
+    }
+
+    return track;
+}
+
+String DecodedTrackCache::makeKey(const File &file) {
+    return file.getFullPathName() + "|" + String(file.getLastModificationTime().toMilliseconds());
+}
+
+void DecodedTrackCache::evictToBudget() {
+    while (memoryUsed > memoryBudget && !entries.empty()) {
+        // drop the least recently used entry, decks still playing it keep their own reference
+        memoryUsed -= entries.back().numBytes;
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
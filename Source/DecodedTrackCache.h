@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    DecodedTrackCache.h
+    Created: 17 Oct 2026 11:03:52am
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+
+using namespace juce;
+
+/**
+ * @struct DecodedTrack
+ * @brief A fully decoded track held in memory.
+ */
+struct DecodedTrack {
+    AudioBuffer<float> samples; /**< The decoded PCM data. */
+    double sampleRate = 0.0; /**< The sample rate of the decoded data. */
+};
+
+/**
+ * @class DecodedTrackCache
+ * @brief Process-wide cache of fully decoded tracks with a memory budget and LRU eviction.
+ *
+ * Tracks are keyed by file path and modification time, so an edited file is decoded again.
+ * Entries are shared as immutable buffers: every deck and display that uses a cached track
+ * refers to the same samples without copying them. Evicting an entry only drops the cache's
+ * reference; decks still playing it keep it alive until they load something else.
+ * All methods are thread-safe.
+ */
+class DecodedTrackCache {
+public:
+    /**
+     * @brief Constructor.
+     * @param maxBytes The memory budget for decoded samples.
+     */
+    explicit DecodedTrackCache(int64 maxBytes);
+
+    /** Destructor. */
+    ~DecodedTrackCache();
+
+    /**
+     * @brief Get a budget that suits the machine: an eighth of its memory, between 256 MB and 4 GB.
+     * @return The memory budget in bytes.
+     */
+    static int64 getDefaultMemoryBudget();
+
+    /**
+     * @brief Set the memory budget, evicting the least recently used tracks if needed.
+     * @param maxBytes The memory budget for decoded samples.
+     */
+    void setMemoryBudget(int64 maxBytes);
+
+    /**
+     * @brief Get the memory budget.
+     * @return The memory budget in bytes.
+     */
+    int64 getMemoryBudget() const;
+
+    /**
+     * @brief Get the memory currently held by the cache.
+     * @return The size of all cached tracks in bytes.
+     */
+    int64 getMemoryUsed() const;
+
+    /**
+     * @brief Look up a track and mark it as most recently used.
+     * @param file The audio file.
+     * @return The decoded track, or nullptr if it is not cached.
+     */
+    std::shared_ptr<const DecodedTrack> find(const File &file);
+
+    /**
+     * @brief Decode a whole file and add it to the cache.
+     *
+     * This is slow and is meant to be called from a background thread. Files that don't fit
+     * in the budget are not decoded.
+     *
+     * @param file The audio file.
+     * @param formatManager The format manager used to open the file.
+     * @param shouldAbort Polled between chunks, decoding stops when it returns true.
+     * @return The decoded track, or nullptr if it could not be decoded or was aborted.
+     */
+    std::shared_ptr<const DecodedTrack> decodeAndInsert(const File &file, AudioFormatManager &formatManager,
+                                                        const std::function<bool()> &shouldAbort);
+
+private:
+    /** A cached track and its size. */
+    struct Entry {
+        String key; /**< Path and modification time of the file. */
+        std::shared_ptr<const DecodedTrack> track; /**< The decoded samples. */
+        int64 numBytes; /**< Size of the decoded samples. */
+    };
+
+    /** Build the key for a file from its path and modification time. */
+    static String makeKey(const File &file);
+
+    /** Drop least recently used entries until the cache fits the budget. Caller holds the lock. */
+    void evictToBudget();
+
+    CriticalSection lock; /**< Guards everything below. */
+    std::list<Entry> entries; /**< Entries, most recently used first. */
+    std::map<String, std::list<Entry>::iterator> index; /**< Key to entry lookup. */
+    int64 memoryBudget; /**< Maximum number of bytes to keep. */
+    int64 memoryUsed = 0; /**< Bytes currently held. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodedTrackCache)
+};
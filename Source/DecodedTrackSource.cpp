@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    DecodedTrackSource.cpp
+    Created: 17 Oct 2026 11:20:05am
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Copy blocks out of the shared decoded buffer - DONE
+ * 2. Handle mono tracks and the end of the track - DONE
+ * 3. Support positioning and looping - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "DecodedTrackSource.h"
+
+DecodedTrackSource::DecodedTrackSource(std::shared_ptr<const DecodedTrack> _track) : track(std::move(_track)) {
+    jassert(track != nullptr);
+}
+
+DecodedTrackSource::~DecodedTrackSource() {}
+
+void DecodedTrackSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {}
+
+void DecodedTrackSource::releaseResources() {}
+
+void DecodedTrackSource::getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) {
+    const AudioBuffer<float> &samples = track->samples;
+    const int totalLength = samples.getNumSamples();
+    int64 pos = nextPlayPos.load();
+    int samplesDone = 0;
+
+    while (samplesDone < bufferToFill.numSamples) {
+        if (looping && totalLength > 0) {
+            pos %= totalLength;
+        }
+
+        const int numToCopy = (int) jlimit((int64) 0, (int64) (bufferToFill.numSamples - samplesDone),
+                                           (int64) totalLength - pos);
+        if (numToCopy <= 0) {
+            // past the end of the track, the rest of the block is silent
+            bufferToFill.buffer->clear(bufferToFill.startSample + samplesDone, bufferToFill.numSamples - samplesDone);
+            break;
+        }
+
+        for (int chan = 0; chan < bufferToFill.buffer->getNumChannels(); ++chan) {
+            // mono tracks feed every output channel
+            bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + samplesDone,
+                                          samples, jmin(chan, samples.getNumChannels() - 1), (int) pos, numToCopy);
+        }
+
+        samplesDone += numToCopy;
+        pos += numToCopy;
+    }
+
+    nextPlayPos = nextPlayPos.load() + bufferToFill.numSamples;
+}
+
+void DecodedTrackSource::setNextReadPosition(int64 newPosition) {
+    nextPlayPos = newPosition;
+}
+
+int64 DecodedTrackSource::getNextReadPosition() const {
+    const int64 pos = nextPlayPos.load();
+    const int64 totalLength = getTotalLength();
+
+    return (looping && totalLength > 0) ? pos % totalLength : pos;
+}
+
+int64 DecodedTrackSource::getTotalLength() const {
+    return track->samples.getNumSamples();
+}
+
+bool DecodedTrackSource::isLooping() const {
+    return looping;
+}
+
+void DecodedTrackSource::setLooping(bool shouldLoop) {
+    looping = shouldLoop;
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    DecodedTrackSource.h
+    Created: 17 Oct 2026 11:20:05am
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DecodedTrackCache.h"
+
+using namespace juce;
+
+/**
+ * @class DecodedTrackSource
+ * @brief Plays a track straight out of the DecodedTrackCache.
+ *
+ * The source shares the cached samples instead of copying them, so loading a cached track
+ * onto a deck is instant and costs no extra memory.
+ */
+class DecodedTrackSource : public PositionableAudioSource {
+public:
+    /**
+     * @brief Constructor.
+     * @param track The decoded track to play.
+     */
+    explicit DecodedTrackSource(std::shared_ptr<const DecodedTrack> track);
+
+    /** Destructor. */
+    ~DecodedTrackSource() override;
+
+    /** @internal */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    /** @internal */
+    void releaseResources() override;
+    /** @internal */
+    void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override;
+
+    /** @internal */
+    void setNextReadPosition(int64 newPosition) override;
+    /** @internal */
+    int64 getNextReadPosition() const override;
+    /** @internal */
+    int64 getTotalLength() const override;
+    /** @internal */
+    bool isLooping() const override;
+    /** @internal */
+    void setLooping(bool shouldLoop) override;
+
+private:
+    std::shared_ptr<const DecodedTrack> track; /**< The shared decoded samples. */
+    std::atomic<int64> nextPlayPos{ 0 }; /**< Position of the next sample to play. */
+    bool looping = false; /**< Whether playback wraps at the end. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DecodedTrackSource)
+};
@@ -0,0 +1,163 @@
+/*
+  ==============================================================================
+
+    DiskThumbnailCache.cpp
+    Created: 17 Oct 2026 2:41:53pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Key thumbnails by file path and modification time - DONE
+ * 2. Read thumbnails missing from memory back from disk - DONE
+ * 3. Write finished thumbnails through a temporary file - DONE
+ * 4. Keep the cache folder within a byte budget, deleting the least recently used entries - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "DiskThumbnailCache.h"
+#include <algorithm>
+#include <vector>
+
+DiskThumbnailCache::DiskThumbnailCache(int maxThumbsInMemory, int64 maxDiskBytes, File _directory)
+        : AudioThumbnailCache(maxThumbsInMemory), directory(std::move(_directory)), diskBudget(maxDiskBytes) {
+    directory.createDirectory();
+    scanDirectory();
+}
+
+DiskThumbnailCache::~DiskThumbnailCache() {}
+
+File DiskThumbnailCache::getDefaultDirectory() {
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+            .getChildFile("otoDecks")
+            .getChildFile("thumbs");
+}
+
+int64 DiskThumbnailCache::getHashFor(const File &file) {
+    // the same key AudioThumbnail uses for a FileInputSource, so both paths share entries
+    return FileInputSource(file, true).hashCode();
+}
+
+void DiskThumbnailCache::setDiskBudget(int64 maxDiskBytes) {
+    const ScopedLock sl(lock);
+    diskBudget = maxDiskBytes;
+    evictToBudget();
+}
+
+int64 DiskThumbnailCache::getDiskUsed() const {
+    const ScopedLock sl(lock);
+    return diskUsed;
+}
+
+void DiskThumbnailCache::scanDirectory() {
+    struct Found {
+        int64 hashCode, numBytes, lastAccess;
+    };
+    std::vector<Found> found;
+
+    for (const auto &entry: RangedDirectoryIterator(directory, false, "*.thumb", File::findFiles)) {
+        const File file = entry.getFile();
+        found.push_back({ file.getFileNameWithoutExtension().getHexValue64(), entry.getFileSize(),
+                          file.getLastAccessTime().toMilliseconds() });
+    }
+
+    // most recently accessed first, the order the entries would have been used in
+    std::sort(found.begin(), found.end(), [](const Found &a, const Found &b) { return a.lastAccess > b.lastAccess; });
+
+    const ScopedLock sl(lock);
+    for (const auto &f: found) {
+        entries.push_back({ f.hashCode, f.numBytes });
+        index[f.hashCode] = std::prev(entries.end());
+        diskUsed += f.numBytes;
+    }
+    evictToBudget();
+}
+
+void DiskThumbnailCache::touch(int64 hashCode, int64 numBytes) {
+    auto found = index.find(hashCode);
+    if (found != index.end()) {
+        // move the entry to the front, it is now the most recently used one
+        entries.splice(entries.begin(), entries, found->second);
+        diskUsed += numBytes - found->second->numBytes;
+        found->second->numBytes = numBytes;
+    } else {
+        entries.push_front({ hashCode, numBytes });
+        index[hashCode] = entries.begin();
+        diskUsed += numBytes;
+    }
+}
+
+void DiskThumbnailCache::evictToBudget() {
+    // the newest entry always stays, it was stored because someone is about to use it
+    while (diskUsed > diskBudget && entries.size() > 1) {
+        getFileFor(entries.back().hashCode).deleteFile();
+        diskUsed -= entries.back().numBytes;
+        index.erase(entries.back().hashCode);
+        entries.pop_back();
+    }
+}
+
+bool DiskThumbnailCache::isOnDisk(int64 hashCode) const {
+    return getFileFor(hashCode).existsAsFile();
+}
+
+File DiskThumbnailCache::getFileFor(int64 hashCode) const {
+    return directory.getChildFile(String::toHexString(hashCode) + ".thumb");
+}
+
+bool DiskThumbnailCache::loadNewThumb(AudioThumbnailBase &thumb, int64 hashCode) {
+    const File file = getFileFor(hashCode);
+    FileInputStream in(file);
+
+    // loadFrom() checks the thumbnail's own header, so damaged entries are simply rebuilt
+    if (!in.openedOk() || !thumb.loadFrom(in)) {
+        return false;
+    }
+
+    const ScopedLock sl(lock);
+
+    // the budget may have deleted the file since it was opened, then it no longer counts towards it
+    if (index.find(hashCode) == index.end() && !file.existsAsFile()) {
+        return true;
+    }
+
+    // many systems don't update access times on reads, so set it ourselves for the next session
+    file.setLastAccessTime(Time::getCurrentTime());
+    touch(hashCode, file.getSize());
+    return true;
+}
+
+void DiskThumbnailCache::saveNewlyFinishedThumbnail(const AudioThumbnailBase &thumb, int64 hashCode) {
+    saveToDisk(thumb, hashCode);
+}
+
+void DiskThumbnailCache::saveToDisk(const AudioThumbnailBase &thumb, int64 hashCode) {
+    const File file = getFileFor(hashCode);
+    if (file.existsAsFile() || !directory.createDirectory()) {
+        return;
+    }
+
+    TemporaryFile tempFile(file);
+    {
+        FileOutputStream out(tempFile.getFile());
+        if (!out.openedOk()) {
+            return;
+        }
+
+        thumb.saveTo(out);
+        out.flush();
+
+        if (out.getStatus().failed()) {
+            return;
+        }
+    }
+
+    if (!tempFile.overwriteTargetFileWithTemporary()) {
+        return;
+    }
+
+    const ScopedLock sl(lock);
+    touch(hashCode, file.getSize());
+    evictToBudget();
+}
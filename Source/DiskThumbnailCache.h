@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    DiskThumbnailCache.h
+    Created: 17 Oct 2026 2:41:53pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <list>
+#include <map>
+
+using namespace juce;
+
+/**
+ * @class DiskThumbnailCache
+ * @brief Thumbnail cache that keeps every finished waveform on disk as well as in memory.
+ *
+ * Thumbnails are keyed by the hash of a FileInputSource that includes the file's modification
+ * time, so an edited file gets a new entry instead of showing a stale waveform. When a thumbnail
+ * is not in memory it is read back from the cache folder, which avoids decoding the whole track
+ * again after a restart or an eviction. Entries are written through a temporary file, so they can
+ * be stored from any thread.
+ *
+ * The folder has a byte budget. Reading an entry back updates its file's access time, and when a
+ * new entry pushes the folder over the budget the least recently used files are deleted. The order
+ * is rebuilt from the access times when the cache is created, so it carries over between sessions.
+ */
+class DiskThumbnailCache : public AudioThumbnailCache {
+public:
+    /** Number of source samples per thumbnail sample, shared by every thumbnail in the cache. */
+    static constexpr int samplesPerThumbSample = 1000;
+
+    /** Default size of the cache folder, thousands of tracks at a few hundred kB each. */
+    static constexpr int64 defaultDiskBudget = (int64) 512 * 1024 * 1024;
+
+    /**
+     * @brief Constructor.
+     * @param maxThumbsInMemory The number of thumbnails kept in memory.
+     * @param maxDiskBytes The budget for the thumbnails stored in the cache folder.
+     * @param directory The folder the thumbnails are stored in.
+     */
+    DiskThumbnailCache(int maxThumbsInMemory, int64 maxDiskBytes = defaultDiskBudget,
+                       File directory = getDefaultDirectory());
+
+    /** Destructor. */
+    ~DiskThumbnailCache() override;
+
+    /**
+     * @brief Get the default location of the cache folder.
+     * @return The thumbnail folder in the user's application data folder.
+     */
+    static File getDefaultDirectory();
+
+    /**
+     * @brief Get the key a thumbnail of a local file is stored under.
+     * @param file The audio file.
+     * @return The hash of the file's path and modification time.
+     */
+    static int64 getHashFor(const File &file);
+
+    /**
+     * @brief Check whether a thumbnail is stored on disk.
+     * @param hashCode The key returned by getHashFor().
+     * @return True if the cache folder has an entry for the key.
+     */
+    bool isOnDisk(int64 hashCode) const;
+
+    /**
+     * @brief Write a thumbnail to the cache folder without keeping it in memory.
+     *
+     * Used for thumbnails built in the background, which would otherwise push the tracks that are
+     * actually on the decks out of memory.
+     *
+     * @param thumb The finished thumbnail.
+     * @param hashCode The key returned by getHashFor().
+     */
+    void saveToDisk(const AudioThumbnailBase &thumb, int64 hashCode);
+
+    /**
+     * @brief Set the budget of the cache folder, deleting the least recently used entries if needed.
+     * @param maxDiskBytes The budget for the thumbnails stored in the cache folder.
+     */
+    void setDiskBudget(int64 maxDiskBytes);
+
+    /**
+     * @brief Get the space taken by the cache folder.
+     * @return The size of all stored thumbnails in bytes.
+     */
+    int64 getDiskUsed() const;
+
+protected:
+    /** Read a thumbnail that is not in memory from the cache folder. */
+    bool loadNewThumb(AudioThumbnailBase &thumb, int64 hashCode) override;
+
+    /** Write a thumbnail that has just been finished to the cache folder as well. */
+    void saveNewlyFinishedThumbnail(const AudioThumbnailBase &thumb, int64 hashCode) override;
+
+private:
+    /** A thumbnail stored in the cache folder and its size. */
+    struct Entry {
+        int64 hashCode; /**< The key the thumbnail is stored under. */
+        int64 numBytes; /**< Size of the entry's file. */
+    };
+
+    /** Get the file an entry is stored in. */
+    File getFileFor(int64 hashCode) const;
+
+    /** List the entries already in the cache folder, least recently accessed last. */
+    void scanDirectory();
+
+    /** Mark an entry as most recently used, adding it if it is new. Caller holds the lock. */
+    void touch(int64 hashCode, int64 numBytes);
+
+    /** Delete least recently used entries until the folder fits the budget. Caller holds the lock. */
+    void evictToBudget();
+
+    const File directory; /**< The folder the thumbnails are stored in. */
+
+    CriticalSection lock; /**< Guards everything below. */
+    std::list<Entry> entries; /**< Entries on disk, most recently used first. */
+    std::map<int64, std::list<Entry>::iterator> index; /**< Key to entry lookup. */
+    int64 diskBudget; /**< Maximum number of bytes to keep in the folder. */
+    int64 diskUsed = 0; /**< Bytes currently stored in the folder. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DiskThumbnailCache)
+};
@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+    KeyDetector.cpp
+    Created: 17 Oct 2026 7:52:40pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Low-pass and decimate the mono mix to about 11 kHz - DONE
+ * 2. Fold the FFT magnitudes of overlapping frames into a chromagram - DONE
+ * 3. Correlate the chroma with the Krumhansl-Kessler key profiles - DONE
+ * 4. Name keys and place them on the Camelot wheel - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "KeyDetector.h"
+
+namespace {
+    /** Rate the track is decimated to, enough for the chroma range below. */
+    constexpr double targetRate = 11025.0;
+
+    /** Cutoff of the anti-aliasing filter in front of the decimation. */
+    constexpr double lowPassHz = 3000.0;
+
+    /** Chroma range, below it the bins are wider than a semitone, above it harmonics blur the pitch. */
+    constexpr double lowestHz = 100.0;
+    constexpr double highestHz = 2000.0;
+
+    /** Krumhansl-Kessler probe tone ratings, from the tonic up in semitones. */
+    constexpr double majorProfile[12] = { 6.35, 2.23, 3.48, 2.33, 4.38, 4.09, 2.52, 5.19, 2.39, 3.66, 2.29, 2.88 };
+    constexpr double minorProfile[12] = { 6.33, 2.68, 3.52, 5.38, 2.60, 3.53, 2.54, 4.75, 3.98, 2.69, 3.34, 3.17 };
+
+    /** Correlation below which the chroma is too flat to name a key. */
+    constexpr double minCorrelation = 0.1;
+
+    /** Pearson correlation of the chroma with a profile whose tonic is the given pitch class. */
+    double correlate(const std::array<double, 12> &chroma, const double *profile, int tonic) {
+        double chromaMean = 0.0, profileMean = 0.0;
+        for (int i = 0; i < 12; ++i) {
+            chromaMean += chroma[(size_t) i];
+            profileMean += profile[i];
+        }
+        chromaMean /= 12.0;
+        profileMean /= 12.0;
+
+        double product = 0.0, chromaSquares = 0.0, profileSquares = 0.0;
+        for (int i = 0; i < 12; ++i) {
+            const double c = chroma[(size_t) ((tonic + i) % 12)] - chromaMean;
+            const double p = profile[i] - profileMean;
+            product += c * p;
+            chromaSquares += c * c;
+            profileSquares += p * p;
+        }
+
+        return chromaSquares > 0.0 ? product / std::sqrt(chromaSquares * profileSquares) : 0.0;
+    }
+}
+
+KeyDetector::KeyDetector()
+        : window((size_t) frameSize), frame((size_t) frameSize), spectrum((size_t) frameSize * 2) {
+    dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t) frameSize,
+                                                       dsp::WindowingFunction<float>::hann, false);
+}
+
+KeyDetector::~KeyDetector() {}
+
+void KeyDetector::reset(double newSampleRate) {
+    // the bin table only depends on the sample rate, most libraries only have one or two
+    if (newSampleRate != sampleRate) {
+        sampleRate = newSampleRate;
+        decimation = jmax(1, roundToInt(newSampleRate / targetRate));
+        lowPassCoefficient = (float) (1.0 - std::exp(-MathConstants<double>::twoPi * lowPassHz / newSampleRate));
+
+        const double binHz = newSampleRate / decimation / frameSize;
+        firstBin = jmax(1, (int) std::ceil(lowestHz / binHz));
+        lastBin = jmin(frameSize / 2 - 1, (int) std::floor(highestHz / binHz));
+
+        binPitchClasses.assign((size_t) frameSize / 2, -1);
+        binWeights.assign((size_t) frameSize / 2, 0.0f);
+
+        for (int bin = firstBin; bin <= lastBin; ++bin) {
+            const double midiNote = 69.0 + 12.0 * std::log2(bin * binHz / 440.0);
+            const int nearestNote = roundToInt(midiNote);
+            const double closeness = std::cos(MathConstants<double>::pi * (midiNote - nearestNote));
+
+            binPitchClasses[(size_t) bin] = ((nearestNote % 12) + 12) % 12;
+            binWeights[(size_t) bin] = (float) (closeness * closeness); // bins between two semitones count for neither
+        }
+    }
+
+    lowPassState1 = 0.0f;
+    lowPassState2 = 0.0f;
+    decimationPhase = 0;
+    frameFill = 0;
+    chroma.fill(0.0);
+    numFrames = 0;
+}
+
+void KeyDetector::process(const AudioBuffer<float> &block, int numSamples) {
+    const int numChannels = block.getNumChannels();
+    if (numChannels == 0 || numSamples <= 0) {
+        return;
+    }
+
+    if ((int) mono.size() < numSamples) {
+        mono.resize((size_t) numSamples); // only on the first track, blocks keep their size
+    }
+
+    FloatVectorOperations::copyWithMultiply(mono.data(), block.getReadPointer(0), 1.0f / (float) numChannels, numSamples);
+    for (int channel = 1; channel < numChannels; ++channel) {
+        FloatVectorOperations::addWithMultiply(mono.data(), block.getReadPointer(channel), 1.0f / (float) numChannels, numSamples);
+    }
+
+    // two one-pole stages keep what folds back into the chroma range well down, then every
+    // decimation'th sample is kept
+    for (int i = 0; i < numSamples; ++i) {
+        lowPassState1 += lowPassCoefficient * (mono[(size_t) i] - lowPassState1);
+        lowPassState2 += lowPassCoefficient * (lowPassState1 - lowPassState2);
+
+        if (++decimationPhase < decimation) {
+            continue;
+        }
+        decimationPhase = 0;
+
+        frame[(size_t) frameFill++] = lowPassState2;
+        if (frameFill == frameSize) {
+            processFrame();
+
+            // frames overlap by half, keep the second half for the next one
+            std::copy(frame.begin() + hopSize, frame.end(), frame.begin());
+            frameFill = frameSize - hopSize;
+        }
+    }
+}
+
+void KeyDetector::processFrame() {
+    FloatVectorOperations::multiply(spectrum.data(), frame.data(), window.data(), frameSize);
+    FloatVectorOperations::clear(spectrum.data() + frameSize, frameSize);
+    fft.performFrequencyOnlyForwardTransform(spectrum.data(), true);
+
+    std::array<float, 12> frameChroma{};
+    for (int bin = firstBin; bin <= lastBin; ++bin) {
+        frameChroma[(size_t) binPitchClasses[(size_t) bin]] += spectrum[(size_t) bin] * binWeights[(size_t) bin];
+    }
+
+    // every frame with sound counts the same, so loud passages don't outvote the rest of the track
+    const float loudest = *std::max_element(frameChroma.begin(), frameChroma.end());
+    if (loudest <= 1.0e-3f) {
+        return;
+    }
+
+    for (size_t pitchClass = 0; pitchClass < 12; ++pitchClass) {
+        chroma[pitchClass] += frameChroma[pitchClass] / loudest;
+    }
+    ++numFrames;
+}
+
+void KeyDetector::finish(TrackAnalysis &analysis) {
+    analysis.key = -1;
+
+    if (numFrames == 0) {
+        return; // silence
+    }
+
+    double bestCorrelation = minCorrelation;
+    for (int tonic = 0; tonic < 12; ++tonic) {
+        const double major = correlate(chroma, majorProfile, tonic);
+        const double minor = correlate(chroma, minorProfile, tonic);
+
+        if (major > bestCorrelation) {
+            bestCorrelation = major;
+            analysis.key = tonic;
+        }
+        if (minor > bestCorrelation) {
+            bestCorrelation = minor;
+            analysis.key = 12 + tonic;
+        }
+    }
+}
+
+String KeyDetector::getKeyName(int key) {
+    static const char *const majorNames[12] = { "C", "Db", "D", "Eb", "E", "F", "F#", "G", "Ab", "A", "Bb", "B" };
+    static const char *const minorNames[12] = { "Cm", "C#m", "Dm", "Ebm", "Em", "Fm", "F#m", "Gm", "G#m", "Am", "Bbm", "Bm" };
+
+    if (key < 0 || key >= numKeys) {
+        return {};
+    }
+    return key < 12 ? majorNames[key] : minorNames[key - 12];
+}
+
+String KeyDetector::getCamelotName(int key) {
+    if (key < 0 || key >= numKeys) {
+        return {};
+    }
+    return String(getCamelotNumber(key)) + (key < 12 ? "B" : "A");
+}
+
+int KeyDetector::getCamelotNumber(int key) {
+    if (key < 0 || key >= numKeys) {
+        return 0;
+    }
+
+    // C major is 8B and every fifth up is one step clockwise, a minor key sits with its relative major
+    const int majorTonic = key < 12 ? key : (key - 12 + 3) % 12;
+    return (majorTonic * 7 + 7) % 12 + 1;
+}
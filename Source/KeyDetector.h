@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    KeyDetector.h
+    Created: 17 Oct 2026 7:52:40pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "TrackAnalysis.h"
+
+using namespace juce;
+
+/**
+ * @class KeyDetector
+ * @brief Finds the musical key of a track from a chromagram.
+ *
+ * The track is mixed to mono, low-passed and decimated to about 11 kHz, then cut into
+ * overlapping Hann-windowed frames. The FFT magnitudes of each frame between 100 Hz and 2 kHz are
+ * folded into the twelve pitch classes, and the chroma of all frames is summed. The key is the
+ * major or minor Krumhansl-Kessler profile, in any of the twelve tonics, that correlates best
+ * with the sum.
+ *
+ * A detector owns its FFT plan and all its buffers, and is reused track after track with
+ * reset(), so analysing a library allocates nothing per track. It is not thread safe, each
+ * worker uses its own.
+ */
+class KeyDetector {
+public:
+    /** Constructor, allocates the FFT and the buffers. */
+    KeyDetector();
+
+    /** Destructor. */
+    ~KeyDetector();
+
+    /**
+     * @brief Start a new track.
+     * @param sampleRate The sample rate of the track.
+     */
+    void reset(double sampleRate);
+
+    /**
+     * @brief Feed the next block of the track.
+     * @param block The decoded audio, any number of channels.
+     * @param numSamples The number of samples in the block.
+     */
+    void process(const AudioBuffer<float> &block, int numSamples);
+
+    /**
+     * @brief Find the key of everything fed since the last reset.
+     * @param analysis Receives the key, -1 if the track has no clear pitch content.
+     */
+    void finish(TrackAnalysis &analysis);
+
+    /**
+     * @brief Get the usual name of a key, e.g. "F#m".
+     * @param key The key as stored in TrackAnalysis.
+     * @return The name, empty for -1.
+     */
+    static String getKeyName(int key);
+
+    /**
+     * @brief Get the Camelot wheel position of a key, e.g. "11A".
+     * @param key The key as stored in TrackAnalysis.
+     * @return The Camelot code, empty for -1.
+     */
+    static String getCamelotName(int key);
+
+    /**
+     * @brief Get the number on the Camelot wheel of a key, for sorting.
+     * @param key The key as stored in TrackAnalysis.
+     * @return 1 to 12, 0 for -1.
+     */
+    static int getCamelotNumber(int key);
+
+    static constexpr int numKeys = 24; /**< Twelve major then twelve minor keys. */
+
+private:
+    /** Window the frame collected so far and add its chroma. */
+    void processFrame();
+
+    static constexpr int fftOrder = 12; /**< 4096-point frames, 2.7 Hz bins at the decimated rate. */
+    static constexpr int frameSize = 1 << fftOrder; /**< Samples per frame. */
+    static constexpr int hopSize = frameSize / 2; /**< Samples between frames. */
+
+    dsp::FFT fft{ fftOrder }; /**< FFT plan, built once. */
+    std::vector<float> window; /**< Hann window of one frame. */
+    std::vector<float> frame; /**< Decimated samples of the current frame. */
+    std::vector<float> spectrum; /**< FFT scratch, twice the frame size. */
+    std::vector<float> mono; /**< Mono mix of the block being processed. */
+
+    double sampleRate = 0.0; /**< Sample rate the bin table was built for. */
+    int decimation = 1; /**< Input samples per decimated sample. */
+    float lowPassCoefficient = 0.0f; /**< One-pole coefficient of the anti-aliasing filter. */
+    std::vector<int> binPitchClasses; /**< Pitch class of each FFT bin in the chroma range, -1 outside it. */
+    std::vector<float> binWeights; /**< How close each bin is to the centre of its semitone. */
+    int firstBin = 0; /**< First bin in the chroma range. */
+    int lastBin = 0; /**< Last bin in the chroma range. */
+
+    float lowPassState1 = 0.0f; /**< State of the first filter stage. */
+    float lowPassState2 = 0.0f; /**< State of the second filter stage. */
+    int decimationPhase = 0; /**< Input samples since the last decimated sample. */
+    int frameFill = 0; /**< Decimated samples in the current frame. */
+    std::array<double, 12> chroma{}; /**< Chroma summed over the track. */
+    int numFrames = 0; /**< Frames with sound in them. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KeyDetector)
+};
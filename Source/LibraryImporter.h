@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    LibraryImporter.h
+    Created: 17 Oct 2026 11:48:17am
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <vector>
+#include "DiskThumbnailCache.h"
+#include "TrackAnalysis.h"
+
+using namespace juce;
+
+/**
+ * @struct ImportedTrack
+ * @brief Metadata probed from the header of an imported audio file, and its analysis once it has run.
+ */
+struct ImportedTrack {
+    String path; /**< Full path of the audio file. */
+    String title; /**< File name without extension. */
+    double durationSeconds = 0.0; /**< Length of the track in seconds. */
+    int64 fileSize = 0; /**< Size of the file when it was probed. */
+    int64 modificationTime = 0; /**< Modification time of the file when it was probed, in milliseconds. */
+    TrackAnalysis analysis; /**< Tempo and beatgrid, not analysed yet for freshly probed tracks. */
+};
+
+/**
+ * @class LibraryImporter
+ * @brief Probes dropped files and folders for the library on a pool of worker threads.
+ *
+ * Folders are scanned recursively for files of any registered format. Each file is probed by
+ * reading its header only, no audio is decoded. Results are collected from the workers and handed
+ * to the message thread in batches, so rows can be added to the library while the import is still
+ * running.
+ *
+ * Every imported track also gets its waveform thumbnail built in the background and stored in the
+ * disk cache, so loading it onto a deck later doesn't have to decode it just to draw the waveform.
+ * Thumbnail jobs decode whole files, so they run on a separate pool with a quarter of the cores at
+ * background priority. Probes never wait behind them, and they don't count towards the import progress.
+ */
+class LibraryImporter : private AsyncUpdater {
+public:
+    /**
+     * @brief Constructor.
+     * @param formatManager The audio format manager used to probe files.
+     * @param thumbnailCache The disk cache the thumbnails of imported tracks are stored in.
+     */
+    LibraryImporter(AudioFormatManager &formatManager, DiskThumbnailCache &thumbnailCache);
+
+    /** Destructor. */
+    ~LibraryImporter() override;
+
+    /**
+     * @brief Add files and folders to the running import, or start a new one.
+     * @param files The dropped file and folder paths.
+     */
+    void importFiles(const StringArray &files);
+
+    /**
+     * @brief Check known tracks against the disk and probe the ones whose size or modification time changed.
+     *
+     * Changed tracks are reported through onTracksImported like newly imported ones. Unchanged tracks
+     * without a thumbnail on disk get one built.
+     *
+     * @param knownTracks The tracks currently in the library.
+     */
+    void rescan(std::vector<ImportedTrack> knownTracks);
+
+    /** Cancel the running import. Tracks that were already reported stay in the library. */
+    void cancel();
+
+    /**
+     * @brief Check whether an import is running.
+     * @return True while files are still being scanned or probed.
+     */
+    bool isImporting() const;
+
+    /**
+     * @brief Get the progress of the running import, updated on the message thread.
+     * @return A reference to the progress (0 to 1), suitable for a ProgressBar.
+     */
+    double &getProgress();
+
+    /** Called on the message thread with every new batch of probed tracks. */
+    std::function<void(const std::vector<ImportedTrack> &)> onTracksImported;
+
+    /** Called on the message thread when the import finishes or is cancelled. */
+    std::function<void()> onImportFinished;
+
+private:
+    class ScanJob;
+    class RescanJob;
+    class ProbeJob;
+    class ThumbnailJob;
+
+    /** Queue a probe job for a single file. */
+    void addProbeJob(const File &file, int generation);
+
+    /** Queue a thumbnail job for a single file, unless its thumbnail is already on disk. */
+    void addThumbnailJob(const File &file, int generation);
+
+    /** Store the result of a probe job and notify the message thread. */
+    void addResult(const ImportedTrack &track, int generation);
+
+    /** Count a finished probe job. */
+    void jobFinished(int generation);
+
+    /** Deliver the collected results on the message thread. */
+    void handleAsyncUpdate() override;
+
+    AudioFormatManager &formatManager; /**< Format manager used to probe headers. */
+    DiskThumbnailCache &thumbnailCache; /**< Where the thumbnails of imported tracks are stored. */
+    ThreadPool pool; /**< Scan and probe workers, one per CPU core. */
+    ThreadPool thumbnailPool; /**< Thumbnail workers, a quarter of the CPU cores. */
+    std::atomic<int> importGeneration{ 0 }; /**< Incremented on cancel so late results are dropped. */
+
+    CriticalSection resultsLock; /**< Guards the fields below. */
+    std::vector<ImportedTrack> pendingResults; /**< Results not yet delivered. */
+    int numJobsQueued = 0; /**< Files queued for probing in this import. */
+    int numJobsDone = 0; /**< Files probed in this import. */
+
+    double progress = 0.0; /**< Progress shown in the UI, only touched on the message thread. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LibraryImporter)
+};
@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+    LibraryIndex.cpp
+    Created: 17 Oct 2026 12:31:09pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Define the binary layout of the library file - DONE
+ * 2. Load the library from a memory-mapped file - DONE
+ * 3. Save the library through a temporary file - DONE
+ * 4. Store the tempo and beatgrid, version 2, still loading version 1 files - DONE
+ * 5. Store the key, version 3, tracks from older files are analysed again - DONE
+ * 6. Store the loudness and true peak, version 4 - DONE
+ *
+ * Layout (all values little-endian):
+ *
+ *   header   uint32 magic, uint32 version, uint32 numTracks, uint32 stringBlockSize
+ *   records  numTracks x { int64 fileSize, int64 modificationTime, double durationSeconds,
+ *                          uint32 pathOffset, uint32 pathLength, uint32 titleOffset, uint32 titleLength,
+ *                          double bpm, double firstBeatSeconds, uint32 flags, int32 key,
+ *                          double loudnessLufs, double truePeakDb }
+ *   strings  UTF-8 paths and titles, referenced by offset and length from the string block start
+ *
+ * Version 1 records end after titleLength, version 2 records after flags, version 3 records after key.
+ *
+
+  ==============================================================================
+*/
+
+#include "LibraryIndex.h"
+
+File LibraryIndex::getDefaultFile() {
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+            .getChildFile("otoDecks")
+            .getChildFile("library.bin");
+}
+
+bool LibraryIndex::load(const File &file, std::vector<ImportedTrack> &tracks) {
+    MemoryMappedFile mappedFile(file, MemoryMappedFile::readOnly);
+    const auto *data = static_cast<const char *>(mappedFile.getData());
+    const size_t fileSize = mappedFile.getSize();
+
+    if (data == nullptr || fileSize < (size_t) headerSize || ByteOrder::littleEndianInt(data) != magic) {
+        return false;
+    }
+
+    const uint32 fileVersion = ByteOrder::littleEndianInt(data + 4);
+    if (fileVersion < 1 || fileVersion > version) {
+        return false;
+    }
+
+    const size_t fileRecordSize = fileVersion == 1 ? recordSizeV1
+                                  : fileVersion == 2 ? recordSizeV2
+                                  : fileVersion == 3 ? recordSizeV3
+                                  : recordSize;
+    const uint32 numTracks = ByteOrder::littleEndianInt(data + 8);
+    const uint32 stringBlockSize = ByteOrder::littleEndianInt(data + 12);
+    const size_t stringBlockStart = (size_t) headerSize + (size_t) numTracks * fileRecordSize;
+
+    if (stringBlockStart + stringBlockSize != fileSize) {
+        return false; // truncated or corrupt
+    }
+
+    const char *strings = data + stringBlockStart;
+    auto readString = [strings, stringBlockSize](uint32 offset, uint32 length) {
+        if ((uint64) offset + length > stringBlockSize) {
+            return String();
+        }
+        return String::fromUTF8(strings + offset, (int) length);
+    };
+
+    tracks.clear();
+    tracks.reserve(numTracks);
+
+    for (uint32 i = 0; i < numTracks; ++i) {
+        const char *record = data + headerSize + (size_t) i * fileRecordSize;
+
+        ImportedTrack track;
+        track.fileSize = (int64) ByteOrder::littleEndianInt64(record);
+        track.modificationTime = (int64) ByteOrder::littleEndianInt64(record + 8);
+
+        const uint64 durationBits = ByteOrder::littleEndianInt64(record + 16);
+        std::memcpy(&track.durationSeconds, &durationBits, sizeof(double));
+
+        track.path = readString(ByteOrder::littleEndianInt(record + 24), ByteOrder::littleEndianInt(record + 28));
+        track.title = readString(ByteOrder::littleEndianInt(record + 32), ByteOrder::littleEndianInt(record + 36));
+
+        if (fileVersion >= 2) {
+            const uint64 bpmBits = ByteOrder::littleEndianInt64(record + 40);
+            const uint64 firstBeatBits = ByteOrder::littleEndianInt64(record + 48);
+            std::memcpy(&track.analysis.bpm, &bpmBits, sizeof(double));
+            std::memcpy(&track.analysis.firstBeatSeconds, &firstBeatBits, sizeof(double));
+            track.analysis.analysed = (ByteOrder::littleEndianInt(record + 56) & analysedFlag) != 0;
+        }
+
+        if (fileVersion >= 3) {
+            track.analysis.key = (int) ByteOrder::littleEndianInt(record + 60);
+        }
+
+        if (fileVersion >= 4) {
+            const uint64 loudnessBits = ByteOrder::littleEndianInt64(record + 64);
+            const uint64 truePeakBits = ByteOrder::littleEndianInt64(record + 72);
+            std::memcpy(&track.analysis.loudnessLufs, &loudnessBits, sizeof(double));
+            std::memcpy(&track.analysis.truePeakDb, &truePeakBits, sizeof(double));
+        } else {
+            track.analysis.analysed = false; // analysed before everything was measured, queue it again
+        }
+
+        tracks.push_back(std::move(track));
+    }
+
+    return true;
+}
+
+bool LibraryIndex::save(const File &file, const std::vector<ImportedTrack> &tracks) {
+    if (!file.getParentDirectory().createDirectory()) {
+        return false;
+    }
+
+    // build the string block first so the records can point into it
+    MemoryOutputStream strings;
+    std::vector<uint32> offsets;
+    offsets.reserve(tracks.size() * 4);
+
+    for (const auto &track: tracks) {
+        for (const String *text: {&track.path, &track.title}) {
+            const auto utf8 = text->toUTF8();
+            const size_t length = utf8.sizeInBytes() - 1;
+
+            offsets.push_back((uint32) strings.getDataSize());
+            offsets.push_back((uint32) length);
+            strings.write(utf8.getAddress(), length);
+        }
+    }
+
+    TemporaryFile tempFile(file);
+    {
+        FileOutputStream out(tempFile.getFile());
+        if (!out.openedOk()) {
+            return false;
+        }
+
+        out.writeInt((int) magic);
+        out.writeInt((int) version);
+        out.writeInt((int) tracks.size());
+        out.writeInt((int) strings.getDataSize());
+
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            out.writeInt64(tracks[i].fileSize);
+            out.writeInt64(tracks[i].modificationTime);
+            out.writeDouble(tracks[i].durationSeconds);
+
+            for (int j = 0; j < 4; ++j) {
+                out.writeInt((int) offsets[i * 4 + (size_t) j]);
+            }
+
+            out.writeDouble(tracks[i].analysis.bpm);
+            out.writeDouble(tracks[i].analysis.firstBeatSeconds);
+            out.writeInt((int) (tracks[i].analysis.analysed ? analysedFlag : 0));
+            out.writeInt(tracks[i].analysis.key);
+            out.writeDouble(tracks[i].analysis.loudnessLufs);
+            out.writeDouble(tracks[i].analysis.truePeakDb);
+        }
+
+        out.write(strings.getData(), strings.getDataSize());
+        out.flush();
+
+        if (out.getStatus().failed()) {
+            return false;
+        }
+    }
+
+    return tempFile.overwriteTargetFileWithTemporary();
+}
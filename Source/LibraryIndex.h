@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    LibraryIndex.h
+    Created: 17 Oct 2026 12:31:09pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "LibraryImporter.h"
+
+using namespace juce;
+
+/**
+ * @class LibraryIndex
+ * @brief Reads and writes the library as a compact binary file.
+ *
+ * The file holds a header, a table of fixed-size track records and one block with all the
+ * strings. Loading maps the file into memory and walks the record table directly, so
+ * startup doesn't parse anything line by line. Saving writes to a temporary file first, so
+ * a crash never leaves a half-written library behind. Files written by older versions are still
+ * loaded, their tracks simply come without the fields added since.
+ */
+class LibraryIndex {
+public:
+    /**
+     * @brief Get the default location of the library file.
+     * @return The library file in the user's application data folder.
+     */
+    static File getDefaultFile();
+
+    /**
+     * @brief Load the library.
+     * @param file The library file.
+     * @param tracks Receives the tracks stored in the file.
+     * @return True if the file exists and is valid.
+     */
+    static bool load(const File &file, std::vector<ImportedTrack> &tracks);
+
+    /**
+     * @brief Save the library.
+     * @param file The library file.
+     * @param tracks The tracks to store.
+     * @return True if the file was written.
+     */
+    static bool save(const File &file, const std::vector<ImportedTrack> &tracks);
+
+private:
+    static constexpr uint32 magic = 0x424c444f; /**< "ODLB" in little-endian byte order. */
+    static constexpr uint32 version = 4; /**< Format version, bumped whenever the record layout changes. */
+    static constexpr int headerSize = 16; /**< Magic, version, number of tracks and size of the string block. */
+    static constexpr int recordSizeV1 = 40; /**< Size, modification time, duration and two string references. */
+    static constexpr int recordSizeV2 = 60; /**< The version 1 record plus the bpm, the first beat and analysis flags. */
+    static constexpr int recordSizeV3 = 64; /**< The version 2 record plus the key. */
+    static constexpr int recordSize = 80; /**< The version 3 record plus the loudness and the true peak. */
+
+    /** Flag set in a record once its track has been analysed. */
+    static constexpr uint32 analysedFlag = 1;
+};
@@ -0,0 +1,330 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.cpp
+    Created: 17 Oct 2026 8:27:15pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Design the K-weighting filters for any sample rate - DONE
+ * 2. Collect the K-weighted energy in 100 ms steps - DONE
+ * 3. Gate the 400 ms blocks and integrate the loudness - DONE
+ * 4. Find the true peak with a four times oversampling polyphase filter - DONE
+ * 5. Vectorise the energies and the oversampling filter - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "LoudnessMeter.h"
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#elif JUCE_ARM && defined(__ARM_NEON)
+ #include <arm_neon.h>
+#endif
+
+namespace {
+    /** Gates of BS.1770-4, the absolute one in LUFS and the relative one in LU below the ungated loudness. */
+    constexpr double absoluteGateLufs = -70.0;
+    constexpr double relativeGateLu = -10.0;
+
+    /** Offset in the loudness formula that puts a 997 Hz sine at 0 dBFS at -3.01 LUFS per channel. */
+    constexpr double loudnessOffset = -0.691;
+
+    /** Trims are kept within this range, whatever the measurement says. */
+    constexpr double minGainDb = -24.0;
+    constexpr double maxGainDb = 12.0;
+
+    double meanSquareToLufs(double meanSquare) {
+        return loudnessOffset + 10.0 * std::log10(meanSquare);
+    }
+
+    double lufsToMeanSquare(double lufs) {
+        return std::pow(10.0, (lufs - loudnessOffset) / 10.0);
+    }
+}
+
+LoudnessMeter::LoudnessMeter() {
+    // a windowed sinc with its centre on a tap, so phase 0 passes the samples through, every
+    // phase is normalised to unity gain at DC
+    constexpr int numTaps = oversampling * tapsPerPhase;
+    constexpr int centre = numTaps / 2;
+
+    for (int phase = 0; phase < oversampling; ++phase) {
+        double sum = 0.0;
+
+        for (int tap = 0; tap < tapsPerPhase; ++tap) {
+            const int index = oversampling * (tapsPerPhase - 1 - tap) + phase; // oldest sample first
+            const double t = (double) (index - centre) / oversampling;
+            const double sinc = t == 0.0 ? 1.0 : std::sin(MathConstants<double>::pi * t) / (MathConstants<double>::pi * t);
+            const double window = 0.5 + 0.5 * std::cos(MathConstants<double>::pi * t / (tapsPerPhase / 2 + 0.5));
+
+            tapCoefficients[tap][phase] = (float) (sinc * window);
+            sum += sinc * window;
+        }
+
+        for (int tap = 0; tap < tapsPerPhase; ++tap) {
+            tapCoefficients[tap][phase] = (float) (tapCoefficients[tap][phase] / sum);
+        }
+    }
+}
+
+LoudnessMeter::~LoudnessMeter() {}
+
+void LoudnessMeter::reset(double newSampleRate) {
+    if (newSampleRate != sampleRate) {
+        sampleRate = newSampleRate;
+        stepSize = jmax(1, roundToInt(newSampleRate * 0.1));
+
+        // the two K-weighting stages of BS.1770, redesigned for the sample rate by the bilinear transform
+        {
+            const double gainDb = 3.999843853973347, q = 0.7071752369554196;
+            const double k = std::tan(MathConstants<double>::pi * 1681.974450955533 / newSampleRate);
+            const double vh = std::pow(10.0, gainDb / 20.0), vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+
+            shelf.b0 = (vh + vb * k / q + k * k) / a0;
+            shelf.b1 = 2.0 * (k * k - vh) / a0;
+            shelf.b2 = (vh - vb * k / q + k * k) / a0;
+            shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+            shelf.a2 = (1.0 - k / q + k * k) / a0;
+        }
+        {
+            const double q = 0.5003270373238773;
+            const double k = std::tan(MathConstants<double>::pi * 38.13547087602444 / newSampleRate);
+            const double a0 = 1.0 + k / q + k * k;
+
+            highPass.b0 = 1.0;
+            highPass.b1 = -2.0;
+            highPass.b2 = 1.0;
+            highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+            highPass.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    for (auto &states: filterStates) {
+        states.fill(0.0);
+    }
+    history.clear();
+    stepFill = 0;
+    stepEnergy = 0.0;
+    stepMeanSquares.clear(); // keeps its capacity for the next track
+    truePeak = 0.0f;
+}
+
+void LoudnessMeter::process(const AudioBuffer<float> &block, int numSamples) {
+    const int numChannels = jmin(block.getNumChannels(), maxChannels);
+    if (numChannels == 0 || numSamples <= 0) {
+        return;
+    }
+
+    if ((int) filtered.size() < numSamples) {
+        // only on the first track, blocks keep their size
+        filtered.resize((size_t) numSamples);
+        history.setSize(maxChannels, tapsPerPhase - 1 + numSamples, true, true);
+    }
+
+    // the steps this block finishes or adds to, the first one may have been started by the last block
+    const int firstStepLength = stepSize - stepFill;
+    const int numSteps = numSamples <= firstStepLength ? 1 : 2 + (numSamples - firstStepLength - 1) / stepSize;
+    blockStepEnergies.assign((size_t) numSteps, 0.0);
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        const float *input = block.getReadPointer(channel);
+        auto &states = filterStates[(size_t) channel];
+
+        for (int i = 0; i < numSamples; ++i) {
+            const double x = input[i];
+
+            const double y1 = shelf.b0 * x + states[0];
+            states[0] = shelf.b1 * x - shelf.a1 * y1 + states[1];
+            states[1] = shelf.b2 * x - shelf.a2 * y1;
+
+            const double y2 = highPass.b0 * y1 + states[2];
+            states[2] = highPass.b1 * y1 - highPass.a1 * y2 + states[3];
+            states[3] = highPass.b2 * y1 - highPass.a2 * y2;
+
+            filtered[(size_t) i] = (float) y2;
+        }
+
+        int start = 0, step = 0, length = firstStepLength;
+        while (start < numSamples) {
+            const int count = jmin(length, numSamples - start);
+            blockStepEnergies[(size_t) step++] += dot(filtered.data() + start, filtered.data() + start, count);
+            start += count;
+            length = stepSize;
+        }
+
+        truePeak = jmax(truePeak, getTruePeak(channel, input, numSamples));
+    }
+
+    int start = 0, step = 0, length = firstStepLength;
+    while (start < numSamples) {
+        const int count = jmin(length, numSamples - start);
+        stepEnergy += blockStepEnergies[(size_t) step++];
+        stepFill += count;
+        start += count;
+        length = stepSize;
+
+        if (stepFill == stepSize) {
+            stepMeanSquares.push_back((float) (stepEnergy / stepSize));
+            stepEnergy = 0.0;
+            stepFill = 0;
+        }
+    }
+}
+
+float LoudnessMeter::getTruePeak(int channel, const float *samples, int numSamples) {
+    constexpr int historyLength = tapsPerPhase - 1;
+    float *buffer = history.getWritePointer(channel);
+    FloatVectorOperations::copy(buffer + historyLength, samples, numSamples);
+
+    // each sample is multiplied into all four phases at once, so there are no sums across lanes,
+    // and four samples are worked on side by side so the additions don't wait on each other
+    float peak = 0.0f;
+    int i = 0;
+
+#if JUCE_INTEL
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 peaks = _mm_setzero_ps();
+
+    for (; i + 4 <= numSamples; i += 4) {
+        __m128 phases0 = _mm_setzero_ps(), phases1 = _mm_setzero_ps(), phases2 = _mm_setzero_ps(), phases3 = _mm_setzero_ps();
+        for (int tap = 0; tap < tapsPerPhase; ++tap) {
+            const __m128 coefficients = _mm_load_ps(tapCoefficients[tap]);
+            phases0 = _mm_add_ps(phases0, _mm_mul_ps(_mm_set1_ps(buffer[i + tap]), coefficients));
+            phases1 = _mm_add_ps(phases1, _mm_mul_ps(_mm_set1_ps(buffer[i + tap + 1]), coefficients));
+            phases2 = _mm_add_ps(phases2, _mm_mul_ps(_mm_set1_ps(buffer[i + tap + 2]), coefficients));
+            phases3 = _mm_add_ps(phases3, _mm_mul_ps(_mm_set1_ps(buffer[i + tap + 3]), coefficients));
+        }
+        peaks = _mm_max_ps(peaks, _mm_max_ps(_mm_max_ps(_mm_andnot_ps(signMask, phases0), _mm_andnot_ps(signMask, phases1)),
+                                             _mm_max_ps(_mm_andnot_ps(signMask, phases2), _mm_andnot_ps(signMask, phases3))));
+    }
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, peaks);
+    peak = jmax(jmax(lanes[0], lanes[1]), jmax(lanes[2], lanes[3]));
+#elif JUCE_ARM && defined(__ARM_NEON)
+    float32x4_t peaks = vdupq_n_f32(0.0f);
+
+    for (; i + 4 <= numSamples; i += 4) {
+        float32x4_t phases0 = vdupq_n_f32(0.0f), phases1 = vdupq_n_f32(0.0f), phases2 = vdupq_n_f32(0.0f), phases3 = vdupq_n_f32(0.0f);
+        for (int tap = 0; tap < tapsPerPhase; ++tap) {
+            const float32x4_t coefficients = vld1q_f32(tapCoefficients[tap]);
+            phases0 = vmlaq_n_f32(phases0, coefficients, buffer[i + tap]);
+            phases1 = vmlaq_n_f32(phases1, coefficients, buffer[i + tap + 1]);
+            phases2 = vmlaq_n_f32(phases2, coefficients, buffer[i + tap + 2]);
+            phases3 = vmlaq_n_f32(phases3, coefficients, buffer[i + tap + 3]);
+        }
+        peaks = vmaxq_f32(peaks, vmaxq_f32(vmaxq_f32(vabsq_f32(phases0), vabsq_f32(phases1)),
+                                           vmaxq_f32(vabsq_f32(phases2), vabsq_f32(phases3))));
+    }
+
+    float lanes[4];
+    vst1q_f32(lanes, peaks);
+    peak = jmax(jmax(lanes[0], lanes[1]), jmax(lanes[2], lanes[3]));
+#endif
+
+    // the tail, or everything without SIMD
+    for (; i < numSamples; ++i) {
+        for (int phase = 0; phase < oversampling; ++phase) {
+            float sum = 0.0f;
+            for (int tap = 0; tap < tapsPerPhase; ++tap) {
+                sum += buffer[i + tap] * tapCoefficients[tap][phase];
+            }
+            peak = jmax(peak, std::abs(sum));
+        }
+    }
+
+    // keep the end of the block for the start of the next one
+    std::memmove(buffer, buffer + numSamples, sizeof(float) * (size_t) historyLength);
+    return peak;
+}
+
+void LoudnessMeter::finish(TrackAnalysis &analysis) {
+    analysis.loudnessLufs = -std::numeric_limits<double>::infinity();
+    analysis.truePeakDb = truePeak > 0.0f ? 20.0 * std::log10((double) truePeak) : -std::numeric_limits<double>::infinity();
+
+    // 400 ms blocks overlapping by three quarters are four consecutive steps
+    const int numBlocks = (int) stepMeanSquares.size() - 3;
+    if (numBlocks <= 0) {
+        return; // shorter than one block
+    }
+
+    auto getBlockMeanSquare = [this](int blockIndex) {
+        const float *steps = stepMeanSquares.data() + blockIndex;
+        return ((double) steps[0] + steps[1] + steps[2] + steps[3]) * 0.25;
+    };
+
+    auto getGatedMean = [&](double threshold) {
+        double sum = 0.0;
+        int count = 0;
+        for (int blockIndex = 0; blockIndex < numBlocks; ++blockIndex) {
+            const double meanSquare = getBlockMeanSquare(blockIndex);
+            if (meanSquare > threshold) {
+                sum += meanSquare;
+                ++count;
+            }
+        }
+        return count > 0 ? sum / count : 0.0;
+    };
+
+    const double absoluteThreshold = lufsToMeanSquare(absoluteGateLufs);
+    const double ungatedMean = getGatedMean(absoluteThreshold);
+    if (ungatedMean <= 0.0) {
+        return; // silent
+    }
+
+    const double relativeThreshold = ungatedMean * std::pow(10.0, relativeGateLu / 10.0);
+    const double gatedMean = getGatedMean(jmax(absoluteThreshold, relativeThreshold));
+    analysis.loudnessLufs = meanSquareToLufs(gatedMean);
+}
+
+float LoudnessMeter::getNormalisationGain(const TrackAnalysis &analysis) {
+    if (!std::isfinite(analysis.loudnessLufs)) {
+        return 1.0f;
+    }
+
+    double gainDb = targetLufs - analysis.loudnessLufs;
+    if (std::isfinite(analysis.truePeakDb)) {
+        gainDb = jmin(gainDb, truePeakCeilingDb - analysis.truePeakDb);
+    }
+
+    return (float) Decibels::decibelsToGain(jlimit(minGainDb, maxGainDb, gainDb));
+}
+
+float LoudnessMeter::dot(const float *a, const float *b, int numSamples) {
+    float sum = 0.0f;
+    int i = 0;
+
+#if JUCE_INTEL
+    __m128 products = _mm_setzero_ps();
+
+    for (; i + 4 <= numSamples; i += 4) {
+        products = _mm_add_ps(products, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, products);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif JUCE_ARM && defined(__ARM_NEON)
+    float32x4_t products = vdupq_n_f32(0.0f);
+
+    for (; i + 4 <= numSamples; i += 4) {
+        products = vmlaq_f32(products, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+
+    float lanes[4];
+    vst1q_f32(lanes, products);
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+    // the tail, or everything without SIMD
+    for (; i < numSamples; ++i) {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+}
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    LoudnessMeter.h
+    Created: 17 Oct 2026 8:27:15pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "TrackAnalysis.h"
+
+using namespace juce;
+
+/**
+ * @class LoudnessMeter
+ * @brief Measures the integrated loudness and true peak of a track, as in ITU-R BS.1770 and EBU R128.
+ *
+ * Every channel is K-weighted by the two standard biquads, and the mean square is collected in
+ * 100 ms steps. At the end, overlapping 400 ms blocks are gated at -70 LUFS and then at 10 LU
+ * below the loudness of the blocks left, and the rest are averaged. The true peak is the largest
+ * magnitude of the signal oversampled four times by a 48-tap polyphase filter.
+ *
+ * The filters are recursive, so they run sample by sample. The energies are vectorised, and the
+ * four phases of the oversampling filter are computed together in one vector. A meter keeps its
+ * buffers between tracks. It is not thread safe, each worker uses its own.
+ */
+class LoudnessMeter {
+public:
+    static constexpr double targetLufs = -14.0; /**< Loudness every track is trimmed to. */
+    static constexpr double truePeakCeilingDb = -1.0; /**< Trims never push the true peak above this. */
+
+    /** Constructor. */
+    LoudnessMeter();
+
+    /** Destructor. */
+    ~LoudnessMeter();
+
+    /**
+     * @brief Start a new track.
+     * @param sampleRate The sample rate of the track.
+     */
+    void reset(double sampleRate);
+
+    /**
+     * @brief Feed the next block of the track.
+     * @param block The decoded audio, any number of channels.
+     * @param numSamples The number of samples in the block.
+     */
+    void process(const AudioBuffer<float> &block, int numSamples);
+
+    /**
+     * @brief Find the loudness of everything fed since the last reset.
+     * @param analysis Receives the integrated loudness and the true peak.
+     */
+    void finish(TrackAnalysis &analysis);
+
+    /**
+     * @brief Get the trim that brings a track to the target loudness.
+     *
+     * Quiet tracks are only raised as far as their true peak allows.
+     *
+     * @param analysis The analysis of the track.
+     * @return The linear gain, 1 for tracks without a measured loudness.
+     */
+    static float getNormalisationGain(const TrackAnalysis &analysis);
+
+private:
+    /**
+     * @struct Biquad
+     * @brief One K-weighting stage, transposed direct form II in double precision.
+     */
+    struct Biquad {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0; /**< Coefficients, a0 normalised to 1. */
+    };
+
+    /** Largest magnitude of one channel oversampled four times, the history carries over between blocks. */
+    float getTruePeak(int channel, const float *samples, int numSamples);
+
+    /** Get the dot product of two blocks. */
+    static float dot(const float *a, const float *b, int numSamples);
+
+    static constexpr int maxChannels = 8; /**< Channels measured, more are ignored. */
+    static constexpr int oversampling = 4; /**< True peak oversampling factor. */
+    static constexpr int tapsPerPhase = 12; /**< Taps of each phase of the oversampling filter. */
+
+    double sampleRate = 0.0; /**< Sample rate the filters were designed for. */
+    Biquad shelf; /**< Stage 1, the head's high shelf. */
+    Biquad highPass; /**< Stage 2, the RLB high-pass. */
+    std::array<std::array<double, 4>, maxChannels> filterStates{}; /**< Two states per stage per channel. */
+
+    /** Oversampling filter, oldest tap first, the phases of a tap side by side. */
+    alignas(16) float tapCoefficients[tapsPerPhase][oversampling];
+    AudioBuffer<float> history; /**< Last samples of each channel before the current block, then the block. */
+    std::vector<float> filtered; /**< K-weighted samples of the channel being processed. */
+
+    int stepSize = 0; /**< Samples in a 100 ms step. */
+    int stepFill = 0; /**< Samples in the current step. */
+    double stepEnergy = 0.0; /**< K-weighted energy of the current step, summed over the channels. */
+    std::vector<double> blockStepEnergies; /**< Energy of each step the current block touches. */
+    std::vector<float> stepMeanSquares; /**< Mean square of every finished step. */
+    float truePeak = 0.0f; /**< Largest oversampled magnitude so far. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
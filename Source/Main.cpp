@@ -1,99 +1,160 @@
-/*
-  ==============================================================================
-
-    This file contains the basic startup code for a JUCE application.
-
-  ==============================================================================
-*/
-
-#include <JuceHeader.h>
-#include "MainComponent.h"
-
-//==============================================================================
-class otoDecksApplication : public juce::JUCEApplication {
-public:
-    //==============================================================================
-    otoDecksApplication() {}
-
-    const juce::String getApplicationName() override { return ProjectInfo::projectName; }
-
-    const juce::String getApplicationVersion() override { return ProjectInfo::versionString; }
-
-    bool moreThanOneInstanceAllowed() override { return true; }
-
-    //==============================================================================
-    void initialise(const juce::String &commandLine) override {
-        // This method is where you should put your application's initialisation code..
-
-        mainWindow.reset(new MainWindow(getApplicationName()));
-    }
-
-    void shutdown() override {
-        // Add your application's shutdown code here..
-
-        mainWindow = nullptr; // (deletes our window)
-    }
-
-    //==============================================================================
-    void systemRequestedQuit() override {
-        // This is called when the app is being asked to quit: you can ignore this
-        // request and let the app carry on running, or call quit() to allow the app to close.
-        quit();
-    }
-
-    void anotherInstanceStarted(const juce::String &commandLine) override {
-        // When another instance of the app is launched while this one is running,
-        // this method is invoked, and the commandLine parameter tells you what
-        // the other instance's command-line arguments were.
-    }
-
-    //==============================================================================
-    /*
-        This class implements the desktop window that contains an instance of
-        our MainComponent class.
-    */
-    class MainWindow : public juce::DocumentWindow {
-    public:
-        MainWindow(juce::String name)
-                : DocumentWindow(name,
-                                 juce::Desktop::getInstance().getDefaultLookAndFeel()
-                                         .findColour(juce::ResizableWindow::backgroundColourId),
-                                 DocumentWindow::allButtons) {
-            setUsingNativeTitleBar(true);
-            setContentOwned(new MainComponent(), true);
-
-#if JUCE_IOS || JUCE_ANDROID
-            setFullScreen (true);
-#else
-            setResizable(true, true);
-            centreWithSize(getWidth(), getHeight());
-#endif
-
-            setVisible(true);
-        }
-
-        void closeButtonPressed() override {
-            // This is called when the user tries to close this window. Here, we'll just
-            // ask the app to quit when this happens, but you can change this to do
-            // whatever you need.
-            JUCEApplication::getInstance()->systemRequestedQuit();
-        }
-
-        /* Note: Be careful if you override any DocumentWindow methods - the base
-           class uses a lot of them, so by overriding you might break its functionality.
-           It's best to do all your work in your content component instead, but if
-           you really have to override any DocumentWindow methods, make sure your
-           subclass also calls the superclass's method.
-        */
-
-    private:
-        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainWindow)
-    };
-
-private:
-    std::unique_ptr<MainWindow> mainWindow;
-};
-
-//==============================================================================
-// This macro generates the main() routine that launches the app.
-START_JUCE_APPLICATION (otoDecksApplication)
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "MainComponent.h"
+#include "OfflineRenderer.h"
+#include "RealtimeSafetyChecker.h"
+
+//==============================================================================
+class otoDecksApplication : public juce::JUCEApplication {
+public:
+    //==============================================================================
+    otoDecksApplication() {}
+
+    const juce::String getApplicationName() override { return ProjectInfo::projectName; }
+
+    const juce::String getApplicationVersion() override { return ProjectInfo::versionString; }
+
+    bool moreThanOneInstanceAllowed() override { return true; }
+
+    //==============================================================================
+    void initialise(const juce::String &commandLine) override {
+        // This method is where you should put your application's initialisation code..
+
+        // --render session.json --out mix.wav renders a session offline, without a window or an audio device
+        const juce::ArgumentList arguments(getApplicationName(), commandLine);
+        if (arguments.containsOption("--render")) {
+            setApplicationReturnValue(renderOffline(arguments));
+            quit();
+            return;
+        }
+
+        mainWindow.reset(new MainWindow(getApplicationName()));
+    }
+
+    void shutdown() override {
+        // Add your application's shutdown code here..
+
+        mainWindow = nullptr; // (deletes our window)
+
+        if (RealtimeSafetyChecker::isEnabled()) {
+            RealtimeSafetyChecker::printSummary();
+        }
+    }
+
+    //==============================================================================
+    void systemRequestedQuit() override {
+        // This is called when the app is being asked to quit: you can ignore this
+        // request and let the app carry on running, or call quit() to allow the app to close.
+        quit();
+    }
+
+    void anotherInstanceStarted(const juce::String &commandLine) override {
+        // When another instance of the app is launched while this one is running,
+        // this method is invoked, and the commandLine parameter tells you what
+        // the other instance's command-line arguments were.
+    }
+
+    //==============================================================================
+    /*
+        This class implements the desktop window that contains an instance of
+        our MainComponent class.
+    */
+    class MainWindow : public juce::DocumentWindow {
+    public:
+        MainWindow(juce::String name)
+                : DocumentWindow(name,
+                                 juce::Desktop::getInstance().getDefaultLookAndFeel()
+                                         .findColour(juce::ResizableWindow::backgroundColourId),
+                                 DocumentWindow::allButtons) {
+            setUsingNativeTitleBar(true);
+            setContentOwned(new MainComponent(), true);
+
+#if JUCE_IOS || JUCE_ANDROID
+            setFullScreen (true);
+#else
+            setResizable(true, true);
+            centreWithSize(getWidth(), getHeight());
+#endif
+
+            setVisible(true);
+        }
+
+        void closeButtonPressed() override {
+            // This is called when the user tries to close this window. Here, we'll just
+            // ask the app to quit when this happens, but you can change this to do
+            // whatever you need.
+            JUCEApplication::getInstance()->systemRequestedQuit();
+        }
+
+        /* Note: Be careful if you override any DocumentWindow methods - the base
+           class uses a lot of them, so by overriding you might break its functionality.
+           It's best to do all your work in your content component instead, but if
+           you really have to override any DocumentWindow methods, make sure your
+           subclass also calls the superclass's method.
+        */
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainWindow)
+    };
+
+private:
+    /** Render the session named on the command line and report the realtime factor, returns the exit code. */
+    static int renderOffline(const juce::ArgumentList &arguments) {
+        const juce::File workingDirectory = juce::File::getCurrentWorkingDirectory();
+        const juce::String sessionPath = getOptionValue(arguments, "--render");
+        const juce::String outputPath = getOptionValue(arguments, "--out");
+
+        if (sessionPath.isEmpty() || outputPath.isEmpty()) {
+            std::cerr << "usage: otoDecks --render session.json --out mix.wav" << std::endl;
+            return 2;
+        }
+
+        OfflineRenderer renderer;
+        const bool rendered = renderer.render(workingDirectory.getChildFile(sessionPath),
+                                              workingDirectory.getChildFile(outputPath));
+        const auto &stats = renderer.getStats();
+
+        if (!rendered) {
+            std::cerr << "render failed: " << renderer.getError() << std::endl;
+            return 1;
+        }
+
+        std::cout << "rendered " << juce::String(stats.renderedSeconds, 2) << " s with " << stats.numEvents << " events in "
+                  << juce::String(stats.wallSeconds, 3) << " s: " << juce::String(stats.getRealtimeFactor(), 1) << "x realtime ("
+                  << juce::String(stats.getMixRealtimeFactor(), 1) << "x mixing only)" << std::endl;
+
+        // an RTSafety build fails the render if the mix did anything the audio thread mustn't, so CI can prove it doesn't
+        if (RealtimeSafetyChecker::isEnabled() && RealtimeSafetyChecker::getNumViolations() > 0) {
+            RealtimeSafetyChecker::printSummary();
+            return 4;
+        }
+        return 0;
+    }
+
+    /** Get the value of an option given as --option=value or as --option value. */
+    static juce::String getOptionValue(const juce::ArgumentList &arguments, juce::StringRef option) {
+        const juce::String value = arguments.getValueForOption(option);
+        if (value.isNotEmpty()) {
+            return value;
+        }
+
+        const int index = arguments.indexOfOption(option);
+        if (index >= 0 && index + 1 < arguments.size() && !arguments[index + 1].isOption()) {
+            return arguments[index + 1].text;
+        }
+        return {};
+    }
+
+    std::unique_ptr<MainWindow> mainWindow;
+};
+
+//==============================================================================
+// This macro generates the main() routine that launches the app.
+START_JUCE_APPLICATION (otoDecksApplication)
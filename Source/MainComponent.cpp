@@ -6,8 +6,52 @@ MainComponent::MainComponent() {
     // you add any child components.
     setSize(1000, 600);
 
-    // Some platforms require permissions to open input channels so request that
-    // here
+    // Register file formats enabled by JUCE
+    formatManager.registerBasicFormats();
+
+    // Start the thread that decodes ahead of the playhead for both decks
+    readAheadThread.startThread(Thread::Priority::high);
+
+    // Add both decks to the mixer once, restarting the audio device only prepares them again
+    mixer.addDeck(&playerLeft, MasterMixer::CrossfaderSide::left);
+    mixer.addDeck(&playerRight, MasterMixer::CrossfaderSide::right);
+
+    // Each deck syncs to the other, the mixer renders both on the audio thread
+    playerLeft.setSyncPartner(&playerRight);
+    playerRight.setSyncPartner(&playerLeft);
+
+    // Crossfader between the decks, double-click to centre it
+    addAndMakeVisible(crossfaderSlider);
+    crossfaderSlider.setSliderStyle(Slider::SliderStyle::LinearHorizontal);
+    crossfaderSlider.setRange(-1.0, 1.0);
+    crossfaderSlider.setValue(0.0, dontSendNotification);
+    crossfaderSlider.setDoubleClickReturnValue(true, 0.0);
+    crossfaderSlider.setTextBoxStyle(Slider::NoTextBox, false, 0, 0);
+    crossfaderSlider.onValueChange = [this] { mixer.setCrossfader((float) crossfaderSlider.getValue()); };
+
+    // Resampling quality of both decks, item ids are the DeckResampler::Quality values plus one
+    addAndMakeVisible(resamplerQualityBox);
+    resamplerQualityBox.addItem("Linear", (int) DeckResampler::Quality::linear + 1);
+    resamplerQualityBox.addItem("Cubic", (int) DeckResampler::Quality::cubic + 1);
+    resamplerQualityBox.addItem("Sinc", (int) DeckResampler::Quality::sinc + 1);
+    resamplerQualityBox.setSelectedId((int) DeckResampler::Quality::sinc + 1, dontSendNotification);
+    resamplerQualityBox.onChange = [this] {
+        const auto quality = (DeckResampler::Quality) (resamplerQualityBox.getSelectedId() - 1);
+        playerLeft.setResamplerQuality(quality);
+        playerRight.setResamplerQuality(quality);
+    };
+
+    // Time every callback and each deck in it, the meter shows the load and the xruns
+    mixer.setMonitor(&callbackMonitor);
+    addAndMakeVisible(loadLabel);
+    loadLabel.setColour(Label::textColourId, Colours::black);
+    addAndMakeVisible(logStatsButton);
+    logStatsButton.onClick = [this] { logAudioStats(); };
+    startTimerHz(4);
+
+    // Open the device last, it prepares the mixer straight away, so the decks, sync and the monitor
+    // must be set up by now. Some platforms require permissions to open input channels so request
+    // that here
     if (RuntimePermissions::isRequired(RuntimePermissions::recordAudio) &&
         !RuntimePermissions::isGranted(RuntimePermissions::recordAudio)) {
         RuntimePermissions::request(RuntimePermissions::recordAudio,
@@ -17,9 +61,6 @@ MainComponent::MainComponent() {
         setAudioChannels(2, 2);
     }
 
-    // Register file formats enabled by JUCE
-    formatManager.registerBasicFormats();
-
 // ***********************************************
 // *********** SELF WRITTEN CODE START ***********
 // ****slight change in the order of the code*****
@@ -53,27 +94,28 @@ MainComponent::MainComponent() {
 }
 
 MainComponent::~MainComponent() {
+    stopTimer();
     // This shuts down the audio device and clears the audio source.
     shutdownAudio();
 }
 
 //==============================================================================
 void MainComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
-    playerLeft.prepareToPlay(samplesPerBlockExpected, sampleRate);
-    playerRight.prepareToPlay(samplesPerBlockExpected, sampleRate);
-
-    mixerSource.addInputSource(&playerLeft, false);
-    mixerSource.addInputSource(&playerRight, false);
+    // prepares both players and allocates the mixer's buffers
+    mixer.prepareToPlay(samplesPerBlockExpected, sampleRate);
+    callbackMonitor.prepare(sampleRate, mixer.getNumDecks());
 }
 
 void MainComponent::getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) {
-    mixerSource.getNextAudioBlock(bufferToFill);
+    // in RTSafety builds anything that may block from here down is reported
+    const RealtimeSafetyChecker::ScopedRealtime realtime;
+    callbackMonitor.beginCallback();
+    mixer.getNextAudioBlock(bufferToFill);
+    callbackMonitor.endCallback(bufferToFill.numSamples);
 }
 
 void MainComponent::releaseResources() {
-    playerLeft.releaseResources();
-    playerRight.releaseResources();
-    mixerSource.releaseResources();
+    mixer.releaseResources();
 }
 
 //==============================================================================
@@ -86,8 +128,46 @@ void MainComponent::paint(Graphics &g) {
 void MainComponent::resized() {
     deckGUILeft.setBounds(0, 0, getWidth() / 2, getHeight() / 2);
     deckGUIRight.setBounds(getWidth() / 2, 0, getWidth() / 2, getHeight() / 2);
-    playlistComponent.setBounds(0, getHeight() / 2, getWidth(), getHeight() / 2);
+    crossfaderSlider.setBounds(getWidth() / 4, getHeight() / 2, getWidth() / 2, 30);
+    resamplerQualityBox.setBounds(getWidth() * 3 / 4 + 10, getHeight() / 2 + 4, getWidth() / 4 - 20, 22);
+    loadLabel.setBounds(10, getHeight() / 2 + 4, getWidth() / 4 - 100, 22);
+    logStatsButton.setBounds(getWidth() / 4 - 85, getHeight() / 2 + 4, 75, 22);
+    playlistComponent.setBounds(0, getHeight() / 2 + 30, getWidth(), getHeight() / 2 - 30);
 }
 // ***********************************************
 // *********** SELF WRITTEN CODE END *************
-// ***********************************************
\ No newline at end of file
+// ***********************************************
+//==============================================================================
+void MainComponent::timerCallback() {
+    // the peak since the last update shows short spikes the smoothed load hides
+    const float peakLoad = callbackMonitor.takePeakLoad();
+    const int numXruns = callbackMonitor.getNumXruns();
+
+    loadLabel.setText("CPU " + String(roundToInt(callbackMonitor.getLoad() * 100.0f)) + "% (peak "
+                      + String(roundToInt(peakLoad * 100.0f)) + "%), " + String(numXruns) + " xruns",
+                      dontSendNotification);
+    loadLabel.setColour(Label::textColourId, numXruns > 0 || peakLoad > 0.8f ? Colours::darkred : Colours::black);
+
+    // keep the audio thread's xrun queue from filling up between logs
+    callbackMonitor.collectXruns();
+}
+
+void MainComponent::logAudioStats() {
+    String report = callbackMonitor.createReport();
+
+    const DJAudioPlayer *players[] = { &playerLeft, &playerRight };
+    for (int deck = 0; deck < 2; ++deck) {
+        report << "deck " << (deck + 1) << " read-ahead: " << roundToInt(players[deck]->getReadAheadFillLevel() * 100.0)
+               << "% full, " << players[deck]->getReadAheadUnderruns() << " underruns\n";
+    }
+
+    const File logFile = getStatsLogFile();
+    logFile.getParentDirectory().createDirectory();
+    logFile.appendText(report + "\n");
+}
+
+File MainComponent::getStatsLogFile() {
+    return File::getSpecialLocation(File::userApplicationDataDirectory)
+            .getChildFile("otoDecks")
+            .getChildFile("audio-stats.log");
+}
@@ -1,71 +1,97 @@
-#pragma once
-
-#include <JuceHeader.h>
-#include "DJAudioPlayer.h"
-#include "DeckGUI.h"
-#include "PlaylistComponent.h"
-
-/**
- * @class MainComponent
- * @brief The main component of the application, hosting controls and content.
- *
- * This component lives inside the main window and contains controls and content
- * for the application. It includes audio players, playlist components, and GUI elements.
- */
-class MainComponent : public AudioAppComponent {
-public:
-    /** Constructor. */
-    MainComponent();
-
-    /** Destructor. */
-    ~MainComponent() override;
-
-    /**
-     * @brief Prepare to play audio.
-     * @param samplesPerBlockExpected The number of samples per block expected.
-     * @param sampleRate The sample rate of the audio.
-     */
-    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
-
-    /**
-     * @brief Get the next audio block for playback.
-     * @param bufferToFill The buffer to fill with audio data.
-     */
-    void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override;
-
-    /** Release audio resources. */
-    void releaseResources() override;
-
-    /**
-     * @brief Paint method for rendering the component.
-     * @param g The Graphics object used for rendering.
-     */
-    void paint(Graphics &g) override;
-
-    /** Resized method called when the component is resized. */
-    void resized() override;
-
-private:
-    AudioFormatManager formatManager; /**< Audio format manager for handling audio file formats. */
-    AudioThumbnailCache thumbCache{ 100 }; /**< Cache for up to 100 audio thumbnails. */
-
-    int channelL = 0; /**< Left channel index. */
-    int channelR = 1; /**< Right channel index. */
-
-    PlaylistComponent playlistComponent{ formatManager }; /**< Playlist component. */
-    DJAudioPlayer playerLeft{ formatManager }; /**< Left audio player. */
-    DeckGUI deckGUILeft{ &playerLeft, &playlistComponent, formatManager, thumbCache, channelL }; /**< Left deck GUI. */
-
-    DJAudioPlayer playerRight{ formatManager }; /**< Right audio player. */
-    DeckGUI deckGUIRight{ &playerRight, &playlistComponent, formatManager, thumbCache, channelR }; /**< Right deck GUI. */
-
-    // Labels of the GUI
-    Label waveformLabel; /**< Label for the waveform display. */
-    Label posLabel; /**< Label for position information. */
-    Label widgetLabel; /**< Label for widget information. */
-    Label playlistLabel; /**< Label for the playlist. */
-
-    MixerAudioSource mixerSource; /**< Mixer audio source for combining left and right channels. */
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
-};
+#pragma once
+
+#include <JuceHeader.h>
+#include "DJAudioPlayer.h"
+#include "DeckGUI.h"
+#include "PlaylistComponent.h"
+#include "DecodedTrackCache.h"
+#include "DiskThumbnailCache.h"
+#include "MasterMixer.h"
+#include "AudioCallbackMonitor.h"
+#include "RealtimeSafetyChecker.h"
+
+/**
+ * @class MainComponent
+ * @brief The main component of the application, hosting controls and content.
+ *
+ * This component lives inside the main window and contains controls and content
+ * for the application. It includes audio players, playlist components, and GUI elements.
+ *
+ * Every audio callback is timed by an AudioCallbackMonitor. A meter shows the load of the audio
+ * thread and the number of xruns, and the stats can be appended to a log file at any time.
+ */
+class MainComponent : public AudioAppComponent,
+                      private Timer {
+public:
+    /** Constructor. */
+    MainComponent();
+
+    /** Destructor. */
+    ~MainComponent() override;
+
+    /**
+     * @brief Prepare to play audio.
+     * @param samplesPerBlockExpected The number of samples per block expected.
+     * @param sampleRate The sample rate of the audio.
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /**
+     * @brief Get the next audio block for playback.
+     * @param bufferToFill The buffer to fill with audio data.
+     */
+    void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override;
+
+    /** Release audio resources. */
+    void releaseResources() override;
+
+    /**
+     * @brief Paint method for rendering the component.
+     * @param g The Graphics object used for rendering.
+     */
+    void paint(Graphics &g) override;
+
+    /** Resized method called when the component is resized. */
+    void resized() override;
+
+private:
+    /** Update the load meter and collect new xruns. */
+    void timerCallback() override;
+
+    /** Append the callback stats and the read-ahead state of each deck to the stats log. */
+    void logAudioStats();
+
+    /** Get the file the stats are logged to. */
+    static File getStatsLogFile();
+
+    AudioFormatManager formatManager; /**< Audio format manager for handling audio file formats. */
+    DiskThumbnailCache thumbCache{ 100 }; /**< Thumbnails saved on disk within the default budget, up to 100 of them kept in memory. */
+    TimeSliceThread readAheadThread{ "Deck read-ahead" }; /**< Streaming thread shared by both decks. */
+    DecodedTrackCache trackCache{ DecodedTrackCache::getDefaultMemoryBudget() }; /**< Decoded tracks shared by both decks. */
+
+    int channelL = 0; /**< Left channel index. */
+    int channelR = 1; /**< Right channel index. */
+
+    PlaylistComponent playlistComponent{ formatManager, thumbCache }; /**< Playlist component. */
+    DJAudioPlayer playerLeft{ formatManager, readAheadThread, trackCache }; /**< Left audio player. */
+    DeckGUI deckGUILeft{ &playerLeft, &playlistComponent, formatManager, thumbCache, trackCache, channelL }; /**< Left deck GUI. */
+
+    DJAudioPlayer playerRight{ formatManager, readAheadThread, trackCache }; /**< Right audio player. */
+    DeckGUI deckGUIRight{ &playerRight, &playlistComponent, formatManager, thumbCache, trackCache, channelR }; /**< Right deck GUI. */
+
+    // Labels of the GUI
+    Label waveformLabel; /**< Label for the waveform display. */
+    Label posLabel; /**< Label for position information. */
+    Label widgetLabel; /**< Label for widget information. */
+    Label playlistLabel; /**< Label for the playlist. */
+
+    MasterMixer mixer; /**< Sums both decks through the crossfader. */
+    Slider crossfaderSlider; /**< Crossfader between the left and right deck. */
+    ComboBox resamplerQualityBox; /**< Resampling quality used by both decks. */
+
+    AudioCallbackMonitor callbackMonitor; /**< Times every audio callback and detects xruns. */
+    Label loadLabel; /**< Load of the audio thread and number of xruns. */
+    TextButton logStatsButton{ "Log stats" }; /**< Appends the callback stats to the stats log. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
+};
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    MasterMixer.cpp
+    Created: 17 Oct 2026 4:47:31pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Precompute the constant-power crossfader curve - DONE
+ * 2. Allocate the per-deck scratch buffers once in prepareToPlay - DONE
+ * 3. Combine trims and crossfader into smoothed per-deck gains - DONE
+ * 4. Add each deck to the output with a SIMD gain ramp - DONE
+ * 5. Time each deck into the callback monitor - DONE
+ * 6. Assert that decks and the monitor are only set before audio starts - DONE
+ * 7. Leave trims to the decks, which already apply them - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "MasterMixer.h"
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#elif JUCE_ARM && defined(__ARM_NEON)
+ #include <arm_neon.h>
+#endif
+
+MasterMixer::MasterMixer() {
+    // constant power: the squared gains of both sides always add up to 1, so the middle sits at -3 dB
+    for (int i = 0; i <= curveSize; ++i) {
+        fadeOutCurve[(size_t) i] = std::cos((float) i / (float) curveSize * MathConstants<float>::halfPi);
+    }
+}
+
+MasterMixer::~MasterMixer() {}
+
+int MasterMixer::addDeck(AudioSource *source, CrossfaderSide side) {
+    // the audio thread reads the decks without a lock, so they can only be added before it starts
+    jassert(scratchSize == 0);
+
+    if (source == nullptr || numDecks >= maxDecks) {
+        return -1;
+    }
+
+    decks[(size_t) numDecks].source = source;
+    decks[(size_t) numDecks].side = side;
+    return numDecks++;
+}
+
+void MasterMixer::setCrossfader(float position) {
+    crossfader = jlimit(-1.0f, 1.0f, position);
+}
+
+void MasterMixer::setMonitor(AudioCallbackMonitor *newMonitor) {
+    jassert(scratchSize == 0);
+    monitor = newMonitor;
+}
+
+int MasterMixer::getNumDecks() const {
+    return numDecks;
+}
+
+float MasterMixer::getCrossfaderGain(CrossfaderSide side, float position) const {
+    if (side == CrossfaderSide::none) {
+        return 1.0f;
+    }
+
+    // the right side is the left side's curve read backwards
+    const float amount = (jlimit(-1.0f, 1.0f, position) + 1.0f) * 0.5f;
+    const float index = (side == CrossfaderSide::left ? amount : 1.0f - amount) * (float) curveSize;
+    const int i = jmin((int) index, curveSize - 1);
+    return jmap(index - (float) i, fadeOutCurve[(size_t) i], fadeOutCurve[(size_t) i + 1]);
+}
+
+void MasterMixer::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    scratchSize = jmax(1, samplesPerBlockExpected);
+
+    for (int i = 0; i < numDecks; ++i) {
+        Deck &deck = decks[(size_t) i];
+        deck.source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+        deck.scratch.setSize(numScratchChannels, scratchSize);
+
+        deck.gain.reset(sampleRate, rampSeconds);
+        deck.gain.setCurrentAndTargetValue(getCrossfaderGain(deck.side, crossfader.load()));
+    }
+}
+
+void MasterMixer::getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) {
+    bufferToFill.clearActiveBufferRegion();
+
+    if (scratchSize <= 0) {
+        return;
+    }
+
+    // the device may send a larger block than it announced, mix it in pieces instead of reallocating
+    for (int done = 0; done < bufferToFill.numSamples; done += scratchSize) {
+        mixChunk(*bufferToFill.buffer, bufferToFill.startSample + done, jmin(scratchSize, bufferToFill.numSamples - done));
+    }
+}
+
+void MasterMixer::mixChunk(AudioBuffer<float> &output, int startSample, int numSamples) {
+    const float crossfaderPosition = crossfader.load();
+
+    for (int i = 0; i < numDecks; ++i) {
+        Deck &deck = decks[(size_t) i];
+
+        // render the deck into its own scratch buffer
+        AudioSourceChannelInfo info(&deck.scratch, 0, numSamples);
+        const int64 startTicks = monitor != nullptr ? Time::getHighResolutionTicks() : 0;
+        deck.source->getNextAudioBlock(info);
+        if (monitor != nullptr) {
+            monitor->addDeckTime(i, Time::getHighResolutionTicks() - startTicks);
+        }
+
+        deck.gain.setTargetValue(getCrossfaderGain(deck.side, crossfaderPosition));
+        const float startGain = deck.gain.getCurrentValue();
+        const float endGain = deck.gain.skip(numSamples);
+
+        if (startGain == 0.0f && endGain == 0.0f) {
+            continue; // faded out completely, the deck still runs so its playhead keeps moving
+        }
+
+        for (int channel = 0; channel < output.getNumChannels(); ++channel) {
+            addWithGainRamp(output.getWritePointer(channel, startSample),
+                            deck.scratch.getReadPointer(channel % numScratchChannels), numSamples, startGain, endGain);
+        }
+    }
+}
+
+void MasterMixer::releaseResources() {
+    for (int i = 0; i < numDecks; ++i) {
+        decks[(size_t) i].source->releaseResources();
+    }
+}
+
+void MasterMixer::addWithGainRamp(float *dest, const float *source, int numSamples, float startGain, float endGain) {
+    if (numSamples <= 0) {
+        return;
+    }
+
+    if (startGain == endGain) {
+        FloatVectorOperations::addWithMultiply(dest, source, startGain, numSamples);
+        return;
+    }
+
+    const float step = (endGain - startGain) / (float) numSamples;
+    int i = 0;
+
+#if JUCE_INTEL
+    __m128 gain = _mm_setr_ps(startGain, startGain + step, startGain + 2 * step, startGain + 3 * step);
+    const __m128 gainStep = _mm_set1_ps(4 * step);
+
+    for (; i + 4 <= numSamples; i += 4) {
+        const __m128 sum = _mm_add_ps(_mm_loadu_ps(dest + i), _mm_mul_ps(_mm_loadu_ps(source + i), gain));
+        _mm_storeu_ps(dest + i, sum);
+        gain = _mm_add_ps(gain, gainStep);
+    }
+#elif JUCE_ARM && defined(__ARM_NEON)
+    const float firstGains[4] = { startGain, startGain + step, startGain + 2 * step, startGain + 3 * step };
+    float32x4_t gain = vld1q_f32(firstGains);
+    const float32x4_t gainStep = vdupq_n_f32(4 * step);
+
+    for (; i + 4 <= numSamples; i += 4) {
+        vst1q_f32(dest + i, vmlaq_f32(vld1q_f32(dest + i), vld1q_f32(source + i), gain));
+        gain = vaddq_f32(gain, gainStep);
+    }
+#endif
+
+    // the tail, or everything without SIMD
+    for (; i < numSamples; ++i) {
+        dest[i] += source[i] * (startGain + step * (float) i);
+    }
+}
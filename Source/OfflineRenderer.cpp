@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.cpp
+    Created: 17 Oct 2026 9:04:30pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Read the render settings and the timed events of a JSON session - DONE
+ * 2. Drive both decks and the mixer offline, splitting blocks at every event - DONE
+ * 3. Write the mix to a WAV file - DONE
+ * 4. Measure the realtime factor, with and without writing the file - DONE
+ * 5. Check the mix for real-time safety like the audio callback - DONE
+ * 6. Trim the deck itself, on the exact frame of the event - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+#include "RealtimeSafetyChecker.h"
+
+namespace {
+    /** How long the render carries on after the last event when the session has no length. */
+    constexpr double defaultTailSeconds = 10.0;
+
+    /** Actions of a deck, the only other action is the mixer's crossfade. */
+    const char *const deckActions[] = { "load", "cue", "play", "stop", "gain", "speed", "keyLock", "sync", "trim" };
+
+    /** Check whether an action is one of a deck's. */
+    bool isDeckAction(const String &action) {
+        for (auto *deckAction : deckActions) {
+            if (action == deckAction) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+double OfflineRenderer::Stats::getRealtimeFactor() const {
+    return wallSeconds > 0.0 ? renderedSeconds / wallSeconds : 0.0;
+}
+
+double OfflineRenderer::Stats::getMixRealtimeFactor() const {
+    return mixSeconds > 0.0 ? renderedSeconds / mixSeconds : 0.0;
+}
+
+OfflineRenderer::OfflineRenderer() {
+    formatManager.registerBasicFormats();
+
+    playerLeft.setOfflineRendering(true);
+    playerRight.setOfflineRendering(true);
+
+    // the same chain as the app: both decks through the crossfader, each syncing to the other
+    mixer.addDeck(&playerLeft, MasterMixer::CrossfaderSide::left);
+    mixer.addDeck(&playerRight, MasterMixer::CrossfaderSide::right);
+    playerLeft.setSyncPartner(&playerRight);
+    playerRight.setSyncPartner(&playerLeft);
+}
+
+OfflineRenderer::~OfflineRenderer() {}
+
+bool OfflineRenderer::render(const File &sessionFile, const File &outputFile) {
+    stats = {};
+    error = {};
+
+    if (!parseSession(sessionFile)) {
+        return false;
+    }
+
+    // a FileOutputStream appends, so an old mix is removed first
+    if (!outputFile.deleteFile()) {
+        return fail("can't replace " + outputFile.getFullPathName());
+    }
+
+    std::unique_ptr<OutputStream> stream(outputFile.createOutputStream());
+    if (stream == nullptr) {
+        return fail("can't write " + outputFile.getFullPathName());
+    }
+
+    WavAudioFormat wavFormat;
+    std::unique_ptr<AudioFormatWriter> writer(wavFormat.createWriterFor(stream.get(), sampleRate, 2,
+                                                                        bitDepth, {}, 0));
+    if (writer == nullptr) {
+        return fail("can't write a " + String(bitDepth) + " bit WAV at " + String(sampleRate) + " Hz");
+    }
+    stream.release(); // the writer owns it now
+
+    mixer.prepareToPlay(blockSize, sampleRate);
+    playerLeft.setResamplerQuality(resamplerQuality);
+    playerRight.setResamplerQuality(resamplerQuality);
+
+    AudioBuffer<float> buffer(2, blockSize);
+    const double startMs = Time::getMillisecondCounterHiRes();
+    double mixMs = 0.0;
+    size_t nextEvent = 0;
+    bool ok = true;
+
+    for (int64 frame = 0; frame < lengthFrames;) {
+        // events are applied between blocks, the decks pick them up at the first frame of the next one
+        while (nextEvent < events.size() && events[nextEvent].frame <= frame) {
+            if (!applyEvent(events[nextEvent++])) {
+                ok = false;
+                break;
+            }
+            ++stats.numEvents;
+        }
+        if (!ok) {
+            break;
+        }
+
+        // the block ends early at the next event, so it lands on its exact frame
+        int64 blockEnd = jmin(frame + blockSize, lengthFrames);
+        if (nextEvent < events.size()) {
+            blockEnd = jmin(blockEnd, events[nextEvent].frame);
+        }
+        const int numSamples = (int) (blockEnd - frame);
+
+        const double mixStartMs = Time::getMillisecondCounterHiRes();
+        {
+            // only the mix is what the audio callback would run, loads and writing the file are not
+            const RealtimeSafetyChecker::ScopedRealtime realtime;
+            mixer.getNextAudioBlock(AudioSourceChannelInfo(&buffer, 0, numSamples));
+        }
+        mixMs += Time::getMillisecondCounterHiRes() - mixStartMs;
+
+        if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples)) {
+            ok = fail("can't write " + outputFile.getFullPathName());
+            break;
+        }
+
+        frame = blockEnd;
+        stats.renderedSeconds = (double) frame / sampleRate;
+    }
+
+    writer.reset(); // flushes the header with the final length
+    mixer.releaseResources();
+
+    stats.wallSeconds = (Time::getMillisecondCounterHiRes() - startMs) * 0.001;
+    stats.mixSeconds = mixMs * 0.001;
+    return ok;
+}
+
+bool OfflineRenderer::parseSession(const File &sessionFile) {
+    var session;
+    const auto parsed = JSON::parse(sessionFile.loadFileAsString(), session);
+    if (parsed.failed()) {
+        return fail(sessionFile.getFileName() + ": " + parsed.getErrorMessage());
+    }
+    if (!session.isObject()) {
+        return fail(sessionFile.getFileName() + ": the session must be a JSON object");
+    }
+
+    sampleRate = (double) session.getProperty("sampleRate", 44100.0);
+    blockSize = (int) session.getProperty("blockSize", 512);
+    bitDepth = (int) session.getProperty("bitDepth", 24);
+
+    if (sampleRate < 8000.0 || sampleRate > 384000.0) {
+        return fail("sampleRate must be between 8000 and 384000");
+    }
+    if (blockSize < 1 || blockSize > 65536) {
+        return fail("blockSize must be between 1 and 65536");
+    }
+
+    const String quality = session.getProperty("resamplerQuality", "sinc").toString();
+    if (quality == "linear") {
+        resamplerQuality = DeckResampler::Quality::linear;
+    } else if (quality == "cubic") {
+        resamplerQuality = DeckResampler::Quality::cubic;
+    } else if (quality == "sinc") {
+        resamplerQuality = DeckResampler::Quality::sinc;
+    } else {
+        return fail("resamplerQuality must be linear, cubic or sinc");
+    }
+
+    const auto *eventList = session.getProperty("events", var()).getArray();
+    if (eventList == nullptr) {
+        return fail(sessionFile.getFileName() + ": the session has no events array");
+    }
+
+    events.clear();
+    const File sessionDirectory = sessionFile.getParentDirectory();
+
+    for (int i = 0; i < eventList->size(); ++i) {
+        const var &item = eventList->getReference(i);
+        const String where = "event " + String(i) + ": ";
+
+        Event event;
+        const double time = (double) item.getProperty("time", -1.0);
+        if (time < 0.0) {
+            return fail(where + "time must be 0 or later");
+        }
+        event.frame = (int64) std::llround(time * sampleRate);
+        event.action = item.getProperty("action", "").toString();
+        event.value = (double) item.getProperty("value", 0.0);
+
+        if (event.action == "crossfade") {
+            events.push_back(event);
+            continue;
+        }
+
+        if (!isDeckAction(event.action)) {
+            return fail(where + "unknown action \"" + event.action + "\"");
+        }
+
+        event.deck = (int) item.getProperty("deck", -1);
+        if (event.deck < 0 || event.deck >= numDecks) {
+            return fail(where + "deck must be 0 or 1");
+        }
+
+        if (event.action == "load") {
+            const String track = item.getProperty("track", "").toString();
+            if (track.isEmpty()) {
+                return fail(where + "load needs a track");
+            }
+            event.track = sessionDirectory.getChildFile(track);
+
+            // an analysis only counts for what the session gives, the rest stays unmeasured
+            event.analysis.analysed = true;
+            event.analysis.bpm = (double) item.getProperty("bpm", 0.0);
+            event.analysis.firstBeatSeconds = (double) item.getProperty("firstBeat", 0.0);
+            if (item.hasProperty("loudness")) {
+                event.analysis.loudnessLufs = (double) item.getProperty("loudness", 0.0);
+            }
+            if (item.hasProperty("truePeak")) {
+                event.analysis.truePeakDb = (double) item.getProperty("truePeak", 0.0);
+            }
+        }
+
+        events.push_back(event);
+    }
+
+    // events at the same time keep the order they were written in
+    std::stable_sort(events.begin(), events.end(), [](const Event &a, const Event &b) {
+        return a.frame < b.frame;
+    });
+
+    const double length = (double) session.getProperty("length", -1.0);
+    if (length >= 0.0) {
+        lengthFrames = (int64) std::llround(length * sampleRate);
+    } else {
+        const int64 lastFrame = events.empty() ? 0 : events.back().frame;
+        lengthFrames = lastFrame + (int64) std::llround(defaultTailSeconds * sampleRate);
+    }
+
+    return true;
+}
+
+bool OfflineRenderer::applyEvent(const Event &event) {
+    if (event.deck < 0) {
+        mixer.setCrossfader((float) jlimit(-1.0, 1.0, event.value));
+        return true;
+    }
+
+    DJAudioPlayer &player = event.deck == 0 ? playerLeft : playerRight;
+    const String &action = event.action;
+
+    if (action == "load") {
+        // the deck keeps its old track if the new one doesn't open, which would silently spoil the mix
+        std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(event.track));
+        if (reader == nullptr) {
+            return fail("can't open " + event.track.getFullPathName());
+        }
+        reader.reset();
+
+        // offline the load has finished when this returns
+        player.loadURL(URL(event.track), false, event.analysis);
+    } else if (action == "cue") {
+        player.setPosition(jmax(0.0, event.value));
+    } else if (action == "play") {
+        player.start();
+    } else if (action == "stop") {
+        player.stop();
+    } else if (action == "gain") {
+        player.setGain(jlimit(0.0, 1.0, event.value));
+    } else if (action == "speed") {
+        player.setSpeed(jlimit(0.0, 100.0, event.value));
+    } else if (action == "keyLock") {
+        player.setKeyLock(event.value != 0.0);
+    } else if (action == "sync") {
+        player.setSync(event.value != 0.0);
+    } else if (action == "trim") {
+        player.setTrim(jmax(0.0, event.value));
+    }
+
+    return true;
+}
+
+bool OfflineRenderer::fail(const String &message) {
+    error = message;
+    return false;
+}
+
+const OfflineRenderer::Stats &OfflineRenderer::getStats() const {
+    return stats;
+}
+
+const String &OfflineRenderer::getError() const {
+    return error;
+}
@@ -0,0 +1,139 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.h
+    Created: 17 Oct 2026 9:04:30pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include "DJAudioPlayer.h"
+#include "MasterMixer.h"
+#include "DecodedTrackCache.h"
+
+using namespace juce;
+
+/**
+ * @class OfflineRenderer
+ * @brief Renders a scripted DJ session to a WAV file without an audio device.
+ *
+ * The session is a JSON file with the render settings and a list of timed events:
+ *
+ * @code
+ * {
+ *   "sampleRate": 44100, "blockSize": 512, "bitDepth": 24, "resamplerQuality": "sinc", "length": 300,
+ *   "events": [
+ *     { "time": 0, "deck": 0, "action": "load", "track": "a.mp3", "bpm": 124, "firstBeat": 0.12, "loudness": -8.5, "truePeak": 0.4 },
+ *     { "time": 0, "deck": 0, "action": "cue", "value": 32 },
+ *     { "time": 0, "deck": 0, "action": "play" },
+ *     { "time": 0, "action": "crossfade", "value": -1 },
+ *     { "time": 60, "deck": 1, "action": "sync", "value": 1 }
+ *   ]
+ * }
+ * @endcode
+ *
+ * Deck 0 is on the left of the crossfader and deck 1 on the right. The actions are load, cue (a
+ * position in seconds), play, stop, gain, speed, keyLock, sync, trim and crossfade. Tracks are
+ * relative to the session file, the analysis fields of a load are optional and without them the
+ * track plays untrimmed and can't sync. Without a length, the render ends 10 seconds after the
+ * last event.
+ *
+ * The session drives the same DJAudioPlayer and MasterMixer as the app, rendering offline: every
+ * block is split at the events inside it, so each event lands on its exact frame, and the result
+ * is the same on every run and every machine. The time spent mixing is measured apart from the
+ * time spent writing the file, so the realtime factor can be tracked as a performance test.
+ */
+class OfflineRenderer {
+public:
+    /**
+     * @struct Stats
+     * @brief How long a render took.
+     */
+    struct Stats {
+        double renderedSeconds = 0.0; /**< Length of the rendered audio. */
+        double wallSeconds = 0.0; /**< Time the whole render took, writing the file included. */
+        double mixSeconds = 0.0; /**< Time spent in the decks and the mixer. */
+        int numEvents = 0; /**< Events applied. */
+
+        /** Get how many times faster than realtime the session was rendered. */
+        double getRealtimeFactor() const;
+
+        /** Get how many times faster than realtime the decks and the mixer ran. */
+        double getMixRealtimeFactor() const;
+    };
+
+    /** Constructor. */
+    OfflineRenderer();
+
+    /** Destructor. */
+    ~OfflineRenderer();
+
+    /**
+     * @brief Render a session.
+     * @param sessionFile The JSON session.
+     * @param outputFile The WAV file to write, replaced if it exists.
+     * @return True if the whole session was rendered, otherwise getError() says why.
+     */
+    bool render(const File &sessionFile, const File &outputFile);
+
+    /**
+     * @brief Get the timings of the last render.
+     * @return The stats, zero before anything has been rendered.
+     */
+    const Stats &getStats() const;
+
+    /**
+     * @brief Get why the last render failed.
+     * @return The error, empty if it succeeded.
+     */
+    const String &getError() const;
+
+private:
+    /**
+     * @struct Event
+     * @brief One event of the session, at an output frame.
+     */
+    struct Event {
+        int64 frame = 0; /**< Output frame the event lands on. */
+        int deck = -1; /**< Deck the event is for, -1 for the mixer. */
+        String action; /**< What happens. */
+        double value = 0.0; /**< Position, gain, speed or crossfader value, or 1 and 0 to turn something on and off. */
+        File track; /**< Track of a load. */
+        TrackAnalysis analysis; /**< Analysis of a load, from the session. */
+    };
+
+    /** Read the settings and the events of a session, false with the error set if it is malformed. */
+    bool parseSession(const File &sessionFile);
+
+    /** Apply an event between two blocks, false with the error set if it fails. */
+    bool applyEvent(const Event &event);
+
+    /** Fail the render with an error. */
+    bool fail(const String &message);
+
+    static constexpr int numDecks = 2; /**< Decks of the session, left and right like the app. */
+
+    AudioFormatManager formatManager; /**< Formats the tracks are decoded with. */
+    TimeSliceThread readAheadThread{ "Offline read-ahead" }; /**< Never started, offline decks decode on the rendering thread. */
+    DecodedTrackCache trackCache{ DecodedTrackCache::getDefaultMemoryBudget() }; /**< Decoded tracks shared by both decks. */
+    DJAudioPlayer playerLeft{ formatManager, readAheadThread, trackCache }; /**< Deck 0. */
+    DJAudioPlayer playerRight{ formatManager, readAheadThread, trackCache }; /**< Deck 1. */
+    MasterMixer mixer; /**< Sums the decks through the crossfader. */
+
+    double sampleRate = 44100.0; /**< Output sample rate. */
+    int blockSize = 512; /**< Largest block rendered at once. */
+    int bitDepth = 24; /**< Bits per sample of the output. */
+    DeckResampler::Quality resamplerQuality = DeckResampler::Quality::sinc; /**< Resampling quality of both decks. */
+    int64 lengthFrames = 0; /**< Frames to render. */
+    std::vector<Event> events; /**< The session's events in time order. */
+
+    Stats stats; /**< Timings of the last render. */
+    String error; /**< Why the last render failed. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    PlayheadSnapshot.cpp
+    Created: 17 Oct 2026 3:52:40pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Publish playhead snapshots from the audio thread through a sequence lock - DONE
+ * 2. Read consistent snapshots on the message thread without blocking - DONE
+ * 3. Extrapolate the playhead between audio blocks - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "PlayheadSnapshot.h"
+
+namespace {
+    /** The furthest the playhead is extrapolated past the last snapshot, a few audio blocks. */
+    constexpr double maxExtrapolationMs = 100.0;
+}
+
+double PlayheadSnapshot::extrapolate(double nowMs) const {
+    if (!playing) {
+        return positionSeconds;
+    }
+
+    const double elapsedMs = jlimit(0.0, maxExtrapolationMs, nowMs - timestampMs);
+    return jmin(lengthSeconds, positionSeconds + elapsedMs * 0.001 * rate);
+}
+
+double PlayheadSnapshot::extrapolateRelative(double nowMs) const {
+    return lengthSeconds > 0.0 ? extrapolate(nowMs) / lengthSeconds : 0.0;
+}
+
+AtomicPlayhead::AtomicPlayhead() {}
+
+void AtomicPlayhead::publish(const PlayheadSnapshot &snapshot) {
+    const uint32 start = sequence.load(std::memory_order_relaxed);
+
+    // an odd sequence tells readers a write is in progress
+    sequence.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    positionSeconds.store(snapshot.positionSeconds, std::memory_order_relaxed);
+    lengthSeconds.store(snapshot.lengthSeconds, std::memory_order_relaxed);
+    rate.store(snapshot.rate, std::memory_order_relaxed);
+    playing.store(snapshot.playing, std::memory_order_relaxed);
+    timestampMs.store(snapshot.timestampMs, std::memory_order_relaxed);
+
+    sequence.store(start + 2, std::memory_order_release);
+}
+
+PlayheadSnapshot AtomicPlayhead::read() const {
+    PlayheadSnapshot snapshot;
+
+    for (;;) {
+        const uint32 before = sequence.load(std::memory_order_acquire);
+
+        snapshot.positionSeconds = positionSeconds.load(std::memory_order_relaxed);
+        snapshot.lengthSeconds = lengthSeconds.load(std::memory_order_relaxed);
+        snapshot.rate = rate.load(std::memory_order_relaxed);
+        snapshot.playing = playing.load(std::memory_order_relaxed);
+        snapshot.timestampMs = timestampMs.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // retry if a write started before or during the reads above
+        if ((before & 1) == 0 && sequence.load(std::memory_order_relaxed) == before) {
+            return snapshot;
+        }
+    }
+}
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    PlayheadSnapshot.h
+    Created: 17 Oct 2026 3:52:40pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+using namespace juce;
+
+/**
+ * @struct PlayheadSnapshot
+ * @brief Where a deck's playhead was at a given moment, as seen by the audio thread.
+ */
+struct PlayheadSnapshot {
+    double positionSeconds = 0.0; /**< Position in the track at the start of the audio block. */
+    double lengthSeconds = 0.0; /**< Length of the track, 0 if no track is loaded. */
+    double rate = 0.0; /**< Seconds of track played per second of real time while playing. */
+    bool playing = false; /**< Whether the transport is running. */
+    double timestampMs = 0.0; /**< Time::getMillisecondCounterHiRes() when the block started. */
+
+    /**
+     * @brief Estimate the playhead position at a later time.
+     *
+     * The estimate never runs more than a few blocks ahead of the last snapshot, so a stalled audio
+     * device freezes the playhead instead of letting it run away.
+     *
+     * @param nowMs The current Time::getMillisecondCounterHiRes().
+     * @return The estimated position in seconds.
+     */
+    double extrapolate(double nowMs) const;
+
+    /**
+     * @brief Estimate the playhead position relative to the length of the track.
+     * @param nowMs The current Time::getMillisecondCounterHiRes().
+     * @return The estimated position (0 to 1), or 0 if no track is loaded.
+     */
+    double extrapolateRelative(double nowMs) const;
+};
+
+/**
+ * @class AtomicPlayhead
+ * @brief Hands playhead snapshots from the audio thread to the UI without locks.
+ *
+ * A sequence lock: the audio thread is the only writer and never waits. Readers retry in the
+ * rare case that a snapshot is being written while they read it, so they always get a
+ * consistent snapshot without ever blocking the audio thread.
+ */
+class AtomicPlayhead {
+public:
+    /** Constructor. */
+    AtomicPlayhead();
+
+    /**
+     * @brief Publish a new snapshot, only ever called from the audio thread.
+     * @param snapshot The playhead state at the start of the current block.
+     */
+    void publish(const PlayheadSnapshot &snapshot);
+
+    /**
+     * @brief Read the latest snapshot from any thread.
+     * @return The most recently published snapshot.
+     */
+    PlayheadSnapshot read() const;
+
+private:
+    std::atomic<uint32> sequence{ 0 }; /**< Odd while a snapshot is being written. */
+    std::atomic<double> positionSeconds{ 0.0 }; /**< See PlayheadSnapshot::positionSeconds. */
+    std::atomic<double> lengthSeconds{ 0.0 }; /**< See PlayheadSnapshot::lengthSeconds. */
+    std::atomic<double> rate{ 0.0 }; /**< See PlayheadSnapshot::rate. */
+    std::atomic<bool> playing{ false }; /**< See PlayheadSnapshot::playing. */
+    std::atomic<double> timestampMs{ 0.0 }; /**< See PlayheadSnapshot::timestampMs. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AtomicPlayhead)
+};
@@ -1,205 +1,429 @@
-/*
-  ==============================================================================
-
-    PlaylistComponent.cpp
-    Created: 12 Jan 2024 3:31:32pm
-    Author:  JAMIUL ISLAM
-
- * Tasks:
- * - Set up playlist library table with columns - DONE
- * - Add search bar and listener - DONE
- * - Initialize and adjust the layout of components - DONE
- * - Implement methods for playlist table - DONE
- * - Handle button clicks for adding songs to the left or right player - DONE
- * - Implement file drag and drop functionality - DONE
- * - Handle files dropped into the playlist - DONE
- * - Handle changes in the search bar text - DONE
- * - Add selected song to the left or right player playlist - DONE
- * - Retrieve and store the duration of the audio file - DONE
- *
-
-  ==============================================================================
-*/
-
-#include <JuceHeader.h>
-#include "PlaylistComponent.h"
-
-//==============================================================================
-PlaylistComponent::PlaylistComponent(AudioFormatManager &_formatManager) : formatManager(_formatManager) {
-
-    // Set up playlist library table
-    tableComponent.getHeader().addColumn("Song Title", 1, 650);
-    tableComponent.getHeader().addColumn("Duration", 2, 100);
-    tableComponent.getHeader().addColumn("+ Left", 3, 100);
-    tableComponent.getHeader().addColumn("+ Right", 4, 100);
-    tableComponent.setModel(this);
-    addAndMakeVisible(tableComponent);
-
-    // Add search bar and listener
-    addAndMakeVisible(searchBar);
-    searchBar.addListener(this);
-
-    // Add label for search bar
-    addAndMakeVisible(searchLabel);
-    searchLabel.setText("Find Song: ", juce::dontSendNotification);
-}
-
-PlaylistComponent::~PlaylistComponent() {}
-
-void PlaylistComponent::paint(juce::Graphics &g) {}
-
-void PlaylistComponent::resized() {
-    // Adjust the layout of components when the size of the PlaylistComponent changes
-    double rowH = getHeight() / 8;
-    double colW = getWidth() / 6;
-
-    searchLabel.setBounds(0, 0, colW, rowH);
-    searchBar.setBounds(colW, 0, colW * 5, rowH);
-    tableComponent.setBounds(0, rowH, getWidth(), rowH * 7);
-}
-
-int PlaylistComponent::getNumRows() {
-    return interestedSongTitles.size();
-}
-
-void PlaylistComponent::paintRowBackground(Graphics &g, int rowNumber, int width, int height, bool rowIsSelected) {
-    // Paint the background of each row in the playlist
-    if (rowIsSelected) {
-        g.fillAll(Colours::orange);
-    } else {
-        g.fillAll(Colours::darkgrey);
-    }
-}
-
-void PlaylistComponent::paintCell(Graphics &g, int rowNumber, int columnId, int width, int height, bool rowIsSelected) {
-    // Paint the cells with song titles and durations in the playlist
-    if (columnId == 1) {
-        g.drawText(interestedSongTitles[rowNumber], 1, rowNumber, width - 4, height, Justification::centredLeft, true);
-    }
-
-    if (columnId == 2) {
-        g.drawText(std::to_string(interestedSongDuration[rowNumber]) + "s", 1, rowNumber, width - 4, height, Justification::centredLeft, true);
-    }
-}
-
-// ***********************************************
-// *********** SELF WRITTEN CODE START ***********
-// ***********************************************
-Component *PlaylistComponent::refreshComponentForCell(int rowNumber, int columnId, bool isRowSelected, Component *existingComponentToUpdate) {
-    // Refresh components for the "Add to Left" and "Add to Right" buttons in the playlist
-    if (columnId == 3 || columnId == 4) {
-        if (existingComponentToUpdate == nullptr) {
-            TextButton *btn = new TextButton{columnId == 3 ? "+ to Left" : "+ to Right"};
-            String id{std::to_string(columnId == 3 ? rowNumber : rowNumber + 1000)};
-            btn->setComponentID(id);
-            btn->addListener(this);
-            existingComponentToUpdate = btn;
-            btn->setColour(TextButton::buttonColourId, juce::Colours::darkslategrey);
-        }
-    }
-    return existingComponentToUpdate;
-}
-// ***********************************************
-// *********** SELF WRITTEN CODE END *************
-// ***********************************************
-
-void PlaylistComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {}
-
-void PlaylistComponent::getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) {}
-
-void PlaylistComponent::releaseResources() {}
-
-// ***********************************************
-// *********** SELF WRITTEN CODE START ***********
-// ***********************************************
-void PlaylistComponent::buttonClicked(Button *button) {
-    // Handle button clicks for adding songs to the left or right player
-    int id = std::stoi(button->getComponentID().toStdString());
-    if (id < 1000) {
-        addToDeckList(interestedSongs[id], 0);
-    } else {
-        addToDeckList(interestedSongs[id - 1000], 1);
-    }
-}
-
-bool PlaylistComponent::isInterestedInFileDrag(const StringArray &files) {
-    // Allow the application to accept file drag and drop
-    return true;
-}
-
-void PlaylistComponent::filesDropped(const StringArray &files, int x, int y) {
-    // Handle files dropped into the playlist
-    for (String filename: files) {
-        // Extract file information and update the playlist
-        std::string songPath = String(filename).toStdString(); // convert song path name to std::string
-        std::size_t audioFilePosStart = songPath.find_last_of("\\"); // find the last occurrence of "\"
-        std::size_t audioFilePosEnd = songPath.find_last_of("."); // find the last occurrence of "."
-        std::string extn = songPath.substr(audioFilePosEnd + 1, songPath.length() - audioFilePosEnd); // get the file extension
-        std::string file = songPath.substr(audioFilePosStart + 1, songPath.length() - audioFilePosStart - extn.size() - 2); // get the file name
-
-        inputSongs.push_back(songPath); // add to input songs
-        songTitles.push_back(file); // add to song titles
-
-        getAudioLen(URL{File{songPath}}); // get the duration of the audio file
-    }
-
-    // Update playlist table with the new content
-    interestedSongTitles = songTitles;
-    interestedSongs = inputSongs;
-    tableComponent.updateContent();
-}
-
-void PlaylistComponent::textEditorTextChanged(TextEditor &textEditor) {
-    // Handle changes in the search bar text
-    interestedSongTitles.clear(); // clear the interested song titles
-    interestedSongDuration.clear(); // clear the interested song durations
-    interestedSongs.clear(); // clear the interested songs
-
-    int pos = 0;
-    for (std::string track: songTitles) {
-        // Check substring of the song name against the search bar text
-        if (track.find(searchBar.getText().toStdString()) != std::string::npos) {
-            interestedSongTitles.push_back(songTitles[pos]); // add to interested song titles
-            interestedSongDuration.push_back(songDurations[pos]); // add to interested song durations
-            interestedSongs.push_back(inputSongs[pos]); // add to interested songs
-        }
-
-        ++pos;
-    }
-
-    // Update playlist table based on search results
-    tableComponent.updateContent();
-}
-
-void PlaylistComponent::addToDeckList(std::string filepath, int channel) {
-    // Add selected song to the left or right player playlist
-    if (channel == 0) {
-        playListL.push_back(filepath); // add to left deck
-    } else {
-        playListR.push_back(filepath); // add to right deck
-    }
-}
-
-void PlaylistComponent::getAudioLen(URL audioURL) {
-    // Retrieve and store the duration of the audio file
-    double songLength = 0.0;
-    auto *reader = formatManager.createReaderFor(audioURL.createInputStream(false));
-
-    if (reader != nullptr) {
-        // Create a new reader source and transport source
-        std::unique_ptr<AudioFormatReaderSource> newSource(new AudioFormatReaderSource(reader, true));
-        // Set the source of the transport source
-        transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
-        // Prepare the transport source
-        readerSource.reset(newSource.release());
-        // Get the length of the audio file
-        double songLength = transportSource.getLengthInSeconds();
-        // Store the duration of the audio file
-        songDurations.push_back(songLength);
-    }
-
-    interestedSongDuration = songDurations; // update the interested song durations
-}
-// ***********************************************
-// *********** SELF WRITTEN CODE END *************
+/*
+  ==============================================================================
+
+    PlaylistComponent.cpp
+    Created: 12 Jan 2024 3:31:32pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ * - Set up playlist library table with columns - DONE
+ * - Add search bar and listener - DONE
+ * - Initialize and adjust the layout of components - DONE
+ * - Implement methods for playlist table - DONE
+ * - Handle button clicks for adding songs to the left or right player - DONE
+ * - Implement file drag and drop functionality - DONE
+ * - Handle files dropped into the playlist - DONE
+ * - Handle changes in the search bar text - DONE
+ * - Add selected song to the left or right player playlist - DONE
+ * - Retrieve and store the duration of the audio file - DONE
+ * - Import dropped files and folders on worker threads with progress and cancel - DONE
+ * - Persist the library between sessions and rescan changed files - DONE
+ * - Keep the library in a column store and filter it into a list of track ids - DONE
+ * - Search through a trigram index, ignoring case and accents - DONE
+ * - Rebind recycled row buttons to track ids instead of encoding rows in component IDs - DONE
+ * - Build the waveform thumbnails of imported tracks into the disk cache - DONE
+ * - Analyse the tempo and beatgrid of every track in the background and show a sortable BPM column - DONE
+ * - Detect the key of every track and show it in a sortable Key column with a key filter - DONE
+ * - Filter the index's search results into the table without copying them first - DONE
+ * - Coalesce the table refreshes for import and analysis batches with a timer - DONE
+ * - Write the library file on a background thread, at most every 30 seconds during analysis - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "PlaylistComponent.h"
+#include "LibraryIndex.h"
+#include <iterator>
+
+/**
+ * @class PlaylistComponent::AddToDeckButton
+ * @brief Row button that adds the track shown in its row to one of the decks.
+ *
+ * The table recycles these as rows scroll, so the track is rebound on every refresh.
+ */
+class PlaylistComponent::AddToDeckButton : public TextButton {
+public:
+    AddToDeckButton(int _channel) : TextButton(_channel == 0 ? "+ to Left" : "+ to Right"), channel(_channel) {
+        setColour(TextButton::buttonColourId, juce::Colours::darkslategrey);
+    }
+
+    TrackId trackId = TrackStore::invalidId; /**< The track currently shown in this button's row. */
+    const int channel; /**< The deck this button adds to (0 for left, 1 for right). */
+};
+
+//==============================================================================
+PlaylistComponent::PlaylistComponent(AudioFormatManager &_formatManager, DiskThumbnailCache &_thumbnailCache)
+        : formatManager(_formatManager), thumbnailCache(_thumbnailCache) {
+
+    // Set up playlist library table, the button columns can't be sorted
+    const int buttonColumnFlags = TableHeaderComponent::defaultFlags & ~TableHeaderComponent::sortable;
+    tableComponent.getHeader().addColumn("Song Title", 1, 490);
+    tableComponent.getHeader().addColumn("Duration", 2, 100);
+    tableComponent.getHeader().addColumn("BPM", 5, 80);
+    tableComponent.getHeader().addColumn("Key", 6, 80);
+    tableComponent.getHeader().addColumn("+ Left", 3, 100, 30, -1, buttonColumnFlags);
+    tableComponent.getHeader().addColumn("+ Right", 4, 100, 30, -1, buttonColumnFlags);
+    tableComponent.setModel(this);
+    addAndMakeVisible(tableComponent);
+
+    // Add search bar and listener
+    addAndMakeVisible(searchBar);
+    searchBar.addListener(this);
+
+    // Add label for search bar
+    addAndMakeVisible(searchLabel);
+    searchLabel.setText("Find Song: ", juce::dontSendNotification);
+
+    // Add the key filter, keys are listed round the Camelot wheel, minor before major
+    addAndMakeVisible(keyFilterBox);
+    keyFilterBox.addItem("All keys", 1);
+    for (int camelotNumber = 1; camelotNumber <= 12; ++camelotNumber) {
+        for (int key: {12, 0}) {
+            for (int tonic = 0; tonic < 12; ++tonic) {
+                if (KeyDetector::getCamelotNumber(key + tonic) == camelotNumber) {
+                    keyFilterBox.addItem(KeyDetector::getCamelotName(key + tonic) + " " + KeyDetector::getKeyName(key + tonic),
+                                         key + tonic + 2);
+                }
+            }
+        }
+    }
+    keyFilterBox.setSelectedId(1, dontSendNotification);
+    keyFilterBox.onChange = [this] { updateSearchResults(); };
+
+    // Add import progress and cancel button, hidden until files are dropped
+    addChildComponent(importProgress);
+    addChildComponent(cancelImportButton);
+    cancelImportButton.addListener(this);
+
+    // Add probed tracks to the library as they arrive
+    importer.onTracksImported = [this](const std::vector<ImportedTrack> &tracks) { addImportedTracks(tracks); };
+    importer.onImportFinished = [this] {
+        showImportProgress(false);
+        saveLibrary();
+    };
+
+    // Fill in the BPM and Key columns as tracks are analysed
+    analyser.onTracksAnalysed = [this](const std::vector<TrackAnalyser::Result> &results) { addAnalysisResults(results); };
+    analyser.onAnalysisFinished = [this] {
+        Logger::writeToLog("Track analysis finished at " + String(analyser.getTracksPerMinute(), 1) + " tracks per minute");
+        saveLibrary();
+    };
+
+    // Restore the library from the previous session
+    loadLibrary();
+}
+
+PlaylistComponent::~PlaylistComponent() {
+    stopTimer();
+
+    // older snapshots still waiting are out of date, the last one is written before the library goes away
+    savePool.removeAllJobs(false, 10000);
+    saveLibrary(false);
+}
+
+void PlaylistComponent::paint(juce::Graphics &g) {}
+
+void PlaylistComponent::resized() {
+    // Adjust the layout of components when the size of the PlaylistComponent changes
+    double rowH = getHeight() / 8;
+    double colW = getWidth() / 6;
+
+    searchLabel.setBounds(0, 0, colW, rowH);
+    searchBar.setBounds(colW, 0, importProgress.isVisible() ? colW * 2 : colW * 4, rowH);
+    keyFilterBox.setBounds(importProgress.isVisible() ? colW * 3 : colW * 5, 0, colW, rowH);
+    importProgress.setBounds(colW * 4, 0, colW * 1.5, rowH);
+    cancelImportButton.setBounds(colW * 5.5, 0, colW * 0.5, rowH);
+    tableComponent.setBounds(0, rowH, getWidth(), rowH * 7);
+}
+
+int PlaylistComponent::getNumRows() {
+    return (int) interestedSongs.size();
+}
+
+void PlaylistComponent::paintRowBackground(Graphics &g, int rowNumber, int width, int height, bool rowIsSelected) {
+    // Paint the background of each row in the playlist
+    if (rowIsSelected) {
+        g.fillAll(Colours::orange);
+    } else {
+        g.fillAll(Colours::darkgrey);
+    }
+}
+
+void PlaylistComponent::paintCell(Graphics &g, int rowNumber, int columnId, int width, int height, bool rowIsSelected) {
+    // Paint the cells with song titles and durations in the playlist
+    if (rowNumber >= (int) interestedSongs.size()) {
+        return;
+    }
+
+    TrackId trackId = interestedSongs[rowNumber];
+
+    if (columnId == 1) {
+        std::string_view title = trackStore.getTitle(trackId);
+        g.drawText(String::fromUTF8(title.data(), (int) title.size()), 1, rowNumber, width - 4, height, Justification::centredLeft, true);
+    }
+
+    if (columnId == 2) {
+        g.drawText(trackStore.getDurationText(trackId), 1, rowNumber, width - 4, height, Justification::centredLeft, true);
+    }
+
+    if (columnId == 5) {
+        // "..." while the track waits for analysis, "-" if it has no steady tempo
+        const TrackAnalysis &analysis = trackStore.getAnalysis(trackId);
+        char text[16] = "...";
+        if (analysis.analysed && analysis.bpm > 0.0) {
+            std::snprintf(text, sizeof(text), "%.2f", analysis.bpm);
+        } else if (analysis.analysed) {
+            std::snprintf(text, sizeof(text), "-");
+        }
+        g.drawText(text, 1, rowNumber, width - 4, height, Justification::centredLeft, true);
+    }
+
+    if (columnId == 6) {
+        // Camelot code first, it is what harmonic mixing goes by
+        const TrackAnalysis &analysis = trackStore.getAnalysis(trackId);
+        String text = "...";
+        if (analysis.analysed && analysis.key >= 0) {
+            text = KeyDetector::getCamelotName(analysis.key) + " " + KeyDetector::getKeyName(analysis.key);
+        } else if (analysis.analysed) {
+            text = "-";
+        }
+        g.drawText(text, 1, rowNumber, width - 4, height, Justification::centredLeft, true);
+    }
+}
+
+// ***********************************************
+// *********** SELF WRITTEN CODE START ***********
+// ***********************************************
+Component *PlaylistComponent::refreshComponentForCell(int rowNumber, int columnId, bool isRowSelected, Component *existingComponentToUpdate) {
+    // Refresh components for the "Add to Left" and "Add to Right" buttons in the playlist
+    if ((columnId != 3 && columnId != 4) || rowNumber >= (int) interestedSongs.size()) {
+        delete existingComponentToUpdate; // rows past the end of the table don't need a button
+        return nullptr;
+    }
+
+    auto *btn = dynamic_cast<AddToDeckButton *>(existingComponentToUpdate);
+    if (btn == nullptr) {
+        // only created for rows that scroll into view for the first time, afterwards they are reused
+        delete existingComponentToUpdate;
+        btn = new AddToDeckButton{columnId == 3 ? 0 : 1};
+        btn->addListener(this);
+    }
+
+    // rebind the recycled button to the track now shown in this row
+    btn->trackId = interestedSongs[rowNumber];
+    return btn;
+}
+// ***********************************************
+// *********** SELF WRITTEN CODE END *************
+// ***********************************************
+
+void PlaylistComponent::sortOrderChanged(int newSortColumnId, bool isForwards) {
+    sortColumnId = newSortColumnId;
+    sortForwards = isForwards;
+    updateSearchResults();
+}
+
+void PlaylistComponent::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {}
+
+void PlaylistComponent::getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) {}
+
+void PlaylistComponent::releaseResources() {}
+
+// ***********************************************
+// *********** SELF WRITTEN CODE START ***********
+// ***********************************************
+void PlaylistComponent::buttonClicked(Button *button) {
+    if (button == &cancelImportButton) {
+        importer.cancel(); // tracks that were already probed stay in the library
+        return;
+    }
+
+    // Handle button clicks for adding songs to the left or right player
+    if (auto *btn = dynamic_cast<AddToDeckButton *>(button)) {
+        if (btn->trackId != TrackStore::invalidId) {
+            addToDeckList(btn->trackId, btn->channel);
+        }
+    }
+}
+
+bool PlaylistComponent::isInterestedInFileDrag(const StringArray &files) {
+    // Allow the application to accept file drag and drop
+    return true;
+}
+
+void PlaylistComponent::filesDropped(const StringArray &files, int x, int y) {
+    // Handle files dropped into the playlist, rows are added as the importer reports them
+    showImportProgress(true);
+    importer.importFiles(files);
+}
+
+void PlaylistComponent::textEditorTextChanged(TextEditor &textEditor) {
+    // Handle changes in the search bar text
+    updateSearchResults();
+}
+
+void PlaylistComponent::updateSearchResults() {
+    stopTimer(); // this is the refresh a pending batch was waiting for
+
+    // Look up the search bar text in the index, it narrows the previous results while the user types
+    filterSearchResultsByKey(searchIndex.search(searchBar.getText().toStdString()));
+    sortSearchResults();
+
+    // Update playlist table based on search results
+    tableComponent.updateContent();
+}
+
+void PlaylistComponent::scheduleSearchUpdate() {
+    // the first batch starts the timer, the ones after it until it fires don't restart it
+    if (!isTimerRunning()) {
+        startTimer(searchUpdateIntervalMs);
+    }
+}
+
+void PlaylistComponent::timerCallback() {
+    updateSearchResults();
+}
+
+void PlaylistComponent::filterSearchResultsByKey(const std::vector<TrackId> &matches) {
+    // the only copy of the matches, filtered on the way
+    const int key = keyFilterBox.getSelectedId() - 2;
+    if (key < 0) {
+        interestedSongs.assign(matches.begin(), matches.end()); // all keys
+        return;
+    }
+
+    interestedSongs.clear();
+    std::copy_if(matches.begin(), matches.end(), std::back_inserter(interestedSongs), [this, key](TrackId trackId) {
+        return trackStore.getAnalysis(trackId).key == key;
+    });
+}
+
+void PlaylistComponent::sortSearchResults() {
+    // the search returns tracks in import order, which is also the order without a sort column
+    auto sortBy = [this](auto &&isBefore) {
+        std::stable_sort(interestedSongs.begin(), interestedSongs.end(), [&](TrackId a, TrackId b) {
+            return sortForwards ? isBefore(a, b) : isBefore(b, a);
+        });
+    };
+
+    if (sortColumnId == 1) {
+        sortBy([this](TrackId a, TrackId b) { return trackStore.getTitle(a) < trackStore.getTitle(b); });
+    } else if (sortColumnId == 2) {
+        sortBy([this](TrackId a, TrackId b) { return trackStore.getDuration(a) < trackStore.getDuration(b); });
+    } else if (sortColumnId == 5) {
+        // tracks without a tempo sort after all the others in both directions
+        std::stable_sort(interestedSongs.begin(), interestedSongs.end(), [this](TrackId a, TrackId b) {
+            const double bpmA = trackStore.getAnalysis(a).bpm, bpmB = trackStore.getAnalysis(b).bpm;
+            if ((bpmA > 0.0) != (bpmB > 0.0)) {
+                return bpmA > 0.0;
+            }
+            return sortForwards ? bpmA < bpmB : bpmB < bpmA;
+        });
+    } else if (sortColumnId == 6) {
+        // round the Camelot wheel, minor before major, tracks without a key last in both directions
+        auto camelotOrder = [this](TrackId trackId) {
+            const int key = trackStore.getAnalysis(trackId).key;
+            return key < 0 ? -1 : KeyDetector::getCamelotNumber(key) * 2 + (key < 12 ? 1 : 0);
+        };
+        std::stable_sort(interestedSongs.begin(), interestedSongs.end(), [this, &camelotOrder](TrackId a, TrackId b) {
+            const int orderA = camelotOrder(a), orderB = camelotOrder(b);
+            if ((orderA >= 0) != (orderB >= 0)) {
+                return orderA >= 0;
+            }
+            return sortForwards ? orderA < orderB : orderB < orderA;
+        });
+    }
+}
+
+void PlaylistComponent::addToDeckList(TrackId trackId, int channel) {
+    // Add selected song to the left or right player playlist
+    if (channel == 0) {
+        playListL.push_back(trackId); // add to left deck
+    } else {
+        playListR.push_back(trackId); // add to right deck
+    }
+}
+
+const TrackStore &PlaylistComponent::getTrackStore() const {
+    return trackStore;
+}
+
+void PlaylistComponent::addImportedTracks(const std::vector<ImportedTrack> &tracks) {
+    // Store the probed tracks (tracks already in the library are updated) and refresh the visible rows
+    for (const auto &track: tracks) {
+        TrackId trackId = trackStore.addOrUpdate(track);
+        searchIndex.addOrUpdate(trackId, trackStore.getTitle(trackId));
+
+        // new and changed tracks, and tracks left over from the last session, still need their tempo
+        if (!trackStore.getAnalysis(trackId).analysed) {
+            analyser.analyse(trackId, trackStore.getFile(trackId));
+        }
+    }
+
+    // changed titles show up straight away, new rows with the next refresh
+    tableComponent.repaint();
+    scheduleSearchUpdate();
+}
+
+void PlaylistComponent::addAnalysisResults(const std::vector<TrackAnalyser::Result> &results) {
+    for (const auto &result: results) {
+        // drop results for files that changed again while they were being analysed
+        if (result.modificationTime == trackStore.getModificationTime(result.trackId)) {
+            trackStore.setAnalysis(result.trackId, result.analysis);
+        }
+    }
+
+    // save now and then, so a crash doesn't lose a long analysis run, the end of the run saves the rest
+    numAnalysedSinceSave += (int) results.size();
+    if (numAnalysedSinceSave > 0 && Time::getMillisecondCounter() - lastSaveMs >= (uint32) analysisSaveIntervalMs) {
+        saveLibrary();
+    }
+
+    // the results move rows when the table is sorted or filtered by them
+    tableComponent.repaint();
+    if (sortColumnId == 5 || sortColumnId == 6 || keyFilterBox.getSelectedId() > 1) {
+        scheduleSearchUpdate();
+    }
+}
+
+void PlaylistComponent::loadLibrary() {
+    std::vector<ImportedTrack> tracks;
+
+    if (LibraryIndex::load(LibraryIndex::getDefaultFile(), tracks)) {
+        addImportedTracks(tracks);
+
+        // files may have been edited since the last session, re-probe only those
+        importer.rescan(std::move(tracks));
+    }
+}
+
+void PlaylistComponent::saveLibrary(bool inBackground) {
+    std::vector<ImportedTrack> tracks;
+    tracks.reserve((size_t) trackStore.size());
+
+    for (TrackId trackId = 0; trackId < (TrackId) trackStore.size(); ++trackId) {
+        tracks.push_back(trackStore.getRecord(trackId));
+    }
+
+    numAnalysedSinceSave = 0;
+    lastSaveMs = Time::getMillisecondCounter();
+
+    if (!inBackground) {
+        LibraryIndex::save(LibraryIndex::getDefaultFile(), tracks);
+        return;
+    }
+
+    // the snapshot is written off the message thread, one save at a time and in order
+    savePool.addJob([tracks = std::move(tracks)] { LibraryIndex::save(LibraryIndex::getDefaultFile(), tracks); });
+}
+
+void PlaylistComponent::showImportProgress(bool shouldShow) {
+    importProgress.setVisible(shouldShow);
+    cancelImportButton.setVisible(shouldShow);
+    resized();
+}
+// ***********************************************
+// *********** SELF WRITTEN CODE END *************
 // ***********************************************
\ No newline at end of file
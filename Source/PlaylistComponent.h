@@ -1,178 +1,258 @@
-/*
-  ==============================================================================
-
-    PlaylistComponent.h
-    Created: 12 Jan 2024 3:31:32pm
-    Author:  JAMIUL ISLAM
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include <vector>
-#include <string>
-
-using namespace juce;
-
-/**
- * @class PlaylistComponent
- * @brief A component for managing and displaying a playlist of audio files.
- *
- * This class provides features for managing a playlist of audio files, allowing
- * users to add songs, display song details, and interact with the playlist.
- */
-class PlaylistComponent :
-        public juce::Component,
-        public TableListBoxModel,
-        public Button::Listener,
-        public FileDragAndDropTarget,
-        public AudioSource,
-        public TextEditor::Listener {
-public:
-    /**
-     * @brief Constructor.
-     * @param formatManager The audio format manager to use.
-     */
-    PlaylistComponent(AudioFormatManager& formatManager);
-
-    /** Destructor. */
-    ~PlaylistComponent() override;
-
-    /**
-     * @brief Paint method for rendering the component.
-     * @param g The Graphics object used for rendering.
-     */
-    void paint(juce::Graphics &) override;
-
-    /**
-     * @brief Resized method called when the component is resized.
-     */
-    void resized() override;
-
-    // Functions for playlist
-    /**
-     * @brief Get the number of rows in the playlist.
-     * @return The number of rows in the playlist.
-     */
-    int getNumRows() override;
-
-    /**
-     * @brief Paint the background of each row in the playlist.
-     * @param g The Graphics object used for rendering.
-     * @param rowNumber The index of the row.
-     * @param width The width of the row.
-     * @param height The height of the row.
-     * @param rowIsSelected Flag indicating if the row is selected.
-     */
-    void paintRowBackground(Graphics &, int rowNumber, int width, int height, bool rowIsSelected) override;
-
-    /**
-     * @brief Paint the cells with song titles and durations in the playlist.
-     * @param g The Graphics object used for rendering.
-     * @param rowNumber The index of the row.
-     * @param columnId The index of the column.
-     * @param width The width of the cell.
-     * @param height The height of the cell.
-     * @param rowIsSelected Flag indicating if the row is selected.
-     */
-    void paintCell(Graphics &, int rowNumber, int columnId, int width, int height, bool rowIsSelected) override;
-
-    /**
-     * @brief Refresh components for the "Add to Left" and "Add to Right" buttons in the playlist.
-     * @param rowNumber The index of the row.
-     * @param columnId The index of the column.
-     * @param isRowSelected Flag indicating if the row is selected.
-     * @param existingComponentToUpdate The existing component to update.
-     * @return The updated component.
-     */
-    Component* refreshComponentForCell(int rowNumber, int columnId, bool isRowSelected, Component* existingComponentToUpdate) override;
-
-    // Audio source
-    /**
-     * @brief Prepare the audio source to play.
-     * @param samplesPerBlockExpected The number of samples per block expected.
-     * @param sampleRate The sample rate of the audio source.
-     */
-    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
-
-    /**
-     * @brief Get the next audio block from the audio source.
-     * @param bufferToFill The buffer to fill with audio data.
-     */
-    void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override;
-
-    /** Release audio resources. */
-    void releaseResources() override;
-
-    // Button::button listener
-    /**
-     * @brief Handle button clicks for adding songs to the left or right player.
-     * @param button The button that was clicked.
-     */
-    void buttonClicked(Button* button) override;
-
-    // Drag and drop feature
-    /**
-     * @brief Check if the application is interested in file drag and drop.
-     * @param files The array of file paths being dragged.
-     * @return True if interested; otherwise, false.
-     */
-    bool isInterestedInFileDrag(const StringArray& files) override;
-
-    /**
-     * @brief Handle files dropped into the playlist.
-     * @param files The array of file paths dropped.
-     * @param x The x-coordinate of the drop location.
-     * @param y The y-coordinate of the drop location.
-     */
-    void filesDropped(const StringArray& files, int x, int y) override;
-
-    /**
-     * @brief Handle changes in the search bar text.
-     * @param textEditor The TextEditor triggering the change.
-     */
-    void textEditorTextChanged(TextEditor&) override;
-
-    /** Vector storing songs in the left player playlist. */
-    std::vector<std::string> playListL;
-
-    /** Vector storing songs in the right player playlist. */
-    std::vector<std::string> playListR;
-
-private:
-    AudioFormatManager& formatManager; /**< Audio format manager to handle audio file formats. */
-    std::unique_ptr<AudioFormatReaderSource> readerSource; /**< Reader source for audio format reading. */
-    AudioTransportSource transportSource; /**< Audio transport source for playback. */
-
-    // Playlist displayed as a table list
-    TableListBox tableComponent; /**< Table component for displaying the playlist. */
-
-    // For storing music files
-    std::vector<std::string> inputSongs; /**< Vector storing all the songs. */
-    std::vector<std::string> interestedSongs; /**< Vector storing songs that are interested in dropping. */
-    std::vector<std::string> songTitles; /**< Vector storing song titles. */
-    std::vector<std::string> interestedSongTitles; /**< Vector storing song titles that are interested in dropping. */
-    std::vector<int> songDurations; /**< Vector storing song durations. */
-    std::vector<int> interestedSongDuration; /**< Vector storing song durations that are interested in dropping. */
-
-    // Search bar and search label
-    TextEditor searchBar; /**< TextEditor for searching songs. */
-    Label searchLabel; /**< Label for search bar. */
-
-    /**
-     * @brief Add selected song to the left or right player playlist.
-     * @param filepath The file path of the selected song.
-     * @param channel The channel (left or right) to add the song to.
-     */
-    void addToDeckList(std::string filepath, int channel);
-
-    /**
-     * @brief Get the duration of the audio file.
-     * @param audioURL The URL of the audio file.
-     */
-    void getAudioLen(URL audioURL);
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlaylistComponent)
-};
+/*
+  ==============================================================================
+
+    PlaylistComponent.h
+    Created: 12 Jan 2024 3:31:32pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+#include <string>
+#include "LibraryImporter.h"
+#include "TrackStore.h"
+#include "TrackSearchIndex.h"
+#include "TrackAnalyser.h"
+
+using namespace juce;
+
+/**
+ * @class PlaylistComponent
+ * @brief A component for managing and displaying a playlist of audio files.
+ *
+ * This class provides features for managing a playlist of audio files, allowing
+ * users to add songs, display song details, and interact with the playlist.
+ *
+ * Every track is analysed for its tempo, beatgrid and key in the background, the BPM and Key
+ * columns fill in as results arrive. Clicking a column header sorts the table by it, and the
+ * key filter narrows the table down to one key.
+ *
+ * Imports and analysis report tracks in many small batches. Instead of searching, filtering and
+ * sorting the whole library again for every batch, the table is refreshed at most a few times a
+ * second while batches keep arriving. Typing, sorting and filtering still refresh it immediately.
+ */
+class PlaylistComponent :
+        public juce::Component,
+        public TableListBoxModel,
+        public Button::Listener,
+        public FileDragAndDropTarget,
+        public AudioSource,
+        public TextEditor::Listener,
+        private Timer {
+public:
+    /**
+     * @brief Constructor.
+     * @param formatManager The audio format manager to use.
+     * @param thumbnailCache The disk cache the thumbnails of imported tracks are built into.
+     */
+    PlaylistComponent(AudioFormatManager& formatManager, DiskThumbnailCache& thumbnailCache);
+
+    /** Destructor. */
+    ~PlaylistComponent() override;
+
+    /**
+     * @brief Paint method for rendering the component.
+     * @param g The Graphics object used for rendering.
+     */
+    void paint(juce::Graphics &) override;
+
+    /**
+     * @brief Resized method called when the component is resized.
+     */
+    void resized() override;
+
+    // Functions for playlist
+    /**
+     * @brief Get the number of rows in the playlist.
+     * @return The number of rows in the playlist.
+     */
+    int getNumRows() override;
+
+    /**
+     * @brief Paint the background of each row in the playlist.
+     * @param g The Graphics object used for rendering.
+     * @param rowNumber The index of the row.
+     * @param width The width of the row.
+     * @param height The height of the row.
+     * @param rowIsSelected Flag indicating if the row is selected.
+     */
+    void paintRowBackground(Graphics &, int rowNumber, int width, int height, bool rowIsSelected) override;
+
+    /**
+     * @brief Paint the cells with song titles and durations in the playlist.
+     * @param g The Graphics object used for rendering.
+     * @param rowNumber The index of the row.
+     * @param columnId The index of the column.
+     * @param width The width of the cell.
+     * @param height The height of the cell.
+     * @param rowIsSelected Flag indicating if the row is selected.
+     */
+    void paintCell(Graphics &, int rowNumber, int columnId, int width, int height, bool rowIsSelected) override;
+
+    /**
+     * @brief Refresh components for the "Add to Left" and "Add to Right" buttons in the playlist.
+     *
+     * The table only keeps components for the visible rows and hands them back here when rows
+     * scroll into view, so each button is rebound to the track now shown in its row.
+     *
+     * @param rowNumber The index of the row.
+     * @param columnId The index of the column.
+     * @param isRowSelected Flag indicating if the row is selected.
+     * @param existingComponentToUpdate The existing component to update.
+     * @return The updated component.
+     */
+    Component* refreshComponentForCell(int rowNumber, int columnId, bool isRowSelected, Component* existingComponentToUpdate) override;
+
+    /**
+     * @brief Sort the table by the title, duration or BPM column.
+     * @param newSortColumnId The id of the column to sort by.
+     * @param isForwards True for ascending order.
+     */
+    void sortOrderChanged(int newSortColumnId, bool isForwards) override;
+
+    // Audio source
+    /**
+     * @brief Prepare the audio source to play.
+     * @param samplesPerBlockExpected The number of samples per block expected.
+     * @param sampleRate The sample rate of the audio source.
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /**
+     * @brief Get the next audio block from the audio source.
+     * @param bufferToFill The buffer to fill with audio data.
+     */
+    void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override;
+
+    /** Release audio resources. */
+    void releaseResources() override;
+
+    // Button::button listener
+    /**
+     * @brief Handle button clicks for adding songs to the left or right player, and for cancelling imports.
+     * @param button The button that was clicked.
+     */
+    void buttonClicked(Button* button) override;
+
+    // Drag and drop feature
+    /**
+     * @brief Check if the application is interested in file drag and drop.
+     * @param files The array of file paths being dragged.
+     * @return True if interested; otherwise, false.
+     */
+    bool isInterestedInFileDrag(const StringArray& files) override;
+
+    /**
+     * @brief Handle files dropped into the playlist, they are probed in the background.
+     * @param files The array of file and folder paths dropped.
+     * @param x The x-coordinate of the drop location.
+     * @param y The y-coordinate of the drop location.
+     */
+    void filesDropped(const StringArray& files, int x, int y) override;
+
+    /**
+     * @brief Handle changes in the search bar text.
+     * @param textEditor The TextEditor triggering the change.
+     */
+    void textEditorTextChanged(TextEditor&) override;
+
+    /**
+     * @brief Get the store holding every track in the library.
+     * @return The track store, used to look up the tracks queued on the decks.
+     */
+    const TrackStore& getTrackStore() const;
+
+    /** Vector storing the ids of the songs in the left player playlist. */
+    std::vector<TrackId> playListL;
+
+    /** Vector storing the ids of the songs in the right player playlist. */
+    std::vector<TrackId> playListR;
+
+private:
+    class AddToDeckButton;
+
+    AudioFormatManager& formatManager; /**< Audio format manager to handle audio file formats. */
+    DiskThumbnailCache& thumbnailCache; /**< Disk cache for the thumbnails of imported tracks. */
+    LibraryImporter importer{ formatManager, thumbnailCache }; /**< Probes dropped files on worker threads. */
+    TrackAnalyser analyser{ formatManager }; /**< Finds the tempo, beatgrid and key of tracks in the background. */
+
+    // Playlist displayed as a table list
+    TableListBox tableComponent; /**< Table component for displaying the playlist. */
+
+    // For storing music files
+    TrackStore trackStore; /**< Every track in the library. */
+    TrackSearchIndex searchIndex; /**< Trigram index over the track titles. */
+    std::vector<TrackId> interestedSongs; /**< Ids of the songs matching the search, in table order. */
+    int sortColumnId = 0; /**< Column the table is sorted by, 0 for import order. */
+    bool sortForwards = true; /**< Whether the table is sorted in ascending order. */
+    int numAnalysedSinceSave = 0; /**< Analysis results not yet saved to the library file. */
+    uint32 lastSaveMs = 0; /**< When the library was last saved, from Time::getMillisecondCounter(). */
+    ThreadPool savePool{ 1 }; /**< Writes the library file off the message thread. */
+
+    /** Shortest time between two saves while tracks are being analysed, in milliseconds. */
+    static constexpr int analysisSaveIntervalMs = 30000;
+
+    // Search bar and search label
+    TextEditor searchBar; /**< TextEditor for searching songs. */
+    Label searchLabel; /**< Label for search bar. */
+    ComboBox keyFilterBox; /**< Shows only tracks in one key, item ids are the key plus two, 1 for all keys. */
+
+    // Import progress and cancel button, only visible while importing
+    ProgressBar importProgress{ importer.getProgress() }; /**< Progress of the running import. */
+    TextButton cancelImportButton{ "Cancel" }; /**< Button for cancelling the running import. */
+
+    /**
+     * @brief Add selected song to the left or right player playlist.
+     * @param trackId The id of the selected song.
+     * @param channel The channel (left or right) to add the song to.
+     */
+    void addToDeckList(TrackId trackId, int channel);
+
+    /**
+     * @brief Add a batch of probed tracks to the library.
+     * @param tracks The tracks reported by the importer.
+     */
+    void addImportedTracks(const std::vector<ImportedTrack>& tracks);
+
+    /**
+     * @brief Store a batch of analysis results in the library.
+     * @param results The results reported by the analyser.
+     */
+    void addAnalysisResults(const std::vector<TrackAnalyser::Result>& results);
+
+    /** Load the library saved by the previous session and rescan it in the background. */
+    void loadLibrary();
+
+    /**
+     * @brief Save the library for the next session.
+     * @param inBackground Whether to write the file on the save thread instead of waiting for it.
+     */
+    void saveLibrary(bool inBackground = true);
+
+    /** Show or hide the import progress and cancel button. */
+    void showImportProgress(bool shouldShow);
+
+    /** Filter the library by the search bar text and update the table. */
+    void updateSearchResults();
+
+    /** Refresh the table soon, so batches arriving close together share one refresh. */
+    void scheduleSearchUpdate();
+
+    /** Run the refresh scheduled by scheduleSearchUpdate(). */
+    void timerCallback() override;
+
+    /** Longest a new batch waits before it shows up in the table, in milliseconds. */
+    static constexpr int searchUpdateIntervalMs = 250;
+
+    /** Keep the search matches that are in the key chosen in the key filter as the table's rows. */
+    void filterSearchResultsByKey(const std::vector<TrackId> &matches);
+
+    /** Sort the search results by the selected column. */
+    void sortSearchResults();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlaylistComponent)
+};
@@ -0,0 +1,341 @@
+/*
+  ==============================================================================
+
+    ReadAheadAudioSource.cpp
+    Created: 17 Oct 2026 10:12:40am
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Fill a ring buffer ahead of the playhead on the shared thread - DONE
+ * 2. Serve the audio thread from the ring buffer only - DONE
+ * 3. Restart buffering from the new position on seeks - DONE
+ * 4. Report the fill level and count underruns - DONE
+ * 5. Publish the buffered range through a sequence lock, the audio thread never waits - DONE
+ * 6. Wait for the first samples in waitUntilReady() instead of prepareToPlay() - DONE
+ * 7. Play the first block after a jump straight from the source while the buffer refills - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "ReadAheadAudioSource.h"
+
+namespace {
+    /** How often to look for a seek within the buffer once it is full, jumps out of it wake the thread. */
+    constexpr int idleWaitMs = 5;
+
+    /** How often a reader tries to catch the buffered range between two writes before giving up. */
+    constexpr int rangeReadAttempts = 4;
+}
+
+ReadAheadAudioSource::ReadAheadAudioSource(PositionableAudioSource *_source, TimeSliceThread &_backgroundThread,
+                                           bool deleteSourceWhenDeleted, int _numberOfSamplesToBuffer,
+                                           int _numberOfChannels)
+        : source(_source, deleteSourceWhenDeleted), backgroundThread(_backgroundThread),
+          numberOfSamplesToBuffer(jmax(1024, _numberOfSamplesToBuffer)), numberOfChannels(_numberOfChannels) {
+    jassert(source != nullptr);
+}
+
+ReadAheadAudioSource::~ReadAheadAudioSource() {
+    releaseResources();
+}
+
+void ReadAheadAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    const int bufferSizeNeeded = jmax(samplesPerBlockExpected * 2, numberOfSamplesToBuffer);
+
+    if (isPrepared && buffer.getNumSamples() == bufferSizeNeeded) {
+        return;
+    }
+
+    backgroundThread.removeTimeSliceClient(this);
+    isPrepared = true;
+
+    source->prepareToPlay(samplesPerBlockExpected, sampleRate);
+
+    {
+        const ScopedLock sl(callbackLock);
+        buffer.setSize(numberOfChannels, bufferSizeNeeded);
+        buffer.clear();
+    }
+
+    // the background thread isn't running this source, so nothing else writes the range
+    writeValidRange(0, 0);
+
+    backgroundThread.addTimeSliceClient(this);
+}
+
+bool ReadAheadAudioSource::waitUntilReady(int numSamples, int timeoutMs) {
+    const int samplesNeeded = jmin(numSamples, buffer.getNumSamples() / 2);
+    const auto startTime = Time::getMillisecondCounter();
+
+    while (getValidBufferRange(samplesNeeded).getLength() < samplesNeeded) {
+        if ((int) (Time::getMillisecondCounter() - startTime) >= timeoutMs) {
+            return false;
+        }
+        backgroundThread.moveToFrontOfQueue(this);
+        Thread::sleep(1);
+    }
+    return true;
+}
+
+void ReadAheadAudioSource::releaseResources() {
+    isPrepared = false;
+    backgroundThread.removeTimeSliceClient(this);
+
+    {
+        const ScopedLock sl(callbackLock);
+        buffer.setSize(numberOfChannels, 0);
+    }
+
+    // removeTimeSliceClient() has waited for a running slice, so the background thread is done with the source
+    source->releaseResources();
+}
+
+void ReadAheadAudioSource::getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) {
+    const ScopedTryLock sl(callbackLock);
+
+    if (!sl.isLocked() || buffer.getNumSamples() == 0) {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    const auto validRange = getValidBufferRange(bufferToFill.numSamples);
+    const int validStart = validRange.getStart();
+    int validEnd = validRange.getEnd();
+
+    if (validEnd - validStart < bufferToFill.numSamples && jumpPending && readDirectly(bufferToFill)) {
+        return; // the buffer is still refilling after a jump, this block came straight from the source
+    }
+
+    if (validStart > 0) {
+        bufferToFill.buffer->clear(bufferToFill.startSample, validStart); // partial underrun at the start
+    }
+
+    if (validEnd < bufferToFill.numSamples) {
+        bufferToFill.buffer->clear(bufferToFill.startSample + validEnd, bufferToFill.numSamples - validEnd);
+    }
+
+    if (validStart < validEnd) {
+        const int64 pos = nextPlayPos.load();
+        const int bufferSize = buffer.getNumSamples();
+
+        for (int chan = 0; chan < jmin(numberOfChannels, bufferToFill.buffer->getNumChannels()); ++chan) {
+            const int startBufferIndex = (int) ((validStart + pos) % bufferSize);
+            const int endBufferIndex = (int) ((validEnd + pos) % bufferSize);
+
+            if (startBufferIndex < endBufferIndex) {
+                bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + validStart,
+                                              buffer, chan, startBufferIndex, validEnd - validStart);
+            } else {
+                const int initialSize = bufferSize - startBufferIndex;
+
+                bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + validStart,
+                                              buffer, chan, startBufferIndex, initialSize);
+                bufferToFill.buffer->copyFrom(chan, bufferToFill.startSample + validStart + initialSize,
+                                              buffer, chan, 0, (validEnd - validStart) - initialSize);
+            }
+        }
+
+        // a top-up that started before the playhead moved back may have been overwriting what was
+        // just copied, it always shrinks the range before it writes, so check it still covers the copy
+        Range<int64> rangeAfterCopy;
+        if (!readValidRange(rangeAfterCopy)
+            || !rangeAfterCopy.contains(Range<int64>(pos + validStart, pos + validEnd))) {
+            bufferToFill.buffer->clear(bufferToFill.startSample + validStart, validEnd - validStart);
+            validEnd = validStart;
+        }
+    }
+
+    if (validStart == 0 && validEnd == bufferToFill.numSamples) {
+        jumpPending = false; // caught up with the jump
+    }
+
+    // running out of data before the end of the track means the disk didn't keep up
+    if (validEnd - validStart < bufferToFill.numSamples
+        && (isLooping() || nextPlayPos.load() + validEnd < getTotalLength())) {
+        ++numUnderruns;
+    }
+
+    nextPlayPos += bufferToFill.numSamples;
+}
+
+bool ReadAheadAudioSource::readDirectly(const AudioSourceChannelInfo &bufferToFill) {
+    // the background thread holds the source while it decodes a chunk, play silence rather than wait
+    const ScopedTryLock sl(sourceLock);
+    if (!sl.isLocked()) {
+        return false;
+    }
+
+    const int64 pos = nextPlayPos.load();
+    source->setNextReadPosition(pos);
+    source->getNextAudioBlock(bufferToFill);
+
+    nextPlayPos = pos + bufferToFill.numSamples;
+    return true;
+}
+
+void ReadAheadAudioSource::setNextReadPosition(int64 newPosition) {
+    nextPlayPos = newPosition;
+
+    Range<int64> validRange;
+    if (readValidRange(validRange) && validRange.contains(newPosition)) {
+        return; // still buffered, the background thread carries on from here within idleWaitMs
+    }
+
+    // a jump out of the buffer: wake the thread now, like BufferingAudioSource, this holds its
+    // list lock for a moment, and play from the source directly until the buffer has caught up
+    jumpPending = true;
+    backgroundThread.moveToFrontOfQueue(this);
+}
+
+int64 ReadAheadAudioSource::getNextReadPosition() const {
+    const int64 pos = nextPlayPos.load();
+
+    return (source->isLooping() && pos > 0) ? pos % source->getTotalLength() : pos;
+}
+
+int64 ReadAheadAudioSource::getTotalLength() const {
+    return source->getTotalLength();
+}
+
+bool ReadAheadAudioSource::isLooping() const {
+    return source->isLooping();
+}
+
+double ReadAheadAudioSource::getFillLevel() const {
+    Range<int64> validRange;
+    if (buffer.getNumSamples() == 0 || !readValidRange(validRange)) {
+        return 0.0;
+    }
+
+    const int64 pos = validRange.clipValue(nextPlayPos.load());
+    const int64 samplesLeftInTrack = jmax((int64) 1, getTotalLength() - pos);
+
+    // near the end of the track a partly filled buffer still holds everything there is to play
+    return jmin(1.0, (double) (validRange.getEnd() - pos)
+                     / (double) jmin((int64) buffer.getNumSamples() - 4, samplesLeftInTrack));
+}
+
+int ReadAheadAudioSource::getNumUnderruns() const {
+    return numUnderruns.load();
+}
+
+Range<int> ReadAheadAudioSource::getValidBufferRange(int numSamples) const {
+    const int64 pos = nextPlayPos.load();
+
+    Range<int64> validRange;
+    if (!readValidRange(validRange)) {
+        return {}; // caught mid-write, play nothing rather than wait
+    }
+
+    return {(int) (validRange.clipValue(pos) - pos), (int) (validRange.clipValue(pos + numSamples) - pos)};
+}
+
+bool ReadAheadAudioSource::readValidRange(Range<int64> &range) const {
+    for (int attempt = 0; attempt < rangeReadAttempts; ++attempt) {
+        const uint32 sequenceBefore = rangeSequence.load(std::memory_order_acquire);
+        if ((sequenceBefore & 1) != 0) {
+            continue; // being written
+        }
+
+        const int64 start = bufferValidStart.load(std::memory_order_relaxed);
+        const int64 end = bufferValidEnd.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (rangeSequence.load(std::memory_order_relaxed) == sequenceBefore) {
+            range = { start, jmax(start, end) };
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReadAheadAudioSource::writeValidRange(int64 start, int64 end) {
+    rangeSequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bufferValidStart.store(start, std::memory_order_relaxed);
+    bufferValidEnd.store(end, std::memory_order_relaxed);
+    rangeSequence.fetch_add(1, std::memory_order_release);
+}
+
+int ReadAheadAudioSource::useTimeSlice() {
+    // come back straight away while there is still work to do
+    return readNextBufferChunk() ? 1 : idleWaitMs;
+}
+
+bool ReadAheadAudioSource::readNextBufferChunk() {
+    const int maxChunkSize = 2048;
+
+    if (buffer.getNumSamples() == 0) {
+        return false;
+    }
+
+    // this thread is the only writer of the range, so it can read it directly
+    int64 validStart = bufferValidStart.load(std::memory_order_relaxed);
+    int64 validEnd = bufferValidEnd.load(std::memory_order_relaxed);
+
+    if (wasSourceLooping != isLooping()) {
+        wasSourceLooping = isLooping();
+        validStart = validEnd = 0;
+        writeValidRange(0, 0);
+    }
+
+    const int64 newBVS = jmax((int64) 0, nextPlayPos.load());
+    int64 newBVE = newBVS + buffer.getNumSamples() - 4;
+    int64 sectionToReadStart = 0;
+    int64 sectionToReadEnd = 0;
+
+    if (newBVS < validStart || newBVS >= validEnd) {
+        // the playhead jumped outside the buffer, start again from there
+        newBVE = jmin(newBVE, newBVS + maxChunkSize);
+
+        sectionToReadStart = newBVS;
+        sectionToReadEnd = newBVE;
+
+        writeValidRange(0, 0);
+    } else if (std::abs((int) (newBVS - validStart)) > 512 || std::abs((int) (newBVE - validEnd)) > 512) {
+        // top up the buffer behind the samples that are still valid
+        newBVE = jmin(newBVE, validEnd + maxChunkSize);
+
+        sectionToReadStart = validEnd;
+        sectionToReadEnd = newBVE;
+
+        // the section about to be overwritten wraps onto the samples before newBVS, they stop being valid first
+        writeValidRange(newBVS, jmin(validEnd, newBVE));
+    }
+
+    if (sectionToReadStart == sectionToReadEnd) {
+        return false;
+    }
+
+    const int bufferSize = buffer.getNumSamples();
+    const int bufferIndexStart = (int) (sectionToReadStart % bufferSize);
+    const int bufferIndexEnd = (int) (sectionToReadEnd % bufferSize);
+
+    if (bufferIndexStart < bufferIndexEnd) {
+        readBufferSection(sectionToReadStart, (int) (sectionToReadEnd - sectionToReadStart), bufferIndexStart);
+    } else {
+        const int initialSize = bufferSize - bufferIndexStart;
+
+        readBufferSection(sectionToReadStart, initialSize, bufferIndexStart);
+        readBufferSection(sectionToReadStart + initialSize,
+                          (int) (sectionToReadEnd - sectionToReadStart) - initialSize, 0);
+    }
+
+    // if the playhead moved meanwhile, the next slice notices it is outside this range
+    writeValidRange(newBVS, newBVE);
+    return true;
+}
+
+void ReadAheadAudioSource::readBufferSection(int64 start, int length, int bufferOffset) {
+    const ScopedLock sl(sourceLock);
+
+    if (source->getNextReadPosition() != start) {
+        source->setNextReadPosition(start);
+    }
+
+    // the section being written lies outside the range the audio thread reads from
+    AudioSourceChannelInfo info(&buffer, bufferOffset, length);
+    source->getNextAudioBlock(info);
+}
@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    ReadAheadAudioSource.h
+    Created: 17 Oct 2026 10:12:40am
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+/**
+ * @class ReadAheadAudioSource
+ * @brief Buffers a positionable source ahead of the playhead on a shared background thread.
+ *
+ * The source is decoded into a ring buffer by a TimeSliceThread, so the audio thread only
+ * copies samples that are already in memory. The fill level and the number of underruns
+ * (blocks the audio thread asked for before they were decoded) can be queried from any thread
+ * to size the buffer for the hardware in use.
+ *
+ * The audio thread never waits: the background thread publishes the buffered range through a
+ * sequence lock the audio thread only reads, and checks again after copying a block that the range
+ * still covers it. A seek within the buffer just moves the playhead. A jump out of it wakes the
+ * background thread, and until the buffer has caught up the audio thread reads its blocks straight
+ * from the source, as long as the background thread isn't using it, so cue and loop jumps don't
+ * play silence. Only the background thread and prepareToPlay() write the range, never at the same
+ * time. prepareToPlay() doesn't wait for the buffer to fill, the loader
+ * calls waitUntilReady() off the message thread instead.
+ *
+ * It works like juce::BufferingAudioSource, which can't be extended for this: its audio path locks
+ * the buffered range and its state is private.
+ */
+class ReadAheadAudioSource : public PositionableAudioSource,
+                             private TimeSliceClient {
+public:
+    /**
+     * @brief Constructor.
+     * @param source The source to read from.
+     * @param backgroundThread The shared thread that fills the buffer.
+     * @param deleteSourceWhenDeleted Whether this object should take ownership of the source.
+     * @param numberOfSamplesToBuffer The size of the read-ahead buffer in source samples.
+     * @param numberOfChannels The number of channels to buffer.
+     */
+    ReadAheadAudioSource(PositionableAudioSource *source, TimeSliceThread &backgroundThread,
+                         bool deleteSourceWhenDeleted, int numberOfSamplesToBuffer, int numberOfChannels = 2);
+
+    /** Destructor. */
+    ~ReadAheadAudioSource() override;
+
+    /** @internal */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+    /** @internal */
+    void releaseResources() override;
+    /** @internal */
+    void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override;
+
+    /** @internal */
+    void setNextReadPosition(int64 newPosition) override;
+    /** @internal */
+    int64 getNextReadPosition() const override;
+    /** @internal */
+    int64 getTotalLength() const override;
+    /** @internal */
+    bool isLooping() const override;
+
+    /**
+     * @brief Wait until the start of playback is buffered, after prepareToPlay(), never on the audio thread.
+     * @param numSamples The samples from the playhead that have to be ready.
+     * @param timeoutMs How long to wait at most.
+     * @return True if the samples are ready.
+     */
+    bool waitUntilReady(int numSamples, int timeoutMs);
+
+    /**
+     * @brief Get how much of the buffer ahead of the playhead is ready to play.
+     * @return The fill level (0 to 1).
+     */
+    double getFillLevel() const;
+
+    /**
+     * @brief Get the number of blocks that could not be served completely from the buffer.
+     * @return The number of underruns since the source was created.
+     */
+    int getNumUnderruns() const;
+
+private:
+    int useTimeSlice() override;
+
+    /** Decode the next chunk into the ring buffer, returns false when there is nothing to do. */
+    bool readNextBufferChunk();
+
+    /** Read a block straight from the source after a jump, returns false if the background thread is using it. */
+    bool readDirectly(const AudioSourceChannelInfo &bufferToFill);
+
+    /** Read a section of the source into the ring buffer. */
+    void readBufferSection(int64 start, int length, int bufferOffset);
+
+    /** Get the part of the next block that is already in the buffer, relative to the playhead. */
+    Range<int> getValidBufferRange(int numSamples) const;
+
+    /**
+     * @brief Read the buffered range without waiting.
+     * @param range Receives the first buffered position and one past the last.
+     * @return False if the background thread was writing it every time it was tried.
+     */
+    bool readValidRange(Range<int64> &range) const;
+
+    /** Publish a new buffered range, only from the background thread or while it isn't running this source. */
+    void writeValidRange(int64 start, int64 end);
+
+    OptionalScopedPointer<PositionableAudioSource> source; /**< The source being buffered. */
+    TimeSliceThread &backgroundThread; /**< Shared thread that fills the buffer. */
+    int numberOfSamplesToBuffer; /**< Requested buffer size in samples. */
+    int numberOfChannels; /**< Number of buffered channels. */
+
+    AudioBuffer<float> buffer; /**< Ring buffer holding decoded samples. */
+    CriticalSection callbackLock; /**< Guards the ring buffer against reallocation, only ever tried by the audio thread. */
+    CriticalSection sourceLock; /**< Held by the background thread while it reads the source, only ever tried by the audio thread. */
+    std::atomic<bool> jumpPending{ false }; /**< Set by a jump out of the buffer until a block is served from it again. */
+    std::atomic<uint32> rangeSequence{ 0 }; /**< Odd while the buffered range is being written. */
+    std::atomic<int64> bufferValidStart{ 0 }; /**< First buffered sample position. */
+    std::atomic<int64> bufferValidEnd{ 0 }; /**< One past the last buffered sample position. */
+    std::atomic<int64> nextPlayPos{ 0 }; /**< Position of the next sample handed to the audio thread. */
+    bool wasSourceLooping = false; /**< Looping state the buffer was filled with. */
+    bool isPrepared = false; /**< Whether prepareToPlay has been called. */
+
+    std::atomic<int> numUnderruns{ 0 }; /**< Blocks that could not be served from the buffer. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReadAheadAudioSource)
+};
@@ -0,0 +1,286 @@
+/*
+  ==============================================================================
+
+    RealtimeSafetyChecker.cpp
+    Created: 17 Oct 2026 10:46:35pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Per-thread real-time scopes - DONE
+ * 2. Replace operator new and delete - DONE
+ * 3. Interpose malloc, locks and blocking system calls on Linux - DONE
+ * 4. Report each place once with a stack trace, abort on request - DONE
+ * 5. Summary of every place and its count - DONE
+ * 6. posix_memalign rejects a zero alignment like glibc's - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "RealtimeSafetyChecker.h"
+
+#if OTODECKS_RT_SAFETY_CHECKS
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+
+#if JUCE_LINUX && defined(__GLIBC__)
+ #define OTODECKS_RT_SAFETY_INTERPOSE 1
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <sys/select.h>
+ #include <time.h>
+ #include <unistd.h>
+
+extern "C" {
+    // glibc's own allocator, under the names it keeps for code that replaces malloc
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *pointer, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void *pointer);
+}
+#else
+ #define OTODECKS_RT_SAFETY_INTERPOSE 0
+#endif
+
+namespace {
+    /** Real-time scopes the calling thread is in, plain data so the allocator can read it at any time. */
+    thread_local int realtimeDepth = 0;
+
+    /** True while the calling thread reports, which allocates, locks and writes itself. */
+    thread_local bool reporting = false;
+
+    /** Violations so far, across all threads. */
+    std::atomic<int> numViolations{ 0 };
+
+    /**
+     * @struct Site
+     * @brief A place a violation happened.
+     */
+    struct Site {
+        const char *what = nullptr; /**< What was called. */
+        int count = 0; /**< How often. */
+    };
+
+    /** The lock guarding the sites. */
+    CriticalSection &getSitesLock() {
+        static CriticalSection lock;
+        return lock;
+    }
+
+    /** Places violations happened by stack trace, never freed so a late audio thread can still report. */
+    std::map<String, Site> &getSites() {
+        static auto *sites = new std::map<String, Site>();
+        return *sites;
+    }
+
+    /** Check whether the first violation should abort, for a debugger or CI. */
+    bool shouldAbort() {
+        static const bool abortOnViolation = SystemStats::getEnvironmentVariable("OTODECKS_RT_SAFETY_ABORT", {}).getIntValue() != 0;
+        return abortOnViolation;
+    }
+
+    /**
+     * @brief Remember where a violation happened and print the trace the first time.
+     * @param what What was called.
+     */
+    void report(const char *what) {
+        const String trace = SystemStats::getStackBacktrace();
+        bool firstAtSite = false;
+        {
+            const ScopedLock lock(getSitesLock());
+            auto &site = getSites()[trace];
+            site.what = what;
+            firstAtSite = site.count++ == 0;
+        }
+
+        if (firstAtSite) {
+            std::fprintf(stderr, "real-time safety: %s on a real-time thread\n%s\n", what, trace.toRawUTF8());
+            std::fflush(stderr);
+        }
+    }
+
+    /**
+     * @brief Record a call that isn't real-time safe if the calling thread is in a real-time scope.
+     *
+     * Reporting takes a stack trace, locks and prints, which would be checked again, so the
+     * calls made while reporting pass straight through.
+     *
+     * @param what What was called.
+     */
+    void check(const char *what) {
+        if (realtimeDepth == 0 || reporting) {
+            return;
+        }
+
+        reporting = true;
+        ++numViolations;
+        report(what);
+
+        if (shouldAbort()) {
+            std::abort();
+        }
+        reporting = false;
+    }
+}
+
+void RealtimeSafetyChecker::enterRealtime() {
+    ++realtimeDepth;
+}
+
+void RealtimeSafetyChecker::exitRealtime() {
+    jassert(realtimeDepth > 0);
+    --realtimeDepth;
+}
+
+int RealtimeSafetyChecker::getNumViolations() {
+    return numViolations.load();
+}
+
+void RealtimeSafetyChecker::printSummary() {
+    const ScopedLock lock(getSitesLock());
+    const auto &sites = getSites();
+
+    std::fprintf(stderr, "real-time safety: %d violations at %d places\n", numViolations.load(), (int) sites.size());
+    for (const auto &site : sites) {
+        // the first frames are the checker, the caller's frame is the most useful line after it
+        std::fprintf(stderr, "  %8d x  %s\n%s\n", site.second.count, site.second.what, site.first.toRawUTF8());
+    }
+    std::fflush(stderr);
+}
+
+//==============================================================================
+#if OTODECKS_RT_SAFETY_INTERPOSE
+
+// everything allocates through malloc, so operator new is caught here too
+extern "C" void *malloc(size_t size) {
+    check("malloc");
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size) {
+    check("calloc");
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size) {
+    check("realloc");
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" void *memalign(size_t alignment, size_t size) {
+    check("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size) {
+    check("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void **pointer, size_t alignment, size_t size) {
+    check("posix_memalign");
+    if (alignment == 0 || alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    *pointer = __libc_memalign(alignment, size);
+    return *pointer != nullptr || size == 0 ? 0 : ENOMEM;
+}
+
+extern "C" void free(void *pointer) {
+    if (pointer != nullptr) {
+        check("free");
+    }
+    __libc_free(pointer);
+}
+
+/**
+ * Define a function that checks, then calls the next definition of the same name, in libc or
+ * libpthread. The next definition is looked up on the first call.
+ */
+#define OTODECKS_RT_SAFETY_WRAP(returnType, name, parameters, arguments) \
+    extern "C" returnType name parameters { \
+        check(#name); \
+        using Function = returnType (*) parameters; \
+        static const auto next = reinterpret_cast<Function>(dlsym(RTLD_NEXT, #name)); \
+        return next arguments; \
+    }
+
+// locks that may wait, the try variants never do and are fine
+OTODECKS_RT_SAFETY_WRAP(int, pthread_mutex_lock, (pthread_mutex_t *mutex), (mutex))
+OTODECKS_RT_SAFETY_WRAP(int, pthread_rwlock_rdlock, (pthread_rwlock_t *lock), (lock))
+OTODECKS_RT_SAFETY_WRAP(int, pthread_rwlock_wrlock, (pthread_rwlock_t *lock), (lock))
+OTODECKS_RT_SAFETY_WRAP(int, pthread_cond_wait, (pthread_cond_t *condition, pthread_mutex_t *mutex), (condition, mutex))
+OTODECKS_RT_SAFETY_WRAP(int, pthread_cond_timedwait, (pthread_cond_t *condition, pthread_mutex_t *mutex, const struct timespec *time), (condition, mutex, time))
+OTODECKS_RT_SAFETY_WRAP(int, pthread_join, (pthread_t thread, void **result), (thread, result))
+OTODECKS_RT_SAFETY_WRAP(int, sem_wait, (sem_t *semaphore), (semaphore))
+
+// sleeping, waiting for files and writing, std::cout included
+OTODECKS_RT_SAFETY_WRAP(int, nanosleep, (const struct timespec *duration, struct timespec *remaining), (duration, remaining))
+OTODECKS_RT_SAFETY_WRAP(int, usleep, (useconds_t microseconds), (microseconds))
+OTODECKS_RT_SAFETY_WRAP(int, select, (int numFiles, fd_set *readFiles, fd_set *writeFiles, fd_set *errorFiles, struct timeval *timeout),
+                        (numFiles, readFiles, writeFiles, errorFiles, timeout))
+OTODECKS_RT_SAFETY_WRAP(ssize_t, write, (int file, const void *data, size_t size), (file, data, size))
+OTODECKS_RT_SAFETY_WRAP(int, fsync, (int file), (file))
+
+#undef OTODECKS_RT_SAFETY_WRAP
+
+#else
+
+// elsewhere only the heap can be replaced portably
+void *operator new(std::size_t size) {
+    check("operator new");
+    if (void *pointer = std::malloc(size > 0 ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    check("operator new[]");
+    if (void *pointer = std::malloc(size > 0 ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    if (pointer != nullptr) {
+        check("operator delete");
+    }
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    if (pointer != nullptr) {
+        check("operator delete[]");
+    }
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+    operator delete[](pointer);
+}
+
+#endif
+
+#else
+
+int RealtimeSafetyChecker::getNumViolations() {
+    return 0;
+}
+
+void RealtimeSafetyChecker::printSummary() {}
+
+#endif
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    RealtimeSafetyChecker.h
+    Created: 17 Oct 2026 10:46:35pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#ifndef OTODECKS_RT_SAFETY_CHECKS
+ #define OTODECKS_RT_SAFETY_CHECKS 0
+#endif
+
+using namespace juce;
+
+/**
+ * @class RealtimeSafetyChecker
+ * @brief Catches code on the audio thread that may block, in builds made to look for it.
+ *
+ * The audio callback marks itself with a ScopedRealtime. In builds with
+ * OTODECKS_RT_SAFETY_CHECKS=1 (the RTSafety configuration), every heap allocation and release,
+ * every blocking lock and every blocking system call made while a thread is inside such a scope
+ * is reported on stderr with a stack trace, the first time it happens at each place. At the end
+ * a summary lists every place and how often it was hit. Setting the environment variable
+ * OTODECKS_RT_SAFETY_ABORT=1 aborts at the first violation instead, for a debugger or a CI run.
+ *
+ * On Linux with glibc, malloc and its relatives, pthread mutex, rwlock, condition variable and
+ * join, sem_wait, nanosleep, usleep, select, write and fsync are interposed. On other systems only
+ * the global operator new and delete are replaced. Page faults, e.g. on a memory-mapped track,
+ * aren't calls and can't be seen.
+ *
+ * `--render` exits with code 4 if its mix had any violation. The decks play without locks and
+ * offline tracks are decoded while they load, so a clean session renders without any; only a
+ * track too big for the decoded track cache is still decoded, and reported, inside the mix.
+ *
+ * In normal builds the scope is empty and costs nothing.
+ */
+class RealtimeSafetyChecker {
+public:
+    /**
+     * @class ScopedRealtime
+     * @brief Marks the calling thread as real-time while it exists, scopes can nest.
+     */
+    class ScopedRealtime {
+    public:
+        /** Constructor, enters the real-time scope. */
+        ScopedRealtime() {
+           #if OTODECKS_RT_SAFETY_CHECKS
+            enterRealtime();
+           #endif
+        }
+
+        /** Destructor, leaves the real-time scope. */
+        ~ScopedRealtime() {
+           #if OTODECKS_RT_SAFETY_CHECKS
+            exitRealtime();
+           #endif
+        }
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtime)
+    };
+
+    /**
+     * @brief Check whether the checks are built in.
+     * @return True in builds with OTODECKS_RT_SAFETY_CHECKS=1.
+     */
+    static constexpr bool isEnabled() {
+        return OTODECKS_RT_SAFETY_CHECKS != 0;
+    }
+
+    /**
+     * @brief Get the number of violations so far.
+     * @return The number of violations, always 0 without the checks.
+     */
+    static int getNumViolations();
+
+    /** Print every place a violation happened and how often to stderr, nothing without the checks. */
+    static void printSummary();
+
+private:
+    /** Mark the calling thread as real-time. */
+    static void enterRealtime();
+
+    /** Leave the innermost real-time scope of the calling thread. */
+    static void exitRealtime();
+};
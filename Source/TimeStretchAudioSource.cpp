@@ -0,0 +1,282 @@
+/*
+  ==============================================================================
+
+    TimeStretchAudioSource.cpp
+    Created: 17 Oct 2026 5:24:16pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Size frames, hops and search range for the sample rate - DONE
+ * 2. Buffer the input with a mono mix for the similarity search - DONE
+ * 3. Find the best aligned frame with a coarse-to-fine search - DONE
+ * 4. Window and overlap-add the frames with vector operations - DONE
+ * 5. Report how much input is buffered ahead of the frame being played - DONE
+ * 6. Size frames from the track's rate instead of the device's, without reallocating - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "TimeStretchAudioSource.h"
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#elif JUCE_ARM && defined(__ARM_NEON)
+ #include <arm_neon.h>
+#endif
+
+TimeStretchAudioSource::TimeStretchAudioSource(AudioSource *_input) : input(_input) {}
+
+TimeStretchAudioSource::~TimeStretchAudioSource() {}
+
+void TimeStretchAudioSource::setSpeed(double newSpeed) {
+    speed = jlimit(0.25, 4.0, newSpeed);
+}
+
+void TimeStretchAudioSource::reset() {
+    inputStart = 0;
+    numBuffered = 0;
+    analysisPosition = 0.0;
+    previousFramePosition = -1;
+    overlapBuffer.clear();
+    outputReadIndex = hopSize; // nothing finished yet
+}
+
+void TimeStretchAudioSource::setSourceSampleRate(double sampleRate) {
+    sourceSampleRate = sampleRate;
+    if (maxFrameSize > 0) {
+        configureFrames(sourceSampleRate > 0.0 ? sourceSampleRate : outputSampleRate);
+    }
+}
+
+int TimeStretchAudioSource::getFrameSize(double sampleRate) {
+    return jmax(64, roundToInt(sampleRate * 0.023) & ~7);
+}
+
+void TimeStretchAudioSource::configureFrames(double sampleRate) {
+    const int newFrameSize = jmin(maxFrameSize, getFrameSize(sampleRate));
+    if (newFrameSize == frameSize) {
+        return;
+    }
+
+    frameSize = newFrameSize;
+    hopSize = frameSize / 2;
+    tolerance = frameSize / 4;
+
+    // no allocation, the window has room for the longest frame
+    for (int i = 0; i < frameSize; ++i) {
+        window[(size_t) i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * (float) i / (float) frameSize);
+    }
+
+    reset();
+}
+
+void TimeStretchAudioSource::prepareToPlay(int samplesPerBlockExpected, double sampleRate) {
+    outputSampleRate = sampleRate;
+    maxFrameSize = getFrameSize(jmax(sampleRate, maxSourceSampleRate));
+    window.resize((size_t) maxFrameSize);
+
+    // enough for the furthest frames apart at the highest speed, plus one pull
+    const int capacity = 6 * maxFrameSize + pullSize;
+    inputBuffer.setSize(numChannels, capacity);
+    monoBuffer.setSize(1, capacity);
+    overlapBuffer.setSize(numChannels, maxFrameSize);
+    frameBuffer.setSize(numChannels, maxFrameSize);
+
+    frameSize = 0;
+    configureFrames(sourceSampleRate > 0.0 ? sourceSampleRate : outputSampleRate);
+}
+
+void TimeStretchAudioSource::releaseResources() {
+    inputBuffer.setSize(0, 0);
+    monoBuffer.setSize(0, 0);
+    overlapBuffer.setSize(0, 0);
+    frameBuffer.setSize(0, 0);
+    maxFrameSize = 0;
+    frameSize = 0;
+}
+
+void TimeStretchAudioSource::getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) {
+    if (frameSize == 0) {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    int done = 0;
+    while (done < bufferToFill.numSamples) {
+        if (outputReadIndex >= hopSize) {
+            processHop();
+            outputReadIndex = 0;
+        }
+
+        const int numSamples = jmin(bufferToFill.numSamples - done, hopSize - outputReadIndex);
+        for (int channel = 0; channel < bufferToFill.buffer->getNumChannels(); ++channel) {
+            bufferToFill.buffer->copyFrom(channel, bufferToFill.startSample + done, overlapBuffer,
+                                          channel % numChannels, outputReadIndex, numSamples);
+        }
+
+        outputReadIndex += numSamples;
+        done += numSamples;
+    }
+}
+
+double TimeStretchAudioSource::getBufferedInput() const {
+    const double playedPosition = previousFramePosition < 0 ? analysisPosition
+                                                            : (double) (previousFramePosition + outputReadIndex);
+    return jmax(0.0, (double) (inputStart + numBuffered) - playedPosition);
+}
+
+void TimeStretchAudioSource::processHop() {
+    // the first hop of the accumulator has been played, move the overlapping tail to the front
+    const int tail = frameSize - hopSize;
+    for (int channel = 0; channel < numChannels; ++channel) {
+        float *accumulator = overlapBuffer.getWritePointer(channel);
+        std::memmove(accumulator, accumulator + hopSize, sizeof(float) * (size_t) tail);
+        FloatVectorOperations::clear(accumulator + tail, hopSize);
+    }
+
+    const auto nominalPosition = (int64) std::llround(analysisPosition);
+    const int64 framePosition = previousFramePosition < 0 ? nominalPosition : findBestFramePosition(nominalPosition);
+    ensureInputUpTo(framePosition + frameSize);
+
+    // window the frame and add it to the accumulator
+    for (int channel = 0; channel < numChannels; ++channel) {
+        FloatVectorOperations::multiply(frameBuffer.getWritePointer(channel), getInput(channel, framePosition),
+                                        window.data(), frameSize);
+        overlapBuffer.addFrom(channel, 0, frameBuffer, channel, 0, frameSize);
+    }
+
+    previousFramePosition = framePosition;
+    analysisPosition += hopSize * speed;
+
+    // keep what the next search can still reach
+    discardInputBefore(jmin(previousFramePosition + hopSize, (int64) std::llround(analysisPosition) - tolerance));
+}
+
+int64 TimeStretchAudioSource::findBestFramePosition(int64 nominalPosition) {
+    // the new frame should continue the way the previous frame would have gone on
+    const int64 naturalPosition = previousFramePosition + hopSize;
+    ensureInputUpTo(jmax(nominalPosition + tolerance + frameSize, naturalPosition + hopSize));
+    const float *target = getMonoInput(naturalPosition);
+
+    const int minLag = (int) jmax((int64) -tolerance, inputStart - nominalPosition);
+    int bestLag = minLag;
+    float bestSimilarity = -std::numeric_limits<float>::max();
+
+    // coarse pass over the whole range, then every lag around the best coarse one
+    for (int lag = minLag; lag <= tolerance; lag += coarseStep) {
+        const float similarity = getSimilarity(nominalPosition + lag, target);
+        if (similarity > bestSimilarity) {
+            bestSimilarity = similarity;
+            bestLag = lag;
+        }
+    }
+
+    const int coarseLag = bestLag;
+    for (int lag = jmax(minLag, coarseLag - coarseStep + 1); lag < jmin(tolerance + 1, coarseLag + coarseStep); ++lag) {
+        const float similarity = lag != coarseLag ? getSimilarity(nominalPosition + lag, target) : bestSimilarity;
+        if (similarity > bestSimilarity) {
+            bestSimilarity = similarity;
+            bestLag = lag;
+        }
+    }
+
+    return nominalPosition + bestLag;
+}
+
+float TimeStretchAudioSource::getSimilarity(int64 candidatePosition, const float *target) const {
+    // normalised by the candidate's energy, so loud passages don't win just for being loud
+    float dot, energy;
+    dotAndEnergy(getMonoInput(candidatePosition), target, frameSize - hopSize, dot, energy);
+    return dot / std::sqrt(energy + 1.0e-9f);
+}
+
+void TimeStretchAudioSource::ensureInputUpTo(int64 endPosition) {
+    while (inputStart + numBuffered < endPosition) {
+        const int numSamples = jmin(pullSize, inputBuffer.getNumSamples() - numBuffered);
+        if (numSamples <= 0) {
+            jassertfalse; // the buffer is sized for the widest search, this should never happen
+            break;
+        }
+
+        AudioSourceChannelInfo info(&inputBuffer, numBuffered, numSamples);
+        input->getNextAudioBlock(info);
+
+        float *mono = monoBuffer.getWritePointer(0, numBuffered);
+        FloatVectorOperations::copyWithMultiply(mono, inputBuffer.getReadPointer(0, numBuffered), 0.5f, numSamples);
+        FloatVectorOperations::addWithMultiply(mono, inputBuffer.getReadPointer(1, numBuffered), 0.5f, numSamples);
+
+        numBuffered += numSamples;
+    }
+}
+
+void TimeStretchAudioSource::discardInputBefore(int64 position) {
+    const int numToDrop = (int) jlimit((int64) 0, (int64) numBuffered, position - inputStart);
+    if (numToDrop == 0) {
+        return;
+    }
+
+    const int numLeft = numBuffered - numToDrop;
+    for (int channel = 0; channel < numChannels; ++channel) {
+        float *samples = inputBuffer.getWritePointer(channel);
+        std::memmove(samples, samples + numToDrop, sizeof(float) * (size_t) numLeft);
+    }
+    float *mono = monoBuffer.getWritePointer(0);
+    std::memmove(mono, mono + numToDrop, sizeof(float) * (size_t) numLeft);
+
+    inputStart += numToDrop;
+    numBuffered = numLeft;
+}
+
+const float *TimeStretchAudioSource::getInput(int channel, int64 position) const {
+    return inputBuffer.getReadPointer(channel, (int) (position - inputStart));
+}
+
+const float *TimeStretchAudioSource::getMonoInput(int64 position) const {
+    return monoBuffer.getReadPointer(0, (int) (position - inputStart));
+}
+
+void TimeStretchAudioSource::dotAndEnergy(const float *a, const float *b, int numSamples, float &dot, float &energy) {
+    float sumProducts = 0.0f, sumSquares = 0.0f;
+    int i = 0;
+
+#if JUCE_INTEL
+    __m128 products = _mm_setzero_ps(), squares = _mm_setzero_ps();
+
+    for (; i + 4 <= numSamples; i += 4) {
+        const __m128 va = _mm_loadu_ps(a + i);
+        products = _mm_add_ps(products, _mm_mul_ps(va, _mm_loadu_ps(b + i)));
+        squares = _mm_add_ps(squares, _mm_mul_ps(va, va));
+    }
+
+    alignas(16) float lanes[2][4];
+    _mm_store_ps(lanes[0], products);
+    _mm_store_ps(lanes[1], squares);
+    sumProducts = (lanes[0][0] + lanes[0][1]) + (lanes[0][2] + lanes[0][3]);
+    sumSquares = (lanes[1][0] + lanes[1][1]) + (lanes[1][2] + lanes[1][3]);
+#elif JUCE_ARM && defined(__ARM_NEON)
+    float32x4_t products = vdupq_n_f32(0.0f), squares = vdupq_n_f32(0.0f);
+
+    for (; i + 4 <= numSamples; i += 4) {
+        const float32x4_t va = vld1q_f32(a + i);
+        products = vmlaq_f32(products, va, vld1q_f32(b + i));
+        squares = vmlaq_f32(squares, va, va);
+    }
+
+    float lanes[2][4];
+    vst1q_f32(lanes[0], products);
+    vst1q_f32(lanes[1], squares);
+    sumProducts = (lanes[0][0] + lanes[0][1]) + (lanes[0][2] + lanes[0][3]);
+    sumSquares = (lanes[1][0] + lanes[1][1]) + (lanes[1][2] + lanes[1][3]);
+#endif
+
+    // the tail, or everything without SIMD
+    for (; i < numSamples; ++i) {
+        sumProducts += a[i] * b[i];
+        sumSquares += a[i] * a[i];
+    }
+
+    dot = sumProducts;
+    energy = sumSquares;
+}
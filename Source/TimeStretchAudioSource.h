@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+
+    TimeStretchAudioSource.h
+    Created: 17 Oct 2026 5:24:16pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <vector>
+
+using namespace juce;
+
+/**
+ * @class TimeStretchAudioSource
+ * @brief Changes the tempo of its input without changing the pitch, for key-locked decks.
+ *
+ * Uses WSOLA (waveform similarity overlap-add): the output is built from Hann-windowed frames of
+ * about 23 ms that overlap by half. Frames are taken from the input further apart or closer
+ * together than they are written, depending on the speed, and each frame is shifted by up to a
+ * quarter of its length to the position where it lines up best with the end of the previous one,
+ * which keeps the waveform continuous. The best position is found with a coarse-to-fine search
+ * over a mono mix, so every frame costs the same amount of work whatever the speed.
+ *
+ * The input is pulled at roughly speed times the output rate. Frames are sized from the rate of
+ * the input, set with setSourceSampleRate(), since that is the audio being cut up; the buffers
+ * are allocated for the highest rate a track can have, so a new track never reallocates. The
+ * input source is not prepared or released by this class.
+ */
+class TimeStretchAudioSource : public AudioSource {
+public:
+    /**
+     * @brief Constructor.
+     * @param input The source to stretch, which must outlive this object.
+     */
+    TimeStretchAudioSource(AudioSource *input);
+
+    /** Destructor. */
+    ~TimeStretchAudioSource() override;
+
+    /**
+     * @brief Set the tempo, only from the audio thread.
+     * @param speed Input seconds played per output second, limited to 0.25 to 4.
+     */
+    void setSpeed(double speed);
+
+    /**
+     * @brief Size the frames for the rate of the input, only from the audio thread.
+     * @param sampleRate The rate of the input, or 0 to use the rate given to prepareToPlay().
+     */
+    void setSourceSampleRate(double sampleRate);
+
+    /** @brief Forget all buffered audio, e.g. after a jump in the input, only from the audio thread. */
+    void reset();
+
+    /**
+     * @brief Get how far the input has been pulled ahead of what is being played, only from the audio thread.
+     *
+     * The output blends two overlapping frames, this follows the newer one, so away from speed 1
+     * it is off by up to a fraction of a hop.
+     *
+     * @return The number of input samples buffered past the input position being played.
+     */
+    double getBufferedInput() const;
+
+    /**
+     * @brief Allocate the frame buffers for the highest input rate and size the frames for the current one.
+     * @param samplesPerBlockExpected The number of samples per block expected.
+     * @param sampleRate The sample rate of the audio.
+     */
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) override;
+
+    /**
+     * @brief Render stretched audio.
+     * @param bufferToFill The buffer to fill with audio data.
+     */
+    void getNextAudioBlock(const AudioSourceChannelInfo &bufferToFill) override;
+
+    /** Release the frame buffers. */
+    void releaseResources() override;
+
+private:
+    /** Get the frame size for an input rate, about 23 ms, a multiple of 8 so hops and the search range stay aligned. */
+    static int getFrameSize(double sampleRate);
+
+    /** Size the frames, hops and search range for an input rate, within the allocated buffers. */
+    void configureFrames(double sampleRate);
+
+    /** Produce the next hop of finished output. */
+    void processHop();
+
+    /** Find where the next frame lines up best with the end of the previous one. */
+    int64 findBestFramePosition(int64 nominalPosition);
+
+    /** Score a candidate frame position against the natural continuation of the previous frame. */
+    float getSimilarity(int64 candidatePosition, const float *target) const;
+
+    /** Pull input until the buffer reaches the given absolute position. */
+    void ensureInputUpTo(int64 endPosition);
+
+    /** Drop buffered input before the given absolute position. */
+    void discardInputBefore(int64 position);
+
+    /** Get the buffered samples of a channel starting at an absolute position. */
+    const float *getInput(int channel, int64 position) const;
+
+    /** Get the buffered mono mix starting at an absolute position. */
+    const float *getMonoInput(int64 position) const;
+
+    /** Get the dot product of two blocks and the energy of the first, in one SIMD pass. */
+    static void dotAndEnergy(const float *a, const float *b, int numSamples, float &dot, float &energy);
+
+    static constexpr int numChannels = 2; /**< Decks play in stereo. */
+    static constexpr int pullSize = 256; /**< Input samples pulled from the source at a time. */
+    static constexpr int coarseStep = 4; /**< Lag step of the coarse search, refined to single samples afterwards. */
+    static constexpr double maxSourceSampleRate = 192000.0; /**< Highest track rate the buffers are allocated for. */
+
+    AudioSource *input; /**< The source being stretched. */
+    double speed = 1.0; /**< Input seconds played per output second. */
+
+    double outputSampleRate = 0.0; /**< Rate given to prepareToPlay(). */
+    double sourceSampleRate = 0.0; /**< Rate of the input, 0 if it runs at the output rate. */
+    int maxFrameSize = 0; /**< Longest frame the buffers have room for, 0 until prepared. */
+    int frameSize = 0; /**< Length of each windowed frame. */
+    int hopSize = 0; /**< Output samples between frames, half a frame. */
+    int tolerance = 0; /**< How far a frame may be shifted from its nominal position. */
+    std::vector<float> window; /**< Periodic Hann window, overlapping halves add up to 1. */
+
+    AudioBuffer<float> inputBuffer; /**< Buffered input. */
+    AudioBuffer<float> monoBuffer; /**< Mono mix of the buffered input, used for the search. */
+    int64 inputStart = 0; /**< Absolute position of the first buffered input sample. */
+    int numBuffered = 0; /**< Number of buffered input samples. */
+
+    double analysisPosition = 0.0; /**< Nominal input position of the next frame. */
+    int64 previousFramePosition = -1; /**< Input position of the previous frame, -1 before the first one. */
+
+    AudioBuffer<float> overlapBuffer; /**< Overlap-add accumulator, one frame long. */
+    AudioBuffer<float> frameBuffer; /**< Scratch for one windowed frame. */
+    int outputReadIndex = 0; /**< Next finished sample in the first hop of the accumulator. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeStretchAudioSource)
+};
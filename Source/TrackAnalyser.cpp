@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    TrackAnalyser.cpp
+    Created: 17 Oct 2026 6:41:12pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Run analysis jobs on background-priority workers, leaving a core free - DONE
+ * 2. Decode each track once and feed it to the beat detector - DONE
+ * 3. Deliver results to the message thread in batches - DONE
+ * 4. Measure throughput in tracks per minute - DONE
+ * 5. Detect the key in the same pass, with workspaces reused across tracks - DONE
+ * 6. Measure the loudness and true peak in the same pass - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "TrackAnalyser.h"
+#include "BeatDetector.h"
+
+/**
+ * @class TrackAnalyser::AnalysisJob
+ * @brief Decodes a single track and analyses it.
+ */
+class TrackAnalyser::AnalysisJob : public ThreadPoolJob {
+public:
+    AnalysisJob(TrackAnalyser &_owner, TrackId _trackId, File _file, int _generation)
+            : ThreadPoolJob("Track analysis"), owner(_owner), trackId(_trackId), file(std::move(_file)),
+              generation(_generation) {}
+
+    JobStatus runJob() override {
+        // missing files are left unanalysed in case their drive comes back
+        if (!shouldExit() && owner.generation.load() == generation && file.existsAsFile()) {
+            Result result;
+            result.trackId = trackId;
+            result.modificationTime = file.getLastModificationTime().toMilliseconds();
+
+            if (analyse(result.analysis)) {
+                owner.addResult(result, generation);
+            }
+        }
+
+        owner.jobFinished(generation);
+        return jobHasFinished;
+    }
+
+private:
+    /** Decode the whole track through the detectors, false if the analysis was cancelled. */
+    bool analyse(TrackAnalysis &analysis) {
+        // a file that can't be decoded is still marked as analysed, so it isn't retried on every start
+        analysis.analysed = true;
+
+        std::unique_ptr<AudioFormatReader> reader(owner.formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->sampleRate <= 0 || reader->lengthInSamples <= 0) {
+            return true;
+        }
+
+        constexpr int blockSize = 65536;
+        const int64 length = reader->lengthInSamples;
+
+        auto workspace = owner.acquireWorkspace();
+        AudioBuffer<float> &block = workspace->block;
+        block.setSize((int) jmax(1u, reader->numChannels), blockSize, false, false, true);
+
+        BeatDetector beatDetector(reader->sampleRate);
+        KeyDetector &keyDetector = workspace->keyDetector;
+        keyDetector.reset(reader->sampleRate);
+        LoudnessMeter &loudnessMeter = workspace->loudnessMeter;
+        loudnessMeter.reset(reader->sampleRate);
+
+        bool finished = true;
+        for (int64 pos = 0; pos < length; pos += blockSize) {
+            if (shouldExit() || owner.generation.load() != generation) {
+                finished = false; // a half-analysed track is never reported
+                break;
+            }
+
+            const int numSamples = (int) jmin((int64) blockSize, length - pos);
+            reader->read(&block, 0, numSamples, pos, true, true);
+            beatDetector.process(block, numSamples);
+            keyDetector.process(block, numSamples);
+            loudnessMeter.process(block, numSamples);
+        }
+
+        if (finished) {
+            beatDetector.finish(analysis);
+            keyDetector.finish(analysis);
+            loudnessMeter.finish(analysis);
+        }
+
+        owner.releaseWorkspace(std::move(workspace));
+        return finished;
+    }
+
+    TrackAnalyser &owner;
+    TrackId trackId;
+    File file;
+    int generation;
+};
+
+TrackAnalyser::TrackAnalyser(AudioFormatManager &_formatManager)
+        : formatManager(_formatManager),
+          pool(jmax(1, SystemStats::getNumCpus() - 1), 0, Thread::Priority::background) {}
+
+TrackAnalyser::~TrackAnalyser() {
+    ++generation;
+    pool.removeAllJobs(true, 5000);
+    cancelPendingUpdate();
+}
+
+std::unique_ptr<TrackAnalyser::Workspace> TrackAnalyser::acquireWorkspace() {
+    {
+        const ScopedLock sl(workspaceLock);
+
+        if (!freeWorkspaces.empty()) {
+            auto workspace = std::move(freeWorkspaces.back());
+            freeWorkspaces.pop_back();
+            return workspace;
+        }
+    }
+
+    // only the first job on each worker gets here
+    return std::make_unique<Workspace>();
+}
+
+void TrackAnalyser::releaseWorkspace(std::unique_ptr<Workspace> workspace) {
+    const ScopedLock sl(workspaceLock);
+    freeWorkspaces.push_back(std::move(workspace));
+}
+
+void TrackAnalyser::analyse(TrackId trackId, const File &file) {
+    {
+        const ScopedLock sl(resultsLock);
+
+        if (numDone == numQueued) {
+            // the queue was empty, so a new run starts for the throughput
+            numQueued = 0;
+            numDone = 0;
+            runStartMs = Time::getMillisecondCounterHiRes();
+            runEndMs = 0.0;
+        }
+        ++numQueued;
+    }
+
+    pool.addJob(new AnalysisJob(*this, trackId, file, generation.load()), true);
+}
+
+void TrackAnalyser::cancel() {
+    // bump the generation first so running jobs drop their results
+    ++generation;
+    pool.removeAllJobs(true, 0);
+
+    const ScopedLock sl(resultsLock);
+    pendingResults.clear();
+    numQueued = 0;
+    numDone = 0;
+}
+
+int TrackAnalyser::getNumPending() const {
+    const ScopedLock sl(resultsLock);
+    return numQueued - numDone;
+}
+
+double TrackAnalyser::getTracksPerMinute() const {
+    const ScopedLock sl(resultsLock);
+    const double endMs = runEndMs > 0.0 ? runEndMs : Time::getMillisecondCounterHiRes();
+    const double minutes = (endMs - runStartMs) / 60000.0;
+    return minutes > 0.0 ? numDone / minutes : 0.0;
+}
+
+void TrackAnalyser::addResult(const Result &result, int resultGeneration) {
+    const ScopedLock sl(resultsLock);
+
+    if (resultGeneration == generation.load()) {
+        pendingResults.push_back(result);
+    }
+}
+
+void TrackAnalyser::jobFinished(int jobGeneration) {
+    {
+        const ScopedLock sl(resultsLock);
+
+        if (jobGeneration != generation.load()) {
+            return;
+        }
+
+        if (++numDone == numQueued) {
+            runEndMs = Time::getMillisecondCounterHiRes();
+        }
+    }
+
+    triggerAsyncUpdate();
+}
+
+void TrackAnalyser::handleAsyncUpdate() {
+    std::vector<Result> batch;
+    bool finished;
+
+    {
+        const ScopedLock sl(resultsLock);
+        batch.swap(pendingResults);
+        finished = numQueued > 0 && numDone == numQueued;
+    }
+
+    if (!batch.empty() && onTracksAnalysed != nullptr) {
+        onTracksAnalysed(batch);
+    }
+
+    if (finished && onAnalysisFinished != nullptr) {
+        onAnalysisFinished();
+    }
+}
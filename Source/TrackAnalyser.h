@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    TrackAnalyser.h
+    Created: 17 Oct 2026 6:41:12pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <vector>
+#include "TrackStore.h"
+#include "TrackAnalysis.h"
+#include "KeyDetector.h"
+#include "LoudnessMeter.h"
+
+using namespace juce;
+
+/**
+ * @class TrackAnalyser
+ * @brief Decodes library tracks on background threads and finds their tempo, beatgrid, key and loudness.
+ *
+ * The workers run at the lowest thread priority and leave one core free, so analysis never
+ * competes with the audio callback. Results are collected from the workers and handed to the
+ * message thread in batches. The library stores which tracks have been analysed, so tracks still
+ * waiting when the app is closed are queued again on the next start.
+ *
+ * Each worker takes a Workspace with a preallocated decode buffer, a key detector with its FFT
+ * plan and a loudness meter, and hands it back for the next track, so a long run over a large
+ * library doesn't allocate per track.
+ */
+class TrackAnalyser : private AsyncUpdater {
+public:
+    /**
+     * @struct Result
+     * @brief The analysis of one track.
+     */
+    struct Result {
+        TrackId trackId = TrackStore::invalidId; /**< The analysed track. */
+        int64 modificationTime = 0; /**< Modification time of the file that was analysed, in milliseconds. */
+        TrackAnalysis analysis; /**< What the analysis found. */
+    };
+
+    /**
+     * @brief Constructor.
+     * @param formatManager The audio format manager used to decode tracks.
+     */
+    TrackAnalyser(AudioFormatManager &formatManager);
+
+    /** Destructor, stops the running analyses. */
+    ~TrackAnalyser() override;
+
+    /**
+     * @brief Queue a track for analysis.
+     * @param trackId The id of the track in the TrackStore.
+     * @param file The audio file of the track.
+     */
+    void analyse(TrackId trackId, const File &file);
+
+    /** Drop all queued analyses and stop the running ones. */
+    void cancel();
+
+    /**
+     * @brief Get the number of tracks queued or being analysed.
+     * @return The number of tracks still to be analysed.
+     */
+    int getNumPending() const;
+
+    /**
+     * @brief Get how fast the current run analyses tracks.
+     * @return Tracks analysed per minute since the queue was last empty.
+     */
+    double getTracksPerMinute() const;
+
+    /** Called on the message thread with every new batch of analysed tracks. */
+    std::function<void(const std::vector<Result> &)> onTracksAnalysed;
+
+    /** Called on the message thread when every queued track has been analysed. */
+    std::function<void()> onAnalysisFinished;
+
+private:
+    class AnalysisJob;
+
+    /**
+     * @struct Workspace
+     * @brief Buffers one worker reuses from track to track.
+     */
+    struct Workspace {
+        AudioBuffer<float> block; /**< Decoded audio of the current block. */
+        KeyDetector keyDetector; /**< Key detector with its FFT plan. */
+        LoudnessMeter loudnessMeter; /**< Loudness and true peak meter. */
+    };
+
+    /** Take a free workspace, or make one if every workspace is in use. */
+    std::unique_ptr<Workspace> acquireWorkspace();
+
+    /** Hand a workspace back for the next job. */
+    void releaseWorkspace(std::unique_ptr<Workspace> workspace);
+
+    /** Store the result of an analysis job. */
+    void addResult(const Result &result, int generation);
+
+    /** Count a finished analysis job and notify the message thread. */
+    void jobFinished(int generation);
+
+    /** Deliver the collected results on the message thread. */
+    void handleAsyncUpdate() override;
+
+    AudioFormatManager &formatManager; /**< Format manager used to decode tracks. */
+    ThreadPool pool; /**< Workers, one per CPU core but one. */
+    std::atomic<int> generation{ 0 }; /**< Incremented on cancel so late results are dropped. */
+
+    CriticalSection workspaceLock; /**< Guards the free workspaces. */
+    std::vector<std::unique_ptr<Workspace>> freeWorkspaces; /**< Workspaces not in use, at most one per worker. */
+
+    CriticalSection resultsLock; /**< Guards the fields below. */
+    std::vector<Result> pendingResults; /**< Results not yet delivered. */
+    int numQueued = 0; /**< Tracks queued in this run. */
+    int numDone = 0; /**< Tracks analysed in this run. */
+    double runStartMs = 0.0; /**< When the queue last went from empty to busy. */
+    double runEndMs = 0.0; /**< When the queue last became empty, 0 while busy. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackAnalyser)
+};
@@ -0,0 +1,32 @@
+/*
+  ==============================================================================
+
+    TrackAnalysis.h
+    Created: 17 Oct 2026 6:41:12pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+using namespace juce;
+
+/**
+ * @struct TrackAnalysis
+ * @brief What the background analysis found out about a track.
+ *
+ * The beatgrid has a constant tempo: beats fall every 60 / bpm seconds, forwards and backwards
+ * from firstBeatSeconds. The key counts from C in semitones, 0 to 11 for the major keys and 12 to
+ * 23 for the minor keys. Loudness is measured as in EBU R128, silent tracks have none.
+ */
+struct TrackAnalysis {
+    bool analysed = false; /**< Whether the track has been analysed, false until its analysis job has run. */
+    double bpm = 0.0; /**< Tempo in beats per minute, 0 if no steady tempo was found. */
+    double firstBeatSeconds = 0.0; /**< Position of the first beat of the grid. */
+    int key = -1; /**< Musical key, -1 if no key was found. */
+    double loudnessLufs = -std::numeric_limits<double>::infinity(); /**< Integrated loudness, -infinity if none was measured. */
+    double truePeakDb = -std::numeric_limits<double>::infinity(); /**< Largest inter-sample peak in dBTP. */
+};
@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+    TrackSearchIndex.cpp
+    Created: 17 Oct 2026 2:02:26pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Fold titles to lower case without accents - DONE
+ * 2. Keep sorted posting lists per trigram, updated as tracks are added - DONE
+ * 3. Answer queries by intersecting posting lists and verifying candidates - DONE
+ * 4. Narrow the previous results when the query is extended - DONE
+ * 5. Swap the results with the previous ones instead of copying them - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "TrackSearchIndex.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+    /** Base letters for U+00C0 to U+017F, or nullptr where the character is kept as it is. */
+    struct LatinFoldTable {
+        const char *entries[0x180 - 0xc0] = {};
+
+        LatinFoldTable() {
+            auto set = [this](juce_wchar first, juce_wchar last, const char *base) {
+                for (juce_wchar c = first; c <= last; ++c) {
+                    entries[c - 0xc0] = base;
+                }
+            };
+
+            // Latin-1 Supplement
+            set(0xc0, 0xc5, "a"); set(0xc6, 0xc6, "ae"); set(0xc7, 0xc7, "c"); set(0xc8, 0xcb, "e");
+            set(0xcc, 0xcf, "i"); set(0xd0, 0xd0, "d"); set(0xd1, 0xd1, "n"); set(0xd2, 0xd6, "o");
+            set(0xd8, 0xd8, "o"); set(0xd9, 0xdc, "u"); set(0xdd, 0xdd, "y"); set(0xde, 0xde, "th");
+            set(0xdf, 0xdf, "ss"); set(0xe0, 0xe5, "a"); set(0xe6, 0xe6, "ae"); set(0xe7, 0xe7, "c");
+            set(0xe8, 0xeb, "e"); set(0xec, 0xef, "i"); set(0xf0, 0xf0, "d"); set(0xf1, 0xf1, "n");
+            set(0xf2, 0xf6, "o"); set(0xf8, 0xf8, "o"); set(0xf9, 0xfc, "u"); set(0xfd, 0xfd, "y");
+            set(0xfe, 0xfe, "th"); set(0xff, 0xff, "y");
+
+            // Latin Extended-A
+            set(0x100, 0x105, "a"); set(0x106, 0x10d, "c"); set(0x10e, 0x111, "d"); set(0x112, 0x11b, "e");
+            set(0x11c, 0x123, "g"); set(0x124, 0x127, "h"); set(0x128, 0x131, "i"); set(0x132, 0x133, "ij");
+            set(0x134, 0x135, "j"); set(0x136, 0x138, "k"); set(0x139, 0x142, "l"); set(0x143, 0x14b, "n");
+            set(0x14c, 0x151, "o"); set(0x152, 0x153, "oe"); set(0x154, 0x159, "r"); set(0x15a, 0x161, "s");
+            set(0x162, 0x167, "t"); set(0x168, 0x173, "u"); set(0x174, 0x175, "w"); set(0x176, 0x178, "y");
+            set(0x179, 0x17e, "z"); set(0x17f, 0x17f, "s");
+        }
+    };
+
+    const LatinFoldTable latinFoldTable;
+
+    /** Append a code point to a UTF-8 string. */
+    void appendUTF8(std::string &text, juce_wchar c) {
+        char bytes[4];
+        CharPointer_UTF8 dest(bytes);
+        dest.write(c);
+        text.append(bytes, (size_t) (dest.getAddress() - bytes));
+    }
+}
+
+TrackSearchIndex::TrackSearchIndex() {}
+
+TrackSearchIndex::~TrackSearchIndex() {}
+
+std::string TrackSearchIndex::fold(std::string_view text) {
+    std::string folded;
+    folded.reserve(text.size());
+
+    const char *const end = text.data() + text.size();
+    const char *p = text.data();
+
+    while (p < end) {
+        const auto byte = (unsigned char) *p;
+
+        if (byte < 0x80) {
+            // plain ASCII, by far the most common case
+            folded.push_back((char) (byte >= 'A' && byte <= 'Z' ? byte + ('a' - 'A') : byte));
+            ++p;
+            continue;
+        }
+
+        CharPointer_UTF8 utf8(p);
+        const juce_wchar c = utf8.getAndAdvance();
+        p = jmin(utf8.getAddress(), end);
+
+        if (c >= 0xc0 && c < 0x180 && latinFoldTable.entries[c - 0xc0] != nullptr) {
+            folded.append(latinFoldTable.entries[c - 0xc0]);
+        } else {
+            appendUTF8(folded, CharacterFunctions::toLowerCase(c));
+        }
+    }
+
+    return folded;
+}
+
+uint32 TrackSearchIndex::trigramAt(const char *text) {
+    return ((uint32) (uint8) text[0] << 16) | ((uint32) (uint8) text[1] << 8) | (uint32) (uint8) text[2];
+}
+
+std::string_view TrackSearchIndex::getFoldedTitle(TrackId trackId) const {
+    return std::string_view(foldedText.data() + foldedStarts[trackId], foldedLengths[trackId]);
+}
+
+void TrackSearchIndex::addOrUpdate(TrackId trackId, std::string_view title) {
+    const std::string foldedTitle = fold(title);
+
+    if (trackId < foldedStarts.size()) {
+        if (getFoldedTitle(trackId) == foldedTitle) {
+            return; // nothing to re-index
+        }
+        updatePostings(trackId, getFoldedTitle(trackId), false);
+    } else {
+        foldedStarts.resize(trackId + 1, 0);
+        foldedLengths.resize(trackId + 1, 0);
+    }
+
+    foldedStarts[trackId] = (uint32) foldedText.size();
+    foldedLengths[trackId] = (uint32) foldedTitle.size();
+    foldedText.append(foldedTitle);
+
+    updatePostings(trackId, foldedTitle, true);
+    ++generation;
+}
+
+void TrackSearchIndex::updatePostings(TrackId trackId, std::string_view foldedTitle, bool add) {
+    for (size_t i = 0; i + 3 <= foldedTitle.size(); ++i) {
+        std::vector<TrackId> &list = postings[trigramAt(foldedTitle.data() + i)];
+
+        // ids usually arrive in ascending order, so this is an append in the common case
+        auto pos = std::lower_bound(list.begin(), list.end(), trackId);
+        const bool present = pos != list.end() && *pos == trackId;
+
+        if (add && !present) {
+            list.insert(pos, trackId);
+        } else if (!add && present) {
+            list.erase(pos);
+        }
+    }
+}
+
+const std::vector<TrackId> &TrackSearchIndex::search(std::string_view query) {
+    std::string foldedQuery = fold(query);
+    const auto numTracks = (TrackId) foldedStarts.size();
+    std::vector<TrackId> &results = nextResults;
+    results.clear();
+
+    if (foldedQuery.empty()) {
+        results.resize(numTracks);
+        std::iota(results.begin(), results.end(), (TrackId) 0);
+    } else if (lastGeneration == generation && !lastFoldedQuery.empty()
+               && foldedQuery.find(lastFoldedQuery) != std::string::npos) {
+        // the user kept typing: every match must also have matched the previous query
+        verify(lastResults, foldedQuery, results);
+    } else if (foldedQuery.size() < 3) {
+        // too short for a trigram, a straight scan over the folded titles is fast enough
+        for (TrackId trackId = 0; trackId < numTracks; ++trackId) {
+            if (getFoldedTitle(trackId).find(foldedQuery) != std::string_view::npos) {
+                results.push_back(trackId);
+            }
+        }
+    } else {
+        std::vector<const std::vector<TrackId> *> &lists = scratchLists;
+        lists.clear();
+
+        for (size_t i = 0; i + 3 <= foldedQuery.size(); ++i) {
+            auto found = postings.find(trigramAt(foldedQuery.data() + i));
+            if (found == postings.end() || found->second.empty()) {
+                lists.clear();
+                break; // one trigram matches nothing, so the whole query matches nothing
+            }
+            if (std::find(lists.begin(), lists.end(), &found->second) == lists.end()) {
+                lists.push_back(&found->second);
+            }
+        }
+
+        if (!lists.empty()) {
+            // start from the shortest list and drop candidates missing from the others
+            std::sort(lists.begin(), lists.end(), [](auto *a, auto *b) { return a->size() < b->size(); });
+            scratch.assign(lists[0]->begin(), lists[0]->end());
+
+            for (size_t l = 1; l < lists.size() && !scratch.empty(); ++l) {
+                const std::vector<TrackId> &list = *lists[l];
+
+                if (list.size() > scratch.size() * 32) {
+                    // much longer list: binary search it for each candidate
+                    scratch.erase(std::remove_if(scratch.begin(), scratch.end(), [&list](TrackId trackId) {
+                        return !std::binary_search(list.begin(), list.end(), trackId);
+                    }), scratch.end());
+                } else {
+                    // similar sizes: a linear merge is cheaper, written in place over the candidates
+                    size_t kept = 0;
+                    auto it = list.begin();
+                    for (TrackId trackId: scratch) {
+                        while (it != list.end() && *it < trackId) {
+                            ++it;
+                        }
+                        if (it == list.end()) {
+                            break;
+                        }
+                        if (*it == trackId) {
+                            scratch[kept++] = trackId;
+                        }
+                    }
+                    scratch.resize(kept);
+                }
+            }
+
+            // trigrams can match in the wrong order, so check the remaining candidates
+            verify(scratch, foldedQuery, results);
+        }
+    }
+
+    // the new results become the ones to narrow down next time, both buffers keep their capacity
+    std::swap(lastResults, nextResults);
+    lastFoldedQuery = std::move(foldedQuery);
+    lastGeneration = generation;
+    return lastResults;
+}
+
+void TrackSearchIndex::verify(const std::vector<TrackId> &candidates, std::string_view foldedQuery,
+                              std::vector<TrackId> &results) const {
+    for (TrackId trackId: candidates) {
+        if (getFoldedTitle(trackId).find(foldedQuery) != std::string_view::npos) {
+            results.push_back(trackId);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    TrackSearchIndex.h
+    Created: 17 Oct 2026 2:02:26pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace juce;
+
+/** Index of a track in the TrackStore, declared here as well so the index builds without the library. */
+using TrackId = uint32;
+
+/**
+ * @class TrackSearchIndex
+ * @brief Trigram index over the track titles for the library search bar.
+ *
+ * Titles are folded to lower case without accents before they are indexed, so searches match
+ * regardless of case and accents. Every trigram of a folded title points to a sorted list of
+ * the tracks containing it. A query intersects the lists of its trigrams, starting with the
+ * shortest, and checks the few remaining candidates with a plain substring search. When the
+ * user keeps typing, the new query only contains the previous one plus some characters, so
+ * the previous results are narrowed down instead of searching the whole library again.
+ * Tracks are added incrementally as they are imported.
+ */
+class TrackSearchIndex {
+public:
+    /** Constructor. */
+    TrackSearchIndex();
+
+    /** Destructor. */
+    ~TrackSearchIndex();
+
+    /**
+     * @brief Index a new track, or re-index a track whose title changed.
+     * @param trackId The id of the track in the TrackStore.
+     * @param title The title of the track as UTF-8.
+     */
+    void addOrUpdate(TrackId trackId, std::string_view title);
+
+    /**
+     * @brief Find all tracks whose title contains the query, ignoring case and accents.
+     *
+     * The index keeps the results to narrow them down on the next search, so they are returned
+     * by reference instead of being copied out.
+     *
+     * @param query The search text as UTF-8.
+     * @return The matching ids in ascending order, valid until the next search.
+     */
+    const std::vector<TrackId> &search(std::string_view query);
+
+    /**
+     * @brief Fold text to lower case and strip accents from Latin letters.
+     * @param text The text as UTF-8.
+     * @return The folded text as UTF-8.
+     */
+    static std::string fold(std::string_view text);
+
+private:
+    /** Pack the three bytes starting at text into a trigram key. */
+    static uint32 trigramAt(const char *text);
+
+    /** Get the folded title of an indexed track. */
+    std::string_view getFoldedTitle(TrackId trackId) const;
+
+    /** Add or remove a track in the postings of every trigram of a folded title. */
+    void updatePostings(TrackId trackId, std::string_view foldedTitle, bool add);
+
+    /** Check every candidate's folded title for the query and keep the matches. */
+    void verify(const std::vector<TrackId> &candidates, std::string_view foldedQuery,
+                std::vector<TrackId> &results) const;
+
+    std::string foldedText; /**< All folded titles, back to back. */
+    std::vector<uint32> foldedStarts; /**< Offset of each track's folded title in foldedText. */
+    std::vector<uint32> foldedLengths; /**< Length of each track's folded title. */
+
+    std::unordered_map<uint32, std::vector<TrackId>> postings; /**< Sorted track ids per trigram. */
+
+    uint32 generation = 0; /**< Incremented whenever the index changes. */
+    std::string lastFoldedQuery; /**< The previous query, folded. */
+    std::vector<TrackId> lastResults; /**< The results of the previous query, returned by search(). */
+    std::vector<TrackId> nextResults; /**< Reused buffer the next results are collected in, then swapped with lastResults. */
+    uint32 lastGeneration = 0xffffffff; /**< The generation the previous results were computed at. */
+    std::vector<TrackId> scratch; /**< Reused candidate buffer. */
+    std::vector<const std::vector<TrackId> *> scratchLists; /**< Reused buffer for the posting lists of a query's trigrams. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackSearchIndex)
+};
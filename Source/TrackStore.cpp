@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+    TrackStore.cpp
+    Created: 17 Oct 2026 1:15:44pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Store strings in an append-only arena - DONE
+ * 2. Add tracks to the columns and hand out stable ids - DONE
+ * 3. Update tracks that are added again - DONE
+ * 4. Precompute the duration text shown in the table - DONE
+ * 5. Store the tempo and beatgrid, kept while the file is unchanged - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "TrackStore.h"
+
+std::string_view TrackStore::Arena::add(std::string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+
+    if (text.size() > spaceLeft) {
+        const size_t newBlockSize = jmax(blockSize, text.size());
+        blocks.push_back(std::make_unique<char[]>(newBlockSize));
+        nextFree = blocks.back().get();
+        spaceLeft = newBlockSize;
+    }
+
+    std::memcpy(nextFree, text.data(), text.size());
+    std::string_view copy(nextFree, text.size());
+    nextFree += text.size();
+    spaceLeft -= text.size();
+    return copy;
+}
+
+TrackStore::TrackStore() {}
+
+TrackStore::~TrackStore() {}
+
+TrackId TrackStore::addOrUpdate(const ImportedTrack &track) {
+    const auto pathUTF8 = track.path.toUTF8();
+    const auto titleUTF8 = track.title.toUTF8();
+    TrackId id = findByPath(std::string_view(pathUTF8.getAddress(), pathUTF8.sizeInBytes() - 1));
+    const bool isNew = id == invalidId;
+
+    if (isNew) {
+        id = (TrackId) paths.size();
+
+        paths.push_back(arena.add(std::string_view(pathUTF8.getAddress(), pathUTF8.sizeInBytes() - 1)));
+        titles.emplace_back();
+        durations.emplace_back();
+        durationTexts.emplace_back();
+        fileSizes.emplace_back();
+        modificationTimes.emplace_back();
+        analyses.emplace_back();
+
+        idsByPath[paths.back()] = id;
+    }
+
+    // only copy the title again if it actually changed
+    const std::string_view title(titleUTF8.getAddress(), titleUTF8.sizeInBytes() - 1);
+    if (titles[id] != title) {
+        titles[id] = arena.add(title);
+    }
+
+    // a fresh probe of an unchanged file keeps the analysis, a changed file needs a new one
+    const bool fileChanged = fileSizes[id] != track.fileSize || modificationTimes[id] != track.modificationTime;
+    if (isNew || fileChanged || track.analysis.analysed) {
+        analyses[id] = track.analysis;
+    }
+
+    durations[id] = track.durationSeconds;
+    durationTexts[id] = formatDuration(track.durationSeconds);
+    fileSizes[id] = track.fileSize;
+    modificationTimes[id] = track.modificationTime;
+    return id;
+}
+
+TrackId TrackStore::findByPath(std::string_view path) const {
+    auto found = idsByPath.find(path);
+    return found != idsByPath.end() ? found->second : invalidId;
+}
+
+int TrackStore::size() const {
+    return (int) paths.size();
+}
+
+std::string_view TrackStore::getPath(TrackId id) const {
+    return paths[id];
+}
+
+std::string_view TrackStore::getTitle(TrackId id) const {
+    return titles[id];
+}
+
+const char *TrackStore::getDurationText(TrackId id) const {
+    return durationTexts[id].data();
+}
+
+double TrackStore::getDuration(TrackId id) const {
+    return durations[id];
+}
+
+File TrackStore::getFile(TrackId id) const {
+    return File{String::fromUTF8(paths[id].data(), (int) paths[id].size())};
+}
+
+int64 TrackStore::getModificationTime(TrackId id) const {
+    return modificationTimes[id];
+}
+
+const TrackAnalysis &TrackStore::getAnalysis(TrackId id) const {
+    return analyses[id];
+}
+
+void TrackStore::setAnalysis(TrackId id, const TrackAnalysis &analysis) {
+    analyses[id] = analysis;
+}
+
+ImportedTrack TrackStore::getRecord(TrackId id) const {
+    ImportedTrack track;
+    track.path = String::fromUTF8(paths[id].data(), (int) paths[id].size());
+    track.title = String::fromUTF8(titles[id].data(), (int) titles[id].size());
+    track.durationSeconds = durations[id];
+    track.fileSize = fileSizes[id];
+    track.modificationTime = modificationTimes[id];
+    track.analysis = analyses[id];
+    return track;
+}
+
+std::array<char, 12> TrackStore::formatDuration(double seconds) {
+    std::array<char, 12> text{};
+    const int totalSeconds = jlimit(0, 99999 * 60, roundToInt(seconds));
+    std::snprintf(text.data(), text.size(), "%d:%02d", totalSeconds / 60, totalSeconds % 60);
+    return text;
+}
@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    TrackStore.h
+    Created: 17 Oct 2026 1:15:44pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "LibraryImporter.h"
+
+using namespace juce;
+
+/** Stable identifier of a track in the TrackStore. */
+using TrackId = uint32;
+
+/**
+ * @class TrackStore
+ * @brief Column store holding every track in the library.
+ *
+ * Each property lives in its own column indexed by TrackId. Ids are handed out in insertion
+ * order and never change, so filtered and sorted views, deck queues and table rows can refer
+ * to tracks by id instead of copying their strings. Paths and titles are stored once in an
+ * append-only arena and handed out as string views; the duration text shown in the table is
+ * formatted once when a track is added.
+ */
+class TrackStore {
+public:
+    /** Id returned for tracks that are not in the store. */
+    static constexpr TrackId invalidId = 0xffffffff;
+
+    /** Constructor. */
+    TrackStore();
+
+    /** Destructor. */
+    ~TrackStore();
+
+    /**
+     * @brief Add a track, or update it if a track with the same path is already in the store.
+     * @param track The probed track.
+     * @return The id of the track.
+     */
+    TrackId addOrUpdate(const ImportedTrack &track);
+
+    /**
+     * @brief Find a track by path.
+     * @param path The full path of the audio file.
+     * @return The id of the track, or invalidId.
+     */
+    TrackId findByPath(std::string_view path) const;
+
+    /**
+     * @brief Get the number of tracks, ids run from 0 to size() - 1.
+     * @return The number of tracks.
+     */
+    int size() const;
+
+    /** @brief Get the full path of a track as UTF-8. */
+    std::string_view getPath(TrackId id) const;
+
+    /** @brief Get the title of a track as UTF-8. */
+    std::string_view getTitle(TrackId id) const;
+
+    /** @brief Get the preformatted duration text of a track, e.g. "3:07". */
+    const char *getDurationText(TrackId id) const;
+
+    /** @brief Get the duration of a track in seconds. */
+    double getDuration(TrackId id) const;
+
+    /** @brief Get the audio file of a track. */
+    File getFile(TrackId id) const;
+
+    /** @brief Get the modification time of a track's file when it was probed, in milliseconds. */
+    int64 getModificationTime(TrackId id) const;
+
+    /** @brief Get the tempo and beatgrid of a track. */
+    const TrackAnalysis &getAnalysis(TrackId id) const;
+
+    /**
+     * @brief Store the analysis of a track.
+     * @param id The id of the track.
+     * @param analysis The tempo and beatgrid found by the analyser.
+     */
+    void setAnalysis(TrackId id, const TrackAnalysis &analysis);
+
+    /**
+     * @brief Get a track in the format used by the importer and the library file.
+     * @param id The id of the track.
+     * @return The track's metadata.
+     */
+    ImportedTrack getRecord(TrackId id) const;
+
+private:
+    /**
+     * @class Arena
+     * @brief Append-only storage for strings that never moves them once added.
+     */
+    class Arena {
+    public:
+        /** Copy a string into the arena and return a view of the copy. */
+        std::string_view add(std::string_view text);
+
+    private:
+        static constexpr size_t blockSize = 1 << 20; /**< Size of each block, larger strings get their own. */
+        std::vector<std::unique_ptr<char[]>> blocks; /**< All blocks, never reallocated. */
+        size_t spaceLeft = 0; /**< Free bytes at the end of the last block. */
+        char *nextFree = nullptr; /**< Start of the free space in the last block. */
+    };
+
+    /** Format a duration for the table. */
+    static std::array<char, 12> formatDuration(double seconds);
+
+    Arena arena; /**< Storage for paths and titles. */
+
+    std::vector<std::string_view> paths; /**< Full path of each track. */
+    std::vector<std::string_view> titles; /**< Title of each track. */
+    std::vector<double> durations; /**< Duration of each track in seconds. */
+    std::vector<std::array<char, 12>> durationTexts; /**< Preformatted duration of each track. */
+    std::vector<int64> fileSizes; /**< File size when each track was probed. */
+    std::vector<int64> modificationTimes; /**< Modification time when each track was probed. */
+    std::vector<TrackAnalysis> analyses; /**< Tempo and beatgrid of each track. */
+
+    std::unordered_map<std::string_view, TrackId> idsByPath; /**< Path lookup, keys point into the arena. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackStore)
+};
@@ -1,100 +1,367 @@
-/*
-  ==============================================================================
-
-    WaveformDisplay.cpp
-    Created: 12 Jan 2024 11:18:28am
-    Author:  JAMIUL ISLAM
-
- * Tasks:
- *
- * 1. Initialize the WaveformDisplay with an AudioThumbnail - DONE
- * 2. Implement the paint method to display waveform, playhead, and track name - DONE
- * 3. Implement the resized method - DONE
- * 4. Load an audio file from the provided URL - DONE
- * 5. Handle changeListenerCallback to repaint on changes - DONE
- * 6. Set the relative position of the playhead - DONE
- *
-
-  ==============================================================================
-*/
-
-#include <JuceHeader.h>
-#include "WaveformDisplay.h"
-
-//==============================================================================
-WaveformDisplay::WaveformDisplay(AudioFormatManager &formatManagerToUse, AudioThumbnailCache &cacheToUse) :
-        audioThumb(1000, formatManagerToUse, cacheToUse), fileLoaded(false), position(0) {
-
-    // audioThumb.addChangeListener(this);
-    audioThumb.addChangeListener(reinterpret_cast<ChangeListener *>(this));
-}
-
-WaveformDisplay::~WaveformDisplay() {}
-
-// ***********************************************
-// *********** SELF WRITTEN CODE START ***********
-// ********** slight modification on UI **********
-// ***********************************************
-void WaveformDisplay::paint(Graphics &g) {
-    g.fillAll(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));   // clear the background
-
-    g.setColour(Colours::grey);
-    g.drawRect(getLocalBounds(), 1);   // draw an outline around the component
-
-    if (fileLoaded) {
-        g.setColour(Colours::orange);
-        audioThumb.drawChannel(g, getLocalBounds(), 0, audioThumb.getTotalLength(), 0, 1.0f);
-
-        //draw the playHead
-        g.setColour(juce::Colours::orangered);
-        g.fillRect(position * getWidth(), 0, 2, getHeight());
-
-        //display name of currently playing track on the waveform in white
-        g.setColour(juce::Colours::floralwhite);
-        g.setFont(16.0f);
-        g.drawText(currentlyPlaying, getLocalBounds(), juce::Justification::centred, true);
-    } else {
-        g.setColour(juce::Colours::cornflowerblue);
-        g.setFont(20.0f);
-        g.drawText("load a file", getLocalBounds(), Justification::centred, true);
-    }
-}
-// ***********************************************
-// *********** SELF WRITTEN CODE END *************
-// ***********************************************
-
-void WaveformDisplay::resized() {}
-
-// ***********************************************
-// *********** SELF WRITTEN CODE START ***********
-// ***********************************************
-void WaveformDisplay::loadURL(URL audioURL) {
-    audioThumb.clear();
-    fileLoaded = audioThumb.setSource(new URLInputSource(audioURL));
-    if (fileLoaded) {
-        std::string audioFile = audioURL.toString(false).toStdString();
-        std::size_t audioFilePosStart = audioFile.find_last_of("/");
-        std::size_t audioFilePosEnd = audioFile.find_last_of(".");
-        std::string extn = audioFile.substr(audioFilePosEnd + 1, audioFile.length() - audioFilePosEnd);
-        std::string file = audioFile.substr(audioFilePosStart + 1, audioFile.length() - audioFilePosStart - extn.size() - 2);
-
-        currentlyPlaying = file;
-        repaint();
-    } else {
-        std::cout << "file not loaded yet! " << std::endl;
-    }
-}
-// ***********************************************
-// *********** SELF WRITTEN CODE END ***********
-// ***********************************************
-
-void WaveformDisplay::changeListenerCallback(ChangeBroadcaster *source) {
-    repaint();
-}
-
-void WaveformDisplay::setPositionRelative(double pos) {
-    if (pos != position && pos > 0) {
-        position = pos; // first update the position
-        repaint(); // then perform repaint
-    }
-}
+/*
+  ==============================================================================
+
+    WaveformDisplay.cpp
+    Created: 12 Jan 2024 11:18:28am
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Initialize the WaveformDisplay with an AudioThumbnail - DONE
+ * 2. Implement the paint method to display waveform, playhead, and track name - DONE
+ * 3. Implement the resized method - DONE
+ * 4. Load an audio file from the provided URL - DONE
+ * 5. Handle changeListenerCallback to repaint on changes - DONE
+ * 6. Set the relative position of the playhead - DONE
+ * 7. Show the loading state while the deck opens a track - DONE
+ * 8. Build the thumbnail from the decoded track cache when possible - DONE
+ * 9. Load thumbnails from the disk cache and save the ones built from memory - DONE
+ * 10.Build a peak pyramid in the background and zoom around the playhead with the mouse wheel - DONE
+ * 11.Cache the rendered waveform in an image and repaint only around the playhead - DONE
+ * 12.Build and store the thumbnail of a cached track on the pyramid job, not the message thread - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "WaveformDisplay.h"
+
+/**
+ * @class WaveformDisplay::PyramidJob
+ * @brief Builds the peak pyramid of a track, from the decoded track cache when possible.
+ *
+ * For a cached track without a stored thumbnail it builds and stores the thumbnail first, from
+ * the decoded samples, and tells the display it can pick it up from the thumbnail cache.
+ */
+class WaveformDisplay::PyramidJob : public ThreadPoolJob {
+public:
+    PyramidJob(WaveformDisplay &_owner, File _file, int _generation, bool _buildThumbnail)
+            : ThreadPoolJob("Waveform pyramid"), owner(_owner), file(std::move(_file)), generation(_generation),
+              buildThumbnail(_buildThumbnail) {}
+
+    JobStatus runJob() override {
+        auto shouldAbort = [this] { return shouldExit() || owner.pyramidGeneration.load() != generation; };
+        auto newPyramid = std::make_shared<WaveformPyramid>();
+        auto cachedTrack = owner.trackCache.find(file);
+
+        if (buildThumbnail) {
+            if (cachedTrack != nullptr && !shouldAbort()) {
+                // the track is already decoded, build the thumbnail from memory instead of reading the file again
+                const AudioBuffer<float> &samples = cachedTrack->samples;
+                AudioThumbnail thumb(DiskThumbnailCache::samplesPerThumbSample, owner.formatManager, owner.thumbCache);
+                thumb.reset(samples.getNumChannels(), cachedTrack->sampleRate, samples.getNumSamples());
+                thumb.addBlock(0, samples, 0, samples.getNumSamples());
+                owner.thumbCache.storeThumb(thumb, DiskThumbnailCache::getHashFor(file));
+            }
+
+            // evicted meanwhile, the display's thumbnail decodes the file itself
+            const ScopedLock sl(owner.pendingLock);
+            owner.pendingThumbnailGeneration = generation;
+            owner.triggerAsyncUpdate();
+        }
+
+        if (cachedTrack != nullptr) {
+            newPyramid->build(cachedTrack->samples, cachedTrack->sampleRate);
+        } else {
+            std::unique_ptr<AudioFormatReader> reader(owner.formatManager.createReaderFor(file));
+            if (reader == nullptr || !newPyramid->build(*reader, shouldAbort)) {
+                return jobHasFinished;
+            }
+        }
+
+        if (!shouldAbort()) {
+            const ScopedLock sl(owner.pendingLock);
+            owner.pendingPyramid = std::move(newPyramid);
+            owner.pendingGeneration = generation;
+            owner.triggerAsyncUpdate();
+        }
+        return jobHasFinished;
+    }
+
+private:
+    WaveformDisplay &owner;
+    File file;
+    int generation;
+    bool buildThumbnail;
+};
+
+//==============================================================================
+WaveformDisplay::WaveformDisplay(AudioFormatManager &formatManagerToUse, DiskThumbnailCache &cacheToUse,
+                                 DecodedTrackCache &trackCacheToUse) :
+        formatManager(formatManagerToUse),
+        audioThumb(DiskThumbnailCache::samplesPerThumbSample, formatManagerToUse, cacheToUse), thumbCache(cacheToUse),
+        trackCache(trackCacheToUse), fileLoaded(false), loading(false), position(0) {
+
+    // the cached waveform image covers the whole component, so nothing behind it needs repainting
+    setOpaque(true);
+
+    // audioThumb.addChangeListener(this);
+    audioThumb.addChangeListener(reinterpret_cast<ChangeListener *>(this));
+}
+
+WaveformDisplay::~WaveformDisplay() {
+    ++pyramidGeneration;
+    pyramidPool.removeAllJobs(true, 2000);
+    cancelPendingUpdate();
+}
+
+// ***********************************************
+// *********** SELF WRITTEN CODE START ***********
+// ********** slight modification on UI **********
+// ***********************************************
+void WaveformDisplay::paint(Graphics &g) {
+    if (fileLoaded && zoom > 1.0) {
+        // the zoomed view scrolls with the playhead, so every frame is different anyway
+        renderWaveform(g);
+
+        //draw the playHead, which stays in the middle while the waveform scrolls
+        g.setColour(juce::Colours::orangered);
+        g.fillRect(getWidth() / 2 - 1, 0, 2, getHeight());
+        return;
+    }
+
+    if (getWidth() <= 0 || getHeight() <= 0) {
+        return;
+    }
+
+    // render at the display's pixel density, so the cached image is as sharp as drawing directly
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (waveformImage.isNull() || scale != waveformImageScale) {
+        waveformImageScale = scale;
+        waveformImage = Image(Image::RGB, jmax(1, roundToInt(getWidth() * scale)),
+                              jmax(1, roundToInt(getHeight() * scale)), false);
+
+        Graphics imageGraphics(waveformImage);
+        imageGraphics.addTransform(AffineTransform::scale(scale));
+        renderWaveform(imageGraphics);
+    }
+
+    // only the strips around the old and new playhead are repainted while playing, see setPositionRelative()
+    g.drawImage(waveformImage, getLocalBounds().toFloat());
+
+    if (fileLoaded) {
+        //draw the playHead
+        g.setColour(juce::Colours::orangered);
+        g.fillRect(getPlayheadX(), 0, 2, getHeight());
+    }
+}
+
+void WaveformDisplay::renderWaveform(Graphics &g) {
+    g.fillAll(getLookAndFeel().findColour(ResizableWindow::backgroundColourId));   // clear the background
+
+    g.setColour(Colours::grey);
+    g.drawRect(getLocalBounds(), 1);   // draw an outline around the component
+
+    if (fileLoaded) {
+        if (zoom > 1.0) {
+            drawZoomedWaveform(g);
+        } else {
+            g.setColour(Colours::orange);
+            audioThumb.drawChannel(g, getLocalBounds(), 0, audioThumb.getTotalLength(), 0, 1.0f);
+        }
+
+        //display name of currently playing track on the waveform in white
+        g.setColour(juce::Colours::floralwhite);
+        g.setFont(16.0f);
+        g.drawText(loading ? "loading..." : currentlyPlaying, getLocalBounds(), juce::Justification::centred, true);
+    } else if (loading) {
+        g.setColour(juce::Colours::cornflowerblue);
+        g.setFont(20.0f);
+        g.drawText("loading...", getLocalBounds(), Justification::centred, true);
+    } else {
+        g.setColour(juce::Colours::cornflowerblue);
+        g.setFont(20.0f);
+        g.drawText("load a file", getLocalBounds(), Justification::centred, true);
+    }
+}
+// ***********************************************
+// *********** SELF WRITTEN CODE END *************
+// ***********************************************
+
+void WaveformDisplay::resized() {
+    invalidateWaveform();
+}
+
+void WaveformDisplay::invalidateWaveform() {
+    waveformImage = {};
+    repaint();
+}
+
+int WaveformDisplay::getPlayheadX() const {
+    return roundToInt(position * getWidth());
+}
+
+void WaveformDisplay::drawZoomedWaveform(Graphics &g) {
+    const double visibleSeconds = getTrackLength() / zoom;
+    const double startSeconds = position * getTrackLength() - visibleSeconds / 2;
+
+    if (pyramid == nullptr) {
+        // still building, the overview thumbnail is coarser but shows the same part of the track
+        g.setColour(Colours::orange);
+        audioThumb.drawChannel(g, getLocalBounds(), startSeconds, startSeconds + visibleSeconds, 0, 1.0f);
+        return;
+    }
+
+    const int width = getWidth();
+    const double samplesPerPixel = visibleSeconds * pyramid->getSampleRate() / jmax(1, width);
+    const double startSample = startSeconds * pyramid->getSampleRate();
+    const int level = pyramid->chooseLevel(samplesPerPixel);
+
+    const float centre = (float) getHeight() * 0.5f;
+    const float halfHeight = centre - 1.0f;
+
+    for (int x = 0; x < width; ++x) {
+        const auto first = (int64) (startSample + x * samplesPerPixel);
+        const auto last = (int64) (startSample + (x + 1) * samplesPerPixel) + 1;
+        const WaveformPyramid::Peak peak = pyramid->getPeak(level, first, last);
+
+        if (peak.max <= peak.min && peak.rms == 0.0f) {
+            continue; // before the start or after the end of the track
+        }
+
+        // peaks first, then the RMS body on top of them
+        g.setColour(Colours::orange);
+        g.drawVerticalLine(x, centre - jlimit(-1.0f, 1.0f, peak.max) * halfHeight,
+                           centre - jlimit(-1.0f, 1.0f, peak.min) * halfHeight + 1.0f);
+        g.setColour(Colours::darkorange.darker());
+        g.drawVerticalLine(x, centre - jmin(1.0f, peak.rms) * halfHeight, centre + jmin(1.0f, peak.rms) * halfHeight + 1.0f);
+    }
+}
+
+double WaveformDisplay::getTrackLength() const {
+    if (pyramid != nullptr && pyramid->getSampleRate() > 0) {
+        return (double) pyramid->getLengthInSamples() / pyramid->getSampleRate();
+    }
+    return audioThumb.getTotalLength();
+}
+
+void WaveformDisplay::mouseWheelMove(const MouseEvent &event, const MouseWheelDetails &wheel) {
+    if (!fileLoaded || getTrackLength() <= 0.0) {
+        return;
+    }
+
+    // deepest zoom shows a few samples per pixel, below that the finest pyramid level only repeats itself
+    const double sampleRate = pyramid != nullptr ? pyramid->getSampleRate() : 44100.0;
+    const double maxZoom = jmax(1.0, getTrackLength() * sampleRate
+                                     / (jmax(1, getWidth()) * (WaveformPyramid::baseBinSize / 4.0)));
+
+    const double newZoom = jlimit(1.0, maxZoom, zoom * std::pow(2.0, (double) wheel.deltaY * 4.0));
+    if (newZoom != zoom) {
+        zoom = newZoom;
+        repaint();
+    }
+}
+
+void WaveformDisplay::mouseDoubleClick(const MouseEvent &event) {
+    if (zoom != 1.0) {
+        zoom = 1.0;
+        repaint();
+    }
+}
+
+// ***********************************************
+// *********** SELF WRITTEN CODE START ***********
+// ***********************************************
+void WaveformDisplay::loadURL(URL audioURL) {
+    audioThumb.clear();
+
+    // drop the pyramid of the previous track, the zoom level is kept for the next one
+    const int generation = ++pyramidGeneration;
+    pyramid.reset();
+    pyramidPool.removeAllJobs(true, 0);
+
+    if (audioURL.isLocalFile()) {
+        const File file = audioURL.getLocalFile();
+        const int64 hashCode = DiskThumbnailCache::getHashFor(file);
+        std::shared_ptr<const DecodedTrack> cachedTrack;
+
+        if (!thumbCache.isOnDisk(hashCode)) {
+            cachedTrack = trackCache.find(file);
+        }
+
+        currentFile = file;
+
+        if (cachedTrack != nullptr) {
+            // the pyramid job builds the thumbnail from the decoded samples, until then the overview is empty
+            const AudioBuffer<float> &samples = cachedTrack->samples;
+            audioThumb.reset(samples.getNumChannels(), cachedTrack->sampleRate, samples.getNumSamples());
+            fileLoaded = true;
+        } else {
+            // hits the cache (memory, then disk) when possible, otherwise decodes in the background and saves the result
+            fileLoaded = audioThumb.setSource(new FileInputSource(file, true));
+        }
+
+        if (fileLoaded) {
+            pyramidPool.addJob(new PyramidJob(*this, file, generation, cachedTrack != nullptr), true);
+        }
+    } else {
+        fileLoaded = audioThumb.setSource(new URLInputSource(audioURL));
+    }
+    if (fileLoaded) {
+        std::string audioFile = audioURL.toString(false).toStdString();
+        std::size_t audioFilePosStart = audioFile.find_last_of("/");
+        std::size_t audioFilePosEnd = audioFile.find_last_of(".");
+        std::string extn = audioFile.substr(audioFilePosEnd + 1, audioFile.length() - audioFilePosEnd);
+        std::string file = audioFile.substr(audioFilePosStart + 1, audioFile.length() - audioFilePosStart - extn.size() - 2);
+
+        currentlyPlaying = file;
+        invalidateWaveform();
+    } else {
+        std::cout << "file not loaded yet! " << std::endl;
+    }
+}
+// ***********************************************
+// *********** SELF WRITTEN CODE END ***********
+// ***********************************************
+
+void WaveformDisplay::changeListenerCallback(ChangeBroadcaster *source) {
+    // the thumbnail got more data, or was loaded from the cache
+    invalidateWaveform();
+}
+
+void WaveformDisplay::setPositionRelative(double pos) {
+    if (pos != position && pos > 0) {
+        const int oldX = getPlayheadX();
+        position = pos; // first update the position
+
+        if (zoom > 1.0) {
+            repaint(); // the whole view scrolls
+        } else if (getPlayheadX() != oldX) {
+            // then repaint only the strips under the old and the new playhead
+            repaint(oldX - 1, 0, 4, getHeight());
+            repaint(getPlayheadX() - 1, 0, 4, getHeight());
+        }
+    }
+}
+
+void WaveformDisplay::setLoading(bool isLoading) {
+    if (isLoading != loading) {
+        loading = isLoading;
+        invalidateWaveform();
+    }
+}
+
+void WaveformDisplay::handleAsyncUpdate() {
+    bool thumbnailStored;
+    {
+        const ScopedLock sl(pendingLock);
+        thumbnailStored = pendingThumbnailGeneration == pyramidGeneration.load();
+        pendingThumbnailGeneration = 0;
+    }
+
+    if (thumbnailStored) {
+        // stored in the thumbnail cache by the job, so this is a lookup, not a decode
+        audioThumb.setSource(new FileInputSource(currentFile, true));
+    }
+
+    const ScopedLock sl(pendingLock);
+
+    if (pendingPyramid != nullptr && pendingGeneration == pyramidGeneration.load()) {
+        pyramid = std::move(pendingPyramid);
+        if (zoom > 1.0) {
+            repaint(); // the overview image doesn't use the pyramid
+        }
+    }
+    pendingPyramid.reset();
+}
\ No newline at end of file
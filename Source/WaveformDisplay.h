@@ -1,73 +1,146 @@
-/*
-  ==============================================================================
-
-    WaveformDisplay.h
-    Created: 12 Jan 2024 11:18:28am
-    Author:  JAMIUL ISLAM
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-
-using namespace juce;
-
-/**
- * @class WaveformDisplay
- * @brief A component for displaying the waveform of an audio file and managing playhead position.
- *
- * This class provides functionality to load and display the waveform of an audio file.
- * It includes features to dynamically update the playhead position and display the name
- * of the currently playing song.
- */
-class WaveformDisplay : public juce::Component, public ChangeListener {
-public:
-    /**
-     * @brief Constructor.
-     * @param formatManagerToUse The audio format manager to use.
-     * @param cacheToUse The audio thumbnail cache to use.
-     */
-    WaveformDisplay(AudioFormatManager &formatManagerToUse, AudioThumbnailCache &cacheToUse);
-
-    /** Destructor. */
-    ~WaveformDisplay();
-
-    /**
-     * @brief Paint method for rendering the component.
-     * @param g The Graphics object used for rendering.
-     */
-    void paint(juce::Graphics &g) override;
-
-    /**
-     * @brief Resized method called when the component is resized.
-     */
-    void resized() override;
-
-    /**
-     * @brief Load an audio file from a given URL.
-     * @param audioURL The URL of the audio file to load.
-     */
-    void loadURL(URL audioURL);
-
-    /**
-     * @brief Callback method for change events.
-     * @param source The ChangeBroadcaster triggering the change.
-     */
-    void changeListenerCallback(ChangeBroadcaster *source) override;
-
-    /**
-     * @brief Set the relative position of the playhead.
-     * @param pos The relative position (0.0 to 1.0) of the playhead.
-     */
-    void setPositionRelative(double pos);
-
-private:
-    AudioThumbnail audioThumb; /**< Audio thumbnail for waveform display. */
-    bool fileLoaded; /**< Flag indicating whether an audio file is loaded. */
-    double position; /**< Relative position of the playhead. */
-    std::string currentlyPlaying; /**< Name of the currently playing song. */
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformDisplay)
-};
+/*
+  ==============================================================================
+
+    WaveformDisplay.h
+    Created: 12 Jan 2024 11:18:28am
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DecodedTrackCache.h"
+#include "DiskThumbnailCache.h"
+#include "WaveformPyramid.h"
+
+using namespace juce;
+
+/**
+ * @class WaveformDisplay
+ * @brief A component for displaying the waveform of an audio file and managing playhead position.
+ *
+ * This class provides functionality to load and display the waveform of an audio file.
+ * It includes features to dynamically update the playhead position and display the name
+ * of the currently playing song.
+ *
+ * The mouse wheel zooms into a scrolling view centred on the playhead, drawn from a peak pyramid
+ * built in the background after a track is loaded. Double-clicking goes back to the whole track.
+ *
+ * The whole-track view is rendered once into an image that is only redrawn when the component is
+ * resized or the track, its thumbnail or the loading state changes. Moving the playhead repaints
+ * the thin strips under its old and new position only.
+ */
+class WaveformDisplay : public juce::Component, public ChangeListener, private AsyncUpdater {
+public:
+    /**
+     * @brief Constructor.
+     * @param formatManagerToUse The audio format manager to use.
+     * @param cacheToUse The disk-backed thumbnail cache to use.
+     * @param trackCacheToUse The decoded track cache, used to draw cached tracks without decoding them.
+     */
+    WaveformDisplay(AudioFormatManager &formatManagerToUse, DiskThumbnailCache &cacheToUse, DecodedTrackCache &trackCacheToUse);
+
+    /** Destructor. */
+    ~WaveformDisplay();
+
+    /**
+     * @brief Paint method for rendering the component.
+     * @param g The Graphics object used for rendering.
+     */
+    void paint(juce::Graphics &g) override;
+
+    /**
+     * @brief Resized method called when the component is resized.
+     */
+    void resized() override;
+
+    /**
+     * @brief Load an audio file from a given URL.
+     *
+     * Local files are looked up in the thumbnail cache first, which also reads thumbnails saved on disk
+     * in earlier sessions or built during import. Only tracks that aren't cached are decoded again.
+     *
+     * @param audioURL The URL of the audio file to load.
+     */
+    void loadURL(URL audioURL);
+
+    /**
+     * @brief Callback method for change events.
+     * @param source The ChangeBroadcaster triggering the change.
+     */
+    void changeListenerCallback(ChangeBroadcaster *source) override;
+
+    /**
+     * @brief Set the relative position of the playhead.
+     * @param pos The relative position (0.0 to 1.0) of the playhead.
+     */
+    void setPositionRelative(double pos);
+
+    /**
+     * @brief Show or hide the loading state while the deck opens a track.
+     * @param isLoading True while the deck is loading a track.
+     */
+    void setLoading(bool isLoading);
+
+    /**
+     * @brief Zoom in or out around the playhead.
+     * @param event The mouse event.
+     * @param wheel The wheel movement, up zooms in.
+     */
+    void mouseWheelMove(const MouseEvent &event, const MouseWheelDetails &wheel) override;
+
+    /**
+     * @brief Zoom back out to the whole track.
+     * @param event The mouse event.
+     */
+    void mouseDoubleClick(const MouseEvent &event) override;
+
+private:
+    class PyramidJob;
+
+    /** Draw the visible part of the track around the playhead when zoomed in. */
+    void drawZoomedWaveform(Graphics &g);
+
+    /** Draw everything except the playhead. */
+    void renderWaveform(Graphics &g);
+
+    /** Throw away the cached waveform image and redraw it on the next paint. */
+    void invalidateWaveform();
+
+    /** Get the horizontal pixel position of the playhead. */
+    int getPlayheadX() const;
+
+    /** Get the length of the loaded track in seconds. */
+    double getTrackLength() const;
+
+    /** Take over a thumbnail or a pyramid finished by the background job. */
+    void handleAsyncUpdate() override;
+
+
+    AudioFormatManager &formatManager; /**< Format manager used to read tracks for the pyramid. */
+    AudioThumbnail audioThumb; /**< Audio thumbnail for waveform display. */
+    DiskThumbnailCache &thumbCache; /**< Thumbnails shared with the other deck and the library import. */
+    DecodedTrackCache &trackCache; /**< Decoded tracks shared with the players. */
+    bool fileLoaded; /**< Flag indicating whether an audio file is loaded. */
+    bool loading; /**< Flag indicating whether the deck is loading a track. */
+    double position; /**< Relative position of the playhead. */
+    std::string currentlyPlaying; /**< Name of the currently playing song. */
+    File currentFile; /**< The loaded local file, for the thumbnail built by the background job. */
+
+    Image waveformImage; /**< The rendered overview without the playhead, null when it needs redrawing. */
+    float waveformImageScale = 1.0f; /**< Physical pixels per logical pixel the image was rendered at. */
+
+    double zoom = 1.0; /**< How many times the track is magnified, 1 shows the whole track. */
+    std::shared_ptr<const WaveformPyramid> pyramid; /**< Peaks of the loaded track, null until built. */
+    ThreadPool pyramidPool{ 1, 0, Thread::Priority::low }; /**< Worker thread that builds the pyramid. */
+    std::atomic<int> pyramidGeneration{ 0 }; /**< Incremented on every load so stale pyramids are dropped. */
+
+    CriticalSection pendingLock; /**< Guards the finished pyramid handed over by the worker. */
+    std::shared_ptr<const WaveformPyramid> pendingPyramid; /**< Pyramid waiting for the message thread. */
+    int pendingGeneration = 0; /**< The load the pending pyramid belongs to. */
+    int pendingThumbnailGeneration = 0; /**< The load whose thumbnail the job has stored, 0 if none is waiting. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformDisplay)
+};
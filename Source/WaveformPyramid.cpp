@@ -0,0 +1,251 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.cpp
+    Created: 17 Oct 2026 3:07:12pm
+    Author:  JAMIUL ISLAM
+
+ * Tasks:
+ *
+ * 1. Reduce blocks to min/max/sum of squares in one SIMD pass - DONE
+ * 2. Build the finest level from a decoded track or a reader - DONE
+ * 3. Build the coarser levels by combining four peaks at a time - DONE
+ * 4. Pick the level for a zoom and combine peaks per pixel - DONE
+ *
+
+  ==============================================================================
+*/
+
+#include "WaveformPyramid.h"
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#elif JUCE_ARM && defined(__ARM_NEON)
+ #include <arm_neon.h>
+#endif
+
+WaveformPyramid::WaveformPyramid() {}
+
+WaveformPyramid::~WaveformPyramid() {}
+
+void WaveformPyramid::build(const AudioBuffer<float> &samples, double _sampleRate) {
+    prepare(samples.getNumSamples(), _sampleRate);
+    addBlock(samples.getArrayOfReadPointers(), samples.getNumChannels(), samples.getNumSamples());
+    buildUpperLevels();
+}
+
+bool WaveformPyramid::build(AudioFormatReader &reader, const std::function<bool()> &shouldAbort) {
+    prepare(reader.lengthInSamples, reader.sampleRate);
+
+    // whole bins per block, so no bin is split between two blocks
+    constexpr int blockSize = 1024 * baseBinSize;
+    AudioBuffer<float> block((int) reader.numChannels, blockSize);
+
+    for (int64 pos = 0; pos < lengthInSamples; pos += blockSize) {
+        if (shouldAbort != nullptr && shouldAbort()) {
+            levels.clear();
+            return false;
+        }
+
+        const int numSamples = (int) jmin((int64) blockSize, lengthInSamples - pos);
+        reader.read(&block, 0, numSamples, pos, true, true);
+        addBlock(block.getArrayOfReadPointers(), block.getNumChannels(), numSamples);
+    }
+
+    buildUpperLevels();
+    return true;
+}
+
+void WaveformPyramid::prepare(int64 _lengthInSamples, double _sampleRate) {
+    lengthInSamples = jmax((int64) 0, _lengthInSamples);
+    sampleRate = _sampleRate;
+
+    levels.assign(1, Level{});
+    Level &base = levels[0];
+    base.binSize = baseBinSize;
+
+    const auto numBins = (size_t) ((lengthInSamples + baseBinSize - 1) / baseBinSize);
+    base.mins.reserve(numBins);
+    base.maxs.reserve(numBins);
+    base.meanSquares.reserve(numBins);
+}
+
+void WaveformPyramid::addBlock(const float *const *channels, int numChannels, int numSamples) {
+    if (numChannels <= 0) {
+        return;
+    }
+
+    Level &base = levels[0];
+
+    for (int offset = 0; offset < numSamples; offset += baseBinSize) {
+        const int binSamples = jmin(baseBinSize, numSamples - offset);
+        float lowest, highest, sumSquares;
+        reduceSamples(channels[0] + offset, binSamples, lowest, highest, sumSquares);
+
+        // all channels are drawn as one waveform, like a mono sum but without cancelling out
+        for (int channel = 1; channel < numChannels; ++channel) {
+            float channelMin, channelMax, channelSum;
+            reduceSamples(channels[channel] + offset, binSamples, channelMin, channelMax, channelSum);
+            lowest = jmin(lowest, channelMin);
+            highest = jmax(highest, channelMax);
+            sumSquares += channelSum;
+        }
+
+        base.mins.push_back(lowest);
+        base.maxs.push_back(highest);
+        base.meanSquares.push_back(sumSquares / (float) (binSamples * numChannels));
+    }
+}
+
+void WaveformPyramid::buildUpperLevels() {
+    while (levels.back().mins.size() > 1) {
+        Level next;
+        {
+            const Level &below = levels.back();
+            const size_t numBelow = below.mins.size();
+            const size_t numBins = (numBelow + reductionFactor - 1) / reductionFactor;
+
+            next.binSize = below.binSize * reductionFactor;
+            next.mins.resize(numBins);
+            next.maxs.resize(numBins);
+            next.meanSquares.resize(numBins);
+
+            for (size_t i = 0; i < numBins; ++i) {
+                const size_t first = i * reductionFactor;
+                const int count = (int) jmin((size_t) reductionFactor, numBelow - first);
+
+                next.mins[i] = FloatVectorOperations::findMinimum(below.mins.data() + first, count);
+                next.maxs[i] = FloatVectorOperations::findMaximum(below.maxs.data() + first, count);
+
+                float sum = 0.0f;
+                for (int j = 0; j < count; ++j) {
+                    sum += below.meanSquares[first + (size_t) j];
+                }
+                next.meanSquares[i] = sum / (float) count;
+            }
+        }
+        levels.push_back(std::move(next));
+    }
+}
+
+double WaveformPyramid::getSampleRate() const {
+    return sampleRate;
+}
+
+int64 WaveformPyramid::getLengthInSamples() const {
+    return lengthInSamples;
+}
+
+int WaveformPyramid::getNumLevels() const {
+    return (int) levels.size();
+}
+
+const WaveformPyramid::Level &WaveformPyramid::getLevel(int level) const {
+    return levels[(size_t) level];
+}
+
+int WaveformPyramid::chooseLevel(double samplesPerPixel) const {
+    int level = 0;
+    while (level + 1 < getNumLevels() && (double) levels[(size_t) level + 1].binSize <= samplesPerPixel) {
+        ++level;
+    }
+    return level;
+}
+
+WaveformPyramid::Peak WaveformPyramid::getPeak(int level, int64 startSample, int64 endSample) const {
+    startSample = jmax((int64) 0, startSample);
+    endSample = jmin(lengthInSamples, endSample);
+
+    if (level < 0 || level >= getNumLevels() || endSample <= startSample) {
+        return {};
+    }
+
+    const Level &l = levels[(size_t) level];
+    const auto first = (size_t) (startSample / l.binSize);
+    const auto last = jmin(l.mins.size(), (size_t) ((endSample - 1) / l.binSize) + 1);
+    const int count = (int) (last - first);
+
+    if (count <= 0) {
+        return {};
+    }
+
+    float sum = 0.0f;
+    for (size_t i = first; i < last; ++i) {
+        sum += l.meanSquares[i];
+    }
+
+    Peak peak;
+    peak.min = FloatVectorOperations::findMinimum(l.mins.data() + first, count);
+    peak.max = FloatVectorOperations::findMaximum(l.maxs.data() + first, count);
+    peak.rms = std::sqrt(sum / (float) count);
+    return peak;
+}
+
+size_t WaveformPyramid::getMemorySize() const {
+    size_t bytes = 0;
+    for (const auto &level: levels) {
+        bytes += (level.mins.size() + level.maxs.size() + level.meanSquares.size()) * sizeof(float);
+    }
+    return bytes;
+}
+
+void WaveformPyramid::reduceSamples(const float *data, int numSamples, float &min, float &max, float &sumSquares) {
+    if (numSamples <= 0) {
+        min = max = sumSquares = 0.0f;
+        return;
+    }
+
+    float lowest = data[0], highest = data[0], sum = 0.0f;
+    int i = 0;
+
+#if JUCE_INTEL
+    if (numSamples >= 4) {
+        __m128 lo = _mm_set1_ps(data[0]), hi = lo, acc = _mm_setzero_ps();
+
+        for (; i + 4 <= numSamples; i += 4) {
+            const __m128 v = _mm_loadu_ps(data + i);
+            lo = _mm_min_ps(lo, v);
+            hi = _mm_max_ps(hi, v);
+            acc = _mm_add_ps(acc, _mm_mul_ps(v, v));
+        }
+
+        alignas(16) float lanes[3][4];
+        _mm_store_ps(lanes[0], lo);
+        _mm_store_ps(lanes[1], hi);
+        _mm_store_ps(lanes[2], acc);
+        lowest = jmin(lanes[0][0], lanes[0][1], lanes[0][2], lanes[0][3]);
+        highest = jmax(lanes[1][0], lanes[1][1], lanes[1][2], lanes[1][3]);
+        sum = (lanes[2][0] + lanes[2][1]) + (lanes[2][2] + lanes[2][3]);
+    }
+#elif JUCE_ARM && defined(__ARM_NEON)
+    if (numSamples >= 4) {
+        float32x4_t lo = vdupq_n_f32(data[0]), hi = lo, acc = vdupq_n_f32(0.0f);
+
+        for (; i + 4 <= numSamples; i += 4) {
+            const float32x4_t v = vld1q_f32(data + i);
+            lo = vminq_f32(lo, v);
+            hi = vmaxq_f32(hi, v);
+            acc = vmlaq_f32(acc, v, v);
+        }
+
+        float lanes[3][4];
+        vst1q_f32(lanes[0], lo);
+        vst1q_f32(lanes[1], hi);
+        vst1q_f32(lanes[2], acc);
+        lowest = jmin(lanes[0][0], lanes[0][1], lanes[0][2], lanes[0][3]);
+        highest = jmax(lanes[1][0], lanes[1][1], lanes[1][2], lanes[1][3]);
+        sum = (lanes[2][0] + lanes[2][1]) + (lanes[2][2] + lanes[2][3]);
+    }
+#endif
+
+    // the tail, or everything without SIMD
+    for (; i < numSamples; ++i) {
+        lowest = jmin(lowest, data[i]);
+        highest = jmax(highest, data[i]);
+        sum += data[i] * data[i];
+    }
+
+    min = lowest;
+    max = highest;
+    sumSquares = sum;
+}
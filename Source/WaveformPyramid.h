@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    WaveformPyramid.h
+    Created: 17 Oct 2026 3:07:12pm
+    Author:  JAMIUL ISLAM
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <vector>
+
+using namespace juce;
+
+/**
+ * @class WaveformPyramid
+ * @brief Multi-resolution min/max/RMS peaks of a track for drawing zoomed waveforms.
+ *
+ * The finest level holds one peak per 64 samples, all channels combined. Every following level
+ * combines four peaks of the level below, so the whole pyramid only takes a third more memory
+ * than its finest level. A view asks for the level matching its number of samples per pixel and
+ * only ever reduces a handful of peaks per pixel, however far it is zoomed in or out.
+ */
+class WaveformPyramid {
+public:
+    static constexpr int baseBinSize = 64; /**< Samples per peak in the finest level. */
+    static constexpr int reductionFactor = 4; /**< Peaks of a level combined into one peak of the next level. */
+
+    /**
+     * @struct Level
+     * @brief The peaks of one resolution, stored column by column.
+     */
+    struct Level {
+        int64 binSize = 0; /**< Samples covered by each peak. */
+        std::vector<float> mins; /**< Lowest sample of each peak. */
+        std::vector<float> maxs; /**< Highest sample of each peak. */
+        std::vector<float> meanSquares; /**< Mean square of each peak, kept squared so levels average correctly. */
+    };
+
+    /**
+     * @struct Peak
+     * @brief The combined peak of a range of samples.
+     */
+    struct Peak {
+        float min = 0.0f; /**< Lowest sample in the range. */
+        float max = 0.0f; /**< Highest sample in the range. */
+        float rms = 0.0f; /**< RMS level of the range. */
+    };
+
+    /** Constructor. */
+    WaveformPyramid();
+
+    /** Destructor. */
+    ~WaveformPyramid();
+
+    /**
+     * @brief Build the pyramid from a decoded track.
+     * @param samples The decoded samples.
+     * @param sampleRate The sample rate of the samples.
+     */
+    void build(const AudioBuffer<float> &samples, double sampleRate);
+
+    /**
+     * @brief Build the pyramid by reading a file block by block.
+     * @param reader The reader of the audio file.
+     * @param shouldAbort Checked between blocks, returning true stops the build.
+     * @return True if the whole file was read.
+     */
+    bool build(AudioFormatReader &reader, const std::function<bool()> &shouldAbort);
+
+    /** @brief Get the sample rate of the track. */
+    double getSampleRate() const;
+
+    /** @brief Get the length of the track in samples. */
+    int64 getLengthInSamples() const;
+
+    /** @brief Get the number of levels, 0 when nothing was built. */
+    int getNumLevels() const;
+
+    /** @brief Get a level, level 0 is the finest. */
+    const Level &getLevel(int level) const;
+
+    /**
+     * @brief Choose the coarsest level that still has at least one peak per pixel.
+     * @param samplesPerPixel The number of samples drawn in each pixel column.
+     * @return The index of the level.
+     */
+    int chooseLevel(double samplesPerPixel) const;
+
+    /**
+     * @brief Combine the peaks of a level covering a range of samples.
+     * @param level The level to read, usually from chooseLevel().
+     * @param startSample The first sample of the range.
+     * @param endSample The sample after the range.
+     * @return The combined peak, silent outside of the track.
+     */
+    Peak getPeak(int level, int64 startSample, int64 endSample) const;
+
+    /**
+     * @brief Get the size of all levels in bytes.
+     * @return The memory used by the peaks.
+     */
+    size_t getMemorySize() const;
+
+private:
+    /** Clear the pyramid and get ready for a track of the given length. */
+    void prepare(int64 lengthInSamples, double sampleRate);
+
+    /** Add finest-level peaks for a block of samples, a multiple of baseBinSize long except at the end. */
+    void addBlock(const float *const *channels, int numChannels, int numSamples);
+
+    /** Build the coarser levels from the finest one. */
+    void buildUpperLevels();
+
+    /**
+     * Find the lowest and highest sample and the sum of squares of a block in a single pass,
+     * four samples at a time with SSE or NEON where available.
+     */
+    static void reduceSamples(const float *data, int numSamples, float &min, float &max, float &sumSquares);
+
+    std::vector<Level> levels; /**< All levels, finest first. */
+    double sampleRate = 0.0; /**< Sample rate of the track. */
+    int64 lengthInSamples = 0; /**< Length of the track in samples. */
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformPyramid)
+};